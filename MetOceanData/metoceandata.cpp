@@ -21,6 +21,7 @@
 #include <QHash>
 #include <algorithm>
 #include <iostream>
+#include <limits>
 #include "constants.h"
 #include "generic.h"
 #include "hmdf.h"
@@ -167,12 +168,10 @@ QStringList MetOceanData::selectStations(serviceTypes service, double x1,
   double xmax = std::max(x1, x2);
   double ymin = std::min(y1, y2);
   double ymax = std::max(y1, y2);
-  for (size_t i = 0; i < markerLocations.size(); ++i) {
-    double x = markerLocations[i].coordinate().longitude();
-    double y = markerLocations[i].coordinate().latitude();
-    if (x >= xmin && x <= xmax && y >= ymin && y <= ymax) {
-      stationList.push_back(markerLocations[i].id());
-    }
+  QVector<int> inside =
+      StationLocations::markerIndex(m).box(xmin, ymin, xmax, ymax);
+  for (int i : inside) {
+    stationList.push_back(markerLocations[i].id());
   }
   return stationList;
 }
@@ -182,10 +181,16 @@ QString MetOceanData::selectNearestStation(serviceTypes service, double x,
   StationLocations::MarkerType m = MetOceanData::serviceToMarkerType(service);
   QVector<Station> markerLocations = StationLocations::readMarkers(m);
 
-  double d = std::numeric_limits<double>::max();
-  size_t j = std::numeric_limits<size_t>::max();
+  //...The index ranks by great circle distance on a sphere. Take a few
+  //   candidates from it and pick the closest using the same geodesic
+  //   distance used everywhere else so near ties resolve the same way
+  static const int c_nearestCandidates = 8;
+  QVector<int> candidates = StationLocations::markerIndex(m).nearest(
+      x, y, c_nearestCandidates);
 
-  for (size_t i = 0; i < markerLocations.size(); i++) {
+  double d = std::numeric_limits<double>::max();
+  int j = -1;
+  for (int i : candidates) {
     double xs = markerLocations[i].coordinate().longitude();
     double ys = markerLocations[i].coordinate().latitude();
     double d1 = Constants::distance(x, y, xs, ys, true);
@@ -195,7 +200,7 @@ QString MetOceanData::selectNearestStation(serviceTypes service, double x,
     }
   }
 
-  if (j != std::numeric_limits<size_t>::max()) {
+  if (j != -1) {
     return markerLocations[j].id();
   } else {
     return QString();
@@ -226,21 +231,9 @@ StationLocations::MarkerType MetOceanData::serviceToMarkerType(
 bool MetOceanData::findStation(QStringList name,
                                StationLocations::MarkerType type,
                                QVector<Station> &s) {
-  QVector<bool> found;
-  found.resize(name.size());
-  std::fill(found.begin(), found.end(), false);
-  QVector<Station> markerLocations = StationLocations::readMarkers(type);
   s.resize(name.length());
-
-  for (size_t j = 0; j < name.length(); j++) {
-    for (size_t i = 0; i < markerLocations.length(); ++i) {
-      if (name.at(j).simplified() == markerLocations[i].id().simplified()) {
-        found[j] = true;
-        s[j] = markerLocations[i];
-        break;
-      }
-    }
-    if (!found[j]) return false;
+  for (int j = 0; j < name.length(); j++) {
+    if (!StationLocations::findStation(type, name.at(j), s[j])) return false;
   }
   return true;
 }
@@ -274,7 +267,6 @@ void MetOceanData::getNdbcData() {
     data->station(this->m_product - 1)->setName(s[i].name());
     data->station(this->m_product - 1)->setId(s[i].id());
     dataOut->addStation(data->station(this->m_product - 1));
-    data->station(this->m_product - 1)->setParent(dataOut);
 
     delete ndbc;
     delete data;
@@ -319,7 +311,6 @@ void MetOceanData::getXtideData() {
     data->setUnits("m");
 
     dataOut->addStation(data->station(0));
-    data->station(0)->setParent(dataOut);
 
     delete data;
     delete x;
@@ -436,7 +427,6 @@ void MetOceanData::getNoaaData() {
     data->setDatum(d);
 
     dataOut->addStation(data->station(0));
-    data->station(0)->setParent(dataOut);
 
     delete data;
     delete coops;
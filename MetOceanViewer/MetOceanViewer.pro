@@ -55,7 +55,8 @@ SOURCES +=\
     src/uixtidetab.cpp \
     src/mapfunctions.cpp \
     src/uindbctab.cpp \
-    src/ndbc.cpp
+    src/ndbc.cpp \
+    src/stationclusters.cpp
 
 HEADERS  += \
     src/metoceanviewer.h \
@@ -78,7 +79,8 @@ HEADERS  += \
     src/updatedialog.h \
     src/usertimeseries.h \
     src/mapfunctions.h \
-    src/ndbc.h
+    src/ndbc.h \
+    src/stationclusters.h
 
 FORMS    += \
     ui/aboutdialog.ui \
@@ -30,6 +30,7 @@ Rectangle {
     objectName: "mapWindow"
 
     signal markerChanged(string msg)
+    signal viewChanged()
 
     property string stationText;
 
@@ -42,6 +43,10 @@ Rectangle {
         return map.visibleRegion;
     }
 
+    function getZoomLevel() {
+        return map.zoomLevel;
+    }
+
     function setVisibleRegion(x1,y1,x2,y2) {
         var xmin = Math.min(x1,x2);
         var xmax = Math.max(x1,x2);
@@ -117,6 +122,9 @@ Rectangle {
 
         property MovMapItem previousMarker
 
+        onCenterChanged: viewTimer.restart()
+        onZoomLevelChanged: viewTimer.restart()
+
         MapItemView{
             model: stationModel
             delegate: mapcomponent
@@ -135,12 +143,14 @@ Rectangle {
                         window.markerChanged(-1)
                         infoWindow.state = "hidden"
                     }
+                    stationModel.deselectAllStations();
                 } else if (markerMode===1) {
                     for(var i=0;i<map.children.length;i++){
                         if(map.children[i].selected===true){
                             map.children[i].deselect();
                         }
                     }
+                    stationModel.deselectAllStations();
                     selectedMarkers();
                     infoWindow.state = "hidden"
                 } else if (markerMode===2) {
@@ -148,6 +158,7 @@ Rectangle {
                         map.previousMarker.deselect()
                         map.previousMarker = null
                     }
+                    stationModel.deselectAllStations();
                     infoWindow.state = "hidden"
                 }
             }
@@ -172,6 +183,28 @@ Rectangle {
                 stationId: id
                 coordinate: position
                 markerCategory: category
+                clusterSize: model.clusterSize
+
+                //...Selection lives in the model so it outlives the
+                //   delegate when the station scrolls out of view
+                property bool modelSelected: model.selected
+
+                onModelSelectedChanged: {
+                    if(modelSelected && !selected) select();
+                    else if(!modelSelected && selected) deselect();
+                }
+
+                onSelectedChanged: {
+                    if(selected) stationModel.selectStation(stationId);
+                    else stationModel.deselectStation(stationId);
+                }
+
+                Component.onCompleted: {
+                    if(modelSelected) {
+                        select();
+                        if(markerMode!==1) map.previousMarker = markerid;
+                    }
+                }
 
                 function generateInfoWindowText(){
                     var text;
@@ -229,6 +262,7 @@ Rectangle {
                                 map.previousMarker.deselect()
                                 infoWindow.state = "hidden"
                             }
+                            stationModel.deselectAllStations();
 
                             markerid.select()
                             selectedMarkers();
@@ -254,6 +288,11 @@ Rectangle {
                     anchors.fill: parent
                     hoverEnabled: true
                     onClicked: {
+                        if(markerid.clusterSize>1) {
+                            map.center = markerid.coordinate;
+                            map.zoomLevel = Math.min(map.zoomLevel+2,map.maximumZoomLevel);
+                            return;
+                        }
                         if(markerMode===0 || markerMode===2 || markerMode===3) {
                             singleMarkerSelection();
                         } else if(markerMode===1) {
@@ -274,6 +313,14 @@ Rectangle {
 
     }
 
+    //...Let the application refresh the markers once the map settles
+    Timer {
+        id: viewTimer
+        interval: 250
+        repeat: false
+        onTriggered: window.viewChanged()
+    }
+
     InfoWindow {
         id: infoWindow
         mode: markerMode
@@ -40,6 +40,7 @@ MapQuickItem {
                                  "qrc:/rsc/img/mm_20_darkorange.png",
                                  "qrc:/rsc/img/mm_20_red.png" ]
     property int markerCategory: 0;
+    property int clusterSize: 1
 
     function selectMarkerImage(){
         if(modeled<-900){
@@ -69,10 +70,28 @@ MapQuickItem {
             id: image
             source: defaultImage
             smooth: false
-            visible: true
+            visible: clusterSize<=1
         }
-        width: image.width
-        height: image.height
+        Rectangle {
+            id: cluster
+            visible: clusterSize>1
+            width: Math.max(24,clusterText.implicitWidth+12)
+            height: width
+            radius: width/2
+            color: "#cc1e5aa0"
+            border.color: "white"
+            border.width: 2
+            Text {
+                id: clusterText
+                anchors.centerIn: parent
+                text: clusterSize
+                color: "white"
+                font.bold: true
+                font.pixelSize: 11
+            }
+        }
+        width: clusterSize>1 ? cluster.width : image.width
+        height: clusterSize>1 ? cluster.height : image.height
         border.width: 0
         color: "transparent"
 
@@ -87,8 +106,8 @@ MapQuickItem {
         }
     }
 
-    anchorPoint.x: imageRectangle.width/4
-    anchorPoint.y: imageRectangle.height
+    anchorPoint.x: clusterSize>1 ? imageRectangle.width/2 : imageRectangle.width/4
+    anchorPoint.y: clusterSize>1 ? imageRectangle.height/2 : imageRectangle.height
 
     Component.onCompleted: {
         if(mode===2) {
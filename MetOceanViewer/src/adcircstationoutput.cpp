@@ -20,43 +20,120 @@
 #include "adcircstationoutput.h"
 #include <netcdf.h>
 #include <QFile>
+#include <QThread>
 #include <QtMath>
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <thread>
+#include <vector>
 #include "errors.h"
 #include "hmdf.h"
+#include "hmdfasciiparser.h"
+
+//...Memory used for each block of time snaps read from a netCDF file
+static const size_t c_readBlockBytes = 64 * 1024 * 1024;
+
+//...Number of time snaps handed to a thread at a time when parsing ASCII
+//   output, and the file size (in values) below which it is parsed serially
+static const int c_snapsPerBlock = 16;
+static const size_t c_parallelValues = 1024 * 1024;
 
 AdcircStationOutput::AdcircStationOutput(QObject *parent) : QObject(parent) {
   this->_error = MetOceanViewer::Error::NOERR;
   this->_ncerr = NC_NOERR;
   this->nStations = 0;
   this->nSnaps = 0;
+  this->_ncid = -1;
+  this->_varid = -1;
+  this->_varid2 = -1;
+  this->_isVector = false;
+  this->_lazy = false;
+  this->_cache.setMaxCost(MetOceanViewer::STATION_CACHE_SAMPLES);
 }
 
+AdcircStationOutput::~AdcircStationOutput() { this->close(); }
+
 int AdcircStationOutput::error() { return this->_error; }
 
 QString AdcircStationOutput::errorString() { return "errorString"; }
 
 int AdcircStationOutput::read(QString AdcircFile, QString AdcircStationFile,
                               QDateTime coldStart) {
+  this->close();
   this->coldStartTime = coldStart;
   this->_error = this->readAscii(AdcircFile, AdcircStationFile);
   return this->_error;
 }
 
-int AdcircStationOutput::read(QString AdcircFile, QDateTime coldStart) {
+int AdcircStationOutput::read(const FiletypeInfo &info, QDateTime coldStart) {
   this->coldStartTime = coldStart;
-  this->_error = this->readNetCDF(AdcircFile);
+  this->_error = this->readNetCDF(info);
   return this->_error;
 }
 
+//...Opens a netCDF file for lazy reading. Only the station locations, names
+//   and times are read here
+int AdcircStationOutput::open(const FiletypeInfo &info, QDateTime coldStart) {
+  this->coldStartTime = coldStart;
+  this->_error = this->openNetCDF(info);
+  this->_lazy = this->_error == MetOceanViewer::Error::NOERR;
+  return this->_error;
+}
+
+void AdcircStationOutput::close() {
+  if (this->_ncid >= 0) nc_close(this->_ncid);
+  this->_ncid = -1;
+  this->_lazy = false;
+  this->_cache.clear();
+}
+
+//...Skips the blanks between the columns of a record
+static inline void skipBlanks(const char *&pos, const char *end) {
+  while (pos != end && (*pos == ' ' || *pos == '\t' || *pos == '\r')) ++pos;
+}
+
+//...Start of the line following the one that contains pos
+static inline const char *nextLine(const char *pos, const char *end) {
+  const char *p = static_cast<const char *>(memchr(pos, '\n', end - pos));
+  return p ? p + 1 : end;
+}
+
+//...Parses the second column of the line at pos, or the magnitude of the
+//   second and third columns for vector output, and moves pos to the next
+//   line
+static bool parseRecord(const char *&pos, const char *end, bool isVector,
+                        double &value) {
+  const char *eol = static_cast<const char *>(memchr(pos, '\n', end - pos));
+  if (!eol) eol = end;
+
+  const char *p = pos;
+  double column1, u, v;
+  skipBlanks(p, eol);
+  if (!HmdfAsciiParser::parseDouble(p, eol, column1)) return false;
+  skipBlanks(p, eol);
+  if (!HmdfAsciiParser::parseDouble(p, eol, u)) return false;
+  if (isVector) {
+    skipBlanks(p, eol);
+    if (!HmdfAsciiParser::parseDouble(p, eol, v)) return false;
+    value = qSqrt(u * u + v * v);
+  } else {
+    value = u;
+  }
+
+  pos = eol == end ? end : eol + 1;
+  return true;
+}
+
 int AdcircStationOutput::readAscii(QString AdcircOutputFile,
                                    QString AdcircStationFile) {
   QFile MyFile(AdcircOutputFile), StationFile(AdcircStationFile);
-  QString header1, header2, TempLine;
+  QString header2, TempLine;
   QStringList headerData, TempList;
   int nColumns;
 
   // Check if we can open the file
-  if (!MyFile.open(QIODevice::ReadOnly | QIODevice::Text)) {
+  if (!MyFile.open(QIODevice::ReadOnly)) {
     this->_error = MetOceanViewer::Error::CANNOT_OPEN_FILE;
     return this->_error;
   }
@@ -66,36 +143,108 @@ int AdcircStationOutput::readAscii(QString AdcircOutputFile,
     return this->_error;
   }
 
-  // Read the 61/62 style file
-  header1 = MyFile.readLine();
-  header2 = MyFile.readLine().simplified();
+  // Map the 61/62 style file. If the file cannot be mapped, fall back to
+  // reading it into memory
+  QByteArray contents;
+  qint64 size = MyFile.size();
+  const char *begin = reinterpret_cast<const char *>(MyFile.map(0, size));
+  if (!begin) {
+    contents = MyFile.readAll();
+    begin = contents.constData();
+    size = contents.size();
+  }
+  const char *end = begin + size;
+
+  // The header is two lines, with the counts on the second
+  const char *pos = nextLine(begin, end);
+  const char *header2End = nextLine(pos, end);
+  header2 = QString::fromLatin1(pos, static_cast<int>(header2End - pos))
+                .simplified();
   headerData = header2.split(" ");
+  pos = header2End;
 
   this->nSnaps = headerData.value(0).toInt();
   this->nStations = headerData.value(1).toInt();
   nColumns = headerData.value(4).toInt();
+  bool isVector = nColumns == 2;
+  if (this->nSnaps < 0 || this->nStations <= 0) {
+    this->_error = MetOceanViewer::Error::ADCIRC_ASCIIREADERROR;
+    return this->_error;
+  }
+
+  // Each snap is one time line followed by one line per station. Locate the
+  // start of every snap up front so that the snaps can be parsed
+  // independently. A file that is still being written ends in an
+  // incomplete snap, which is dropped
+  std::vector<const char *> snapStart;
+  snapStart.reserve(this->nSnaps > 0 ? this->nSnaps : 0);
+  for (int i = 0; i < this->nSnaps; ++i) {
+    const char *snap = pos;
+    int nLines = 0;
+    while (nLines <= this->nStations && pos != end) {
+      pos = nextLine(pos, end);
+      nLines++;
+    }
+    if (nLines <= this->nStations) break;
+    snapStart.push_back(snap);
+  }
+  this->nSnaps = static_cast<int>(snapStart.size());
 
   this->time.resize(this->nSnaps);
   this->data.resize(this->nStations);
-
   for (int i = 0; i < this->nStations; ++i) this->data[i].resize(this->nSnaps);
 
-  for (int i = 0; i < this->nSnaps; ++i) {
-    TempLine = MyFile.readLine().simplified();
-    TempList = TempLine.split(" ");
-    this->time[i] = TempList.value(1).toDouble();
-    for (int j = 0; j < this->nStations; ++j) {
-      TempLine = MyFile.readLine().simplified();
-      TempList = TempLine.split(" ");
-      this->data[j][i] = TempList.value(1).toDouble();
-      if (nColumns == 2)
-        this->data[j][i] = qPow(
-            qPow(this->data[j][i], 2) + qPow(TempList.value(2).toDouble(), 2),
-            2);
+  std::vector<double *> series(static_cast<size_t>(this->nStations));
+  for (int i = 0; i < this->nStations; ++i) series[i] = this->data[i].data();
+  double *times = this->time.data();
+
+  // Parse blocks of snaps on several threads. Small files are not worth
+  // starting threads for
+  std::atomic<int> nextBlock(0);
+  std::atomic<bool> failed(false);
+  int nBlocks = (this->nSnaps + c_snapsPerBlock - 1) / c_snapsPerBlock;
+  auto worker = [&]() {
+    for (int b = nextBlock++; b < nBlocks && !failed; b = nextBlock++) {
+      int last = std::min((b + 1) * c_snapsPerBlock, this->nSnaps);
+      for (int i = b * c_snapsPerBlock; i < last; ++i) {
+        const char *p = snapStart[i];
+        double column1;
+        skipBlanks(p, end);
+        if (!HmdfAsciiParser::parseDouble(p, end, column1)) {
+          failed = true;
+          return;
+        }
+        skipBlanks(p, end);
+        if (!HmdfAsciiParser::parseDouble(p, end, times[i])) {
+          failed = true;
+          return;
+        }
+        p = nextLine(p, end);
+        for (int j = 0; j < this->nStations; ++j) {
+          if (!parseRecord(p, end, isVector, series[j][i])) {
+            failed = true;
+            return;
+          }
+        }
+      }
     }
-  }
+  };
+
+  size_t nValues = static_cast<size_t>(this->nSnaps) * this->nStations;
+  int nThreads = nValues < c_parallelValues ? 1 : QThread::idealThreadCount();
+  nThreads = std::max(std::min(nThreads, nBlocks), 1);
+  std::vector<std::thread> threads;
+  for (int i = 1; i < nThreads; ++i) threads.push_back(std::thread(worker));
+  worker();
+  for (size_t i = 0; i < threads.size(); ++i) threads[i].join();
+
   MyFile.close();
 
+  if (failed) {
+    this->_error = MetOceanViewer::Error::ADCIRC_ASCIIREADERROR;
+    return this->_error;
+  }
+
   // Now read the station location file
   TempLine = StationFile.readLine().simplified();
   TempList = TempLine.split(" ");
@@ -125,17 +274,15 @@ int AdcircStationOutput::readAscii(QString AdcircOutputFile,
   return MetOceanViewer::Error::NOERR;
 }
 
-int AdcircStationOutput::readNetCDF(QString AdcircOutputFile) {
-  size_t station_size, time_size, startIndex;
+//...Opens the file and reads everything except the station series. The
+//   file is left open so that the series can be read afterwards, either
+//   all at once or one station at a time
+//...Dimension sizes and variable ids come from the schema read when the
+//   file type was detected, so the file is only opened to read data
+int AdcircStationOutput::openNetCDF(const FiletypeInfo &info) {
+  size_t station_size, time_size;
   int time_size_int, station_size_int;
-  int ncid, varid_zeta, varid_zeta2, varid_lat, varid_lon, varid_time;
-  int dimid_time, dimid_station;
-  bool isVector;
-  double Temp;
-
-  // Size the location array
-  size_t start[2];
-  size_t count[2];
+  int ncid, varid_lat, varid_lon, varid_time;
 
   QVector<QString> netcdf_types;
   netcdf_types.resize(6);
@@ -146,71 +293,57 @@ int AdcircStationOutput::readNetCDF(QString AdcircOutputFile) {
   netcdf_types[4] = "windx";
   netcdf_types[5] = "windy";
 
-  // Open the file
-  this->_error = nc_open(AdcircOutputFile.toUtf8(), NC_NOWRITE, &ncid);
-  if (this->_error != NC_NOERR) {
-    this->_ncerr = this->_error;
-    this->_error = MetOceanViewer::Error::NETCDF;
-    return this->_error;
-  }
+  this->close();
 
-  // Get the dimension ids
-  this->_error = nc_inq_dimid(ncid, "time", &dimid_time);
-  if (this->_error != NC_NOERR) {
-    this->_ncerr = this->_error;
-    this->_error = MetOceanViewer::Error::NETCDF;
-    return this->_error;
-  }
-
-  this->_error = nc_inq_dimid(ncid, "station", &dimid_station);
+  // Open the file
+  this->_error = nc_open(info.filename.toUtf8(), NC_NOWRITE, &ncid);
   if (this->_error != NC_NOERR) {
     this->_ncerr = this->_error;
     this->_error = MetOceanViewer::Error::NETCDF;
     return this->_error;
   }
+  this->_ncid = ncid;
 
   // Find out the dimension size
-  this->_error = nc_inq_dimlen(ncid, dimid_time, &time_size);
-  if (this->_error != NC_NOERR) {
-    this->_ncerr = this->_error;
-    this->_error = MetOceanViewer::Error::NETCDF;
-    return this->_error;
-  }
-
-  this->_error = nc_inq_dimlen(ncid, dimid_station, &station_size);
-  if (this->_error != NC_NOERR) {
-    this->_ncerr = this->_error;
+  if (!info.dimensions.contains("time") ||
+      !info.dimensions.contains("station")) {
+    this->close();
+    this->_ncerr = NC_EBADDIM;
     this->_error = MetOceanViewer::Error::NETCDF;
     return this->_error;
   }
+  time_size = info.dimensionLengths.value(info.dimensions["time"]);
+  station_size = info.dimensionLengths.value(info.dimensions["station"]);
 
   station_size_int = static_cast<unsigned int>(station_size);
   time_size_int = static_cast<unsigned int>(time_size);
 
   // Find the variable in the NetCDF file
   for (int i = 0; i < 6; i++) {
-    int ierr = nc_inq_varid(ncid, netcdf_types[i].toUtf8(), &varid_zeta);
-
     // If we found the variable, we're done
-    if (ierr == NC_NOERR) {
+    if (info.variables.contains(netcdf_types[i])) {
+      this->_varid = info.variables[netcdf_types[i]];
       if (i == 1 || i == 4) {
-        isVector = true;
-        this->_error =
-            nc_inq_varid(ncid, netcdf_types[i + 1].toUtf8(), &varid_zeta2);
-        if (this->_error != NC_NOERR) {
-          this->_ncerr = this->_error;
+        this->_isVector = true;
+        if (!info.variables.contains(netcdf_types[i + 1])) {
+          this->close();
+          this->_ncerr = NC_ENOTVAR;
           this->_error = MetOceanViewer::Error::NETCDF;
           return this->_error;
         }
+        this->_varid2 = info.variables[netcdf_types[i + 1]];
       } else
-        isVector = false;
+        this->_isVector = false;
 
       break;
     }
 
     // If we're at the end of the array
     // and haven't quit yet, that's a problem
-    if (i == 5) return MetOceanViewer::Error::NO_VARIABLE_FOUND;
+    if (i == 5) {
+      this->close();
+      return MetOceanViewer::Error::NO_VARIABLE_FOUND;
+    }
   }
 
   // Size the output variables
@@ -219,136 +352,214 @@ int AdcircStationOutput::readNetCDF(QString AdcircOutputFile) {
   this->nStations = station_size_int;
   this->nSnaps = time_size_int;
   this->time.resize(time_size_int);
-  this->data.resize(station_size_int);
-  for (int i = 0; i < station_size_int; ++i)
-    this->data[i].resize(time_size_int);
 
   // Read the station locations and times
-  this->_error = nc_inq_varid(ncid, "time", &varid_time);
-  if (this->_error != NC_NOERR) {
-    this->_ncerr = this->_error;
+  if (!info.variables.contains("time") || !info.variables.contains("x") ||
+      !info.variables.contains("y")) {
+    this->close();
+    this->_ncerr = NC_ENOTVAR;
     this->_error = MetOceanViewer::Error::NETCDF;
     return this->_error;
   }
-
-  this->_error = nc_inq_varid(ncid, "x", &varid_lon);
+  varid_time = info.variables["time"];
+  varid_lon = info.variables["x"];
+  varid_lat = info.variables["y"];
+
+  // Read the times and station locations in one call each
+  this->_error = nc_get_var_double(ncid, varid_time, this->time.data());
+  if (this->_error == NC_NOERR)
+    this->_error = nc_get_var_double(ncid, varid_lon, this->longitude.data());
+  if (this->_error == NC_NOERR)
+    this->_error = nc_get_var_double(ncid, varid_lat, this->latitude.data());
   if (this->_error != NC_NOERR) {
+    this->close();
     this->_ncerr = this->_error;
     this->_error = MetOceanViewer::Error::NETCDF;
     return this->_error;
   }
 
-  this->_error = nc_inq_varid(ncid, "y", &varid_lat);
-  if (this->_error != NC_NOERR) {
-    this->_ncerr = this->_error;
-    this->_error = MetOceanViewer::Error::NETCDF;
-    return this->_error;
-  }
+  // Finally, name the stations the default names for now. Later
+  // we can get fancy and try to get the ADCIRC written names in
+  // the NetCDF file
+  this->station_name.resize(station_size_int);
+  for (int i = 0; i < station_size_int; ++i)
+    this->station_name[i] = tr("Station ") + QString::number(i);
 
-  for (int j = 0; j < time_size_int; j++) {
-    startIndex = static_cast<size_t>(j);
-    this->_error = nc_get_var1(ncid, varid_time, &startIndex, &Temp);
-    if (this->_error != NC_NOERR) {
-      this->_ncerr = this->_error;
-      this->_error = MetOceanViewer::Error::NETCDF;
-      return this->_error;
-    }
+  this->buildDates();
 
-    this->time[j] = Temp;
-  }
+  this->_error = MetOceanViewer::Error::NOERR;
+  return this->_error;
+}
 
-  for (int j = 0; j < station_size_int; j++) {
-    startIndex = static_cast<size_t>(j);
-    this->_error = nc_get_var1(ncid, varid_lon, &startIndex, &Temp);
-    if (this->_error != NC_NOERR) {
-      this->_ncerr = this->_error;
-      this->_error = MetOceanViewer::Error::NETCDF;
-      return this->_error;
-    }
+int AdcircStationOutput::readNetCDF(const FiletypeInfo &info) {
+  size_t start[2];
+  size_t count[2];
 
-    this->longitude[j] = Temp;
+  int ierr = this->openNetCDF(info);
+  if (ierr != MetOceanViewer::Error::NOERR) return ierr;
 
-    this->_error = nc_get_var1(ncid, varid_lat, &startIndex, &Temp);
-    if (this->_error != NC_NOERR) {
-      this->_ncerr = this->_error;
-      this->_error = MetOceanViewer::Error::NETCDF;
-      return this->_error;
-    }
+  size_t station_size = static_cast<size_t>(this->nStations);
+  size_t time_size = static_cast<size_t>(this->nSnaps);
 
-    this->latitude[j] = Temp;
-  }
+  this->data.resize(this->nStations);
+  for (int i = 0; i < this->nStations; ++i) this->data[i].resize(this->nSnaps);
 
-  double *tempVar1 = (double *)malloc(sizeof(double) * time_size_int);
-  double *tempVar2 = (double *)malloc(sizeof(double) * time_size_int);
-
-  // Loop over the stations, reading the data into memory
-  for (int i = 0; i < station_size_int; ++i) {
-    // Read from netCDF
-    start[0] = static_cast<size_t>(0);
-    start[1] = static_cast<size_t>(i);
-    count[0] = static_cast<size_t>(time_size_int);
-    count[1] = static_cast<size_t>(1);
-    this->_error = nc_get_vara(ncid, varid_zeta, start, count, tempVar1);
+  // The data is stored [time, station], so reading one station at a time
+  // decompresses every chunk once per station. Instead read blocks of
+  // whole time snaps, sized to stay within the memory budget, and
+  // transpose them into the station series
+  size_t nVariables = this->_isVector ? 2 : 1;
+  size_t rowBytes = station_size * sizeof(double) * nVariables;
+  size_t blockSnaps = rowBytes > 0 ? c_readBlockBytes / rowBytes : time_size;
+  blockSnaps = std::max(std::min(blockSnaps, time_size), size_t(1));
+
+  std::vector<double> block1(blockSnaps * station_size);
+  std::vector<double> block2(this->_isVector ? blockSnaps * station_size : 0);
+
+  for (size_t t0 = 0; t0 < time_size; t0 += blockSnaps) {
+    size_t nt = std::min(blockSnaps, time_size - t0);
+    start[0] = t0;
+    start[1] = 0;
+    count[0] = nt;
+    count[1] = station_size;
+
+    this->_error = nc_get_vara_double(this->_ncid, this->_varid, start, count,
+                                      block1.data());
+    if (this->_error == NC_NOERR && this->_isVector)
+      this->_error = nc_get_vara_double(this->_ncid, this->_varid2, start,
+                                        count, block2.data());
     if (this->_error != NC_NOERR) {
-      free(tempVar1);
-      free(tempVar2);
+      this->close();
       this->_ncerr = this->_error;
       this->_error = MetOceanViewer::Error::NETCDF;
       return this->_error;
     }
 
-    if (isVector) {
-      this->_error = nc_get_vara(ncid, varid_zeta2, start, count, tempVar2);
-      if (this->_error != NC_NOERR) {
-        free(tempVar1);
-        free(tempVar2);
-        this->_ncerr = this->_error;
-        this->_error = MetOceanViewer::Error::NETCDF;
-        return this->_error;
+    for (size_t i = 0; i < station_size; ++i) {
+      double *series = this->data[static_cast<int>(i)].data() + t0;
+      if (this->_isVector) {
+        for (size_t j = 0; j < nt; ++j) {
+          double u = block1[j * station_size + i];
+          double v = block2[j * station_size + i];
+          series[j] = qSqrt(u * u + v * v);
+        }
+      } else {
+        for (size_t j = 0; j < nt; ++j)
+          series[j] = block1[j * station_size + i];
       }
-      for (int j = 0; j < time_size_int; j++)
-        this->data[i][j] =
-            qSqrt(qPow(tempVar1[j], 2.0) + qPow(tempVar2[j], 2.0));
-    } else {
-      // Place in the output variable
-      for (int j = 0; j < time_size_int; ++j) this->data[i][j] = tempVar1[j];
     }
   }
-  this->_error = nc_close(ncid);
+
+  this->_error = nc_close(this->_ncid);
+  this->_ncid = -1;
   if (this->_error != NC_NOERR) {
-    free(tempVar1);
-    free(tempVar2);
     this->_ncerr = this->_error;
     this->_error = MetOceanViewer::Error::NETCDF;
     return this->_error;
   }
 
-  // Finally, name the stations the default names for now. Later
-  // we can get fancy and try to get the ADCIRC written names in
-  // the NetCDF file
-  this->station_name.resize(station_size_int);
-  for (int i = 0; i < station_size_int; ++i)
-    this->station_name[i] = tr("Station ") + QString::number(i);
+  return 0;
+}
 
-  free(tempVar1);
-  free(tempVar2);
+//...Reads the series of a single station from the open file. This is a
+//   strided read across the time dimension, which is only worth it when a
+//   handful of stations are requested
+int AdcircStationOutput::readNetCDFStation(int index,
+                                           QVector<double> &series) {
+  size_t start[2] = {0, static_cast<size_t>(index)};
+  size_t count[2] = {static_cast<size_t>(this->nSnaps), 1};
+
+  series.resize(this->nSnaps);
+
+  this->_error = nc_get_vara_double(this->_ncid, this->_varid, start, count,
+                                    series.data());
+  if (this->_error == NC_NOERR && this->_isVector) {
+    std::vector<double> v(static_cast<size_t>(this->nSnaps));
+    this->_error =
+        nc_get_vara_double(this->_ncid, this->_varid2, start, count, v.data());
+    if (this->_error == NC_NOERR)
+      for (int j = 0; j < this->nSnaps; ++j)
+        series[j] = qSqrt(series[j] * series[j] + v[j] * v[j]);
+  }
 
-  return 0;
+  if (this->_error != NC_NOERR) {
+    this->_ncerr = this->_error;
+    this->_error = MetOceanViewer::Error::NETCDF;
+    return this->_error;
+  }
+  this->_error = MetOceanViewer::Error::NOERR;
+  return this->_error;
+}
+
+void AdcircStationOutput::buildDates() {
+  this->date.resize(this->nSnaps);
+  for (int j = 0; j < this->nSnaps; ++j)
+    this->date[j] =
+        this->coldStartTime.addSecs(this->time[j]).toMSecsSinceEpoch();
 }
 
+//...Returns the series for one station of a file opened with open(). The
+//   most recently used stations are kept in a cache. The returned station
+//   stays valid for as long as the caller holds it, even after it has been
+//   evicted. Returns a null pointer if the station cannot be read
+QSharedPointer<HmdfStation> AdcircStationOutput::station(int index) {
+  if (!this->_lazy || index < 0 || index >= this->nStations)
+    return QSharedPointer<HmdfStation>();
+
+  QSharedPointer<HmdfStation> *cached = this->_cache.object(index);
+  if (cached) return *cached;
+
+  QVector<double> series;
+  if (this->readNetCDFStation(index, series) != MetOceanViewer::Error::NOERR)
+    return QSharedPointer<HmdfStation>();
+
+  QSharedPointer<HmdfStation> s(new HmdfStation());
+  s->setName(this->station_name[index]);
+  s->setId(this->station_name[index]);
+  s->setLongitude(this->longitude[index]);
+  s->setLatitude(this->latitude[index]);
+  s->setStationIndex(index);
+  s->appendBlock(this->date.constData(), series.constData(), this->nSnaps);
+  s->setIsNull(false);
+
+  //...A series larger than the whole cache is not cached
+  this->_cache.insert(index, new QSharedPointer<HmdfStation>(s), this->nSnaps);
+  return s;
+}
+
+//...Adds the stations to the Hmdf. After open() only the locations and names
+//   are added and the series are read on demand through station()
 int AdcircStationOutput::toHmdf(Hmdf *outputHmdf) {
+  if (this->_lazy) {
+    outputHmdf->store()->reserve(this->nStations, 0);
+    for (int i = 0; i < this->nStations; ++i) {
+      HmdfStation *tempStation = new HmdfStation(outputHmdf->store());
+      tempStation->setName(this->station_name[i]);
+      tempStation->setId(this->station_name[i]);
+      tempStation->setLongitude(this->longitude[i]);
+      tempStation->setLatitude(this->latitude[i]);
+      tempStation->setStationIndex(i);
+      tempStation->setIsNull(false);
+      outputHmdf->addStation(tempStation);
+    }
+    outputHmdf->setSuccess(true);
+    return 0;
+  }
+
+  this->buildDates();
+
+  outputHmdf->store()->reserve(
+      this->nStations, static_cast<size_t>(this->nStations) * this->nSnaps);
+
   for (int i = 0; i < this->nStations; ++i) {
-    HmdfStation *tempStation = new HmdfStation(outputHmdf);
+    HmdfStation *tempStation = new HmdfStation(outputHmdf->store());
     tempStation->setName(this->station_name[i]);
     tempStation->setId(this->station_name[i]);
     tempStation->setLongitude(this->longitude[i]);
     tempStation->setLatitude(this->latitude[i]);
     tempStation->setStationIndex(i);
-    for (int j = 0; j < this->nSnaps; ++j) {
-      tempStation->setNext(
-          this->coldStartTime.addSecs(this->time[j]).toMSecsSinceEpoch(),
-          this->data[i][j]);
-    }
+    tempStation->appendBlock(this->date.constData(), this->data[i].constData(),
+                             this->nSnaps);
     outputHmdf->addStation(tempStation);
   }
   outputHmdf->setSuccess(true);
@@ -20,17 +20,23 @@
 #ifndef ADCIRCSTATIONOUTPUT_H
 #define ADCIRCSTATIONOUTPUT_H
 
+#include <QCache>
 #include <QDateTime>
 #include <QObject>
 #include <QVector>
+#include "filetypes.h"
 #include "hmdf.h"
 
 class AdcircStationOutput : public QObject {
   Q_OBJECT
 public:
   explicit AdcircStationOutput(QObject *parent = nullptr);
+  ~AdcircStationOutput();
 
-  int read(QString AdcircFile, QDateTime coldStart);
+  int read(const FiletypeInfo &info, QDateTime coldStart);
+  int open(const FiletypeInfo &info, QDateTime coldStart);
+  QSharedPointer<HmdfStation> station(int index);
+  void close();
   int read(QString AdcircFile, QString AdcircStationFile, QDateTime coldStart);
   QString errorString();
   int error();
@@ -39,22 +45,33 @@ public:
 private:
   int readAscii(QString AdcircOutputFile, QString AdcircStationFile);
 
-  int readNetCDF(QString AdicrcOutputFile);
+  int readNetCDF(const FiletypeInfo &info);
+  int openNetCDF(const FiletypeInfo &info);
+  int readNetCDFStation(int index, QVector<double> &series);
+  void buildDates();
 
   int nStations;
   int nSnaps;
   int _error;
   int _ncerr;
+  int _ncid;
+  int _varid;
+  int _varid2;
+  bool _isVector;
+  bool _lazy;
 
   QDateTime coldStartTime;
 
   QVector<double> latitude;
   QVector<double> longitude;
   QVector<double> time;
+  QVector<qint64> date;
 
   QVector<QVector<double>> data;
 
   QVector<QString> station_name;
+
+  QCache<int, QSharedPointer<HmdfStation>> _cache;
 };
 
 #endif // ADCIRCSTATIONOUTPUT_H
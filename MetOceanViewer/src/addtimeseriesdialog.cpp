@@ -24,7 +24,6 @@
 #include "filetypes.h"
 #include "generic.h"
 #include "mainwindow.h"
-#include "netcdftimeseries.h"
 #include "ui_addtimeseriesdialog.h"
 
 //-------------------------------------------//
@@ -163,7 +162,8 @@ void AddTimeseriesDialog::setItemsByFiletype() {
     this->setStationSelectElements(false);
     this->setVariableSelectElements(true);
 
-    this->dflow = new Dflow(this->m_inputFilePath, this);
+    this->dflow =
+        new Dflow(Filetypes::getFiletypeInfo(this->m_inputFilePath), this);
 
     if (this->dflow->error->isError()) {
       emit addTimeseriesError(this->dflow->error->toString());
@@ -201,8 +201,8 @@ void AddTimeseriesDialog::setItemsByFiletype() {
     this->setStationSelectElements(false);
     this->setVariableSelectElements(false);
     this->setVerticalLayerElements(false);
-    int epsg = NetcdfTimeseries::getEpsg(this->m_inputFilePath);
-    if (epsg != 0)
+    int epsg = Filetypes::getFiletypeInfo(this->m_inputFilePath).epsg;
+    if (epsg > 0)
       ui->spin_epsg->setValue(epsg);
     else
       ui->spin_epsg->setValue(4326);
@@ -27,8 +27,22 @@
 #include <QtGui/QResizeEvent>
 #include <QtWidgets/QGraphicsScene>
 #include <QtWidgets/QGraphicsTextItem>
+#include <algorithm>
 #include "timezone.h"
 
+//...Series shorter than this many points per horizontal pixel are drawn at
+//   full resolution. Longer series are reduced to the first, minimum,
+//   maximum and last point in each pixel column, which is visually identical
+static const int c_pointsPerBucket = 4;
+static const int c_minimumBuckets = 200;
+
+//...Cursor driven legend updates are coalesced to roughly one per frame
+static const int c_cursorUpdateInterval = 16;
+
+//...Number of samples to walk from the previous cursor hit before falling
+//   back to a binary search
+static const int c_cursorSearchWindow = 8;
+
 ChartView::ChartView(QWidget *parent) : QChartView(new QChart(), parent) {
   this->m_coord = new QGraphicsSimpleTextItem(this->chart());
   this->m_yAxis = nullptr;
@@ -67,6 +81,18 @@ ChartView::ChartView(QWidget *parent) : QChartView(new QChart(), parent) {
   this->current_x_axis_min = 0.0;
   this->current_y_axis_max = 0.0;
   this->current_y_axis_min = 0.0;
+  this->m_decimation = true;
+  this->m_decimatedXMin = 0.0;
+  this->m_decimatedXMax = 0.0;
+  this->m_decimatedBuckets = 0;
+  this->m_useOpenGL = false;
+  this->m_cursorPending = false;
+
+  this->m_cursorTimer = new QTimer(this);
+  this->m_cursorTimer->setSingleShot(true);
+  this->m_cursorTimer->setInterval(c_cursorUpdateInterval);
+  connect(this->m_cursorTimer, SIGNAL(timeout()), this,
+          SLOT(flushCursorValues()));
 }
 
 ChartView::~ChartView() {}
@@ -144,6 +170,14 @@ void ChartView::clear() {
   if (this->chart()->series().length() > 0) this->chart()->removeAllSeries();
   this->m_legendNames.clear();
   this->m_series.clear();
+  this->m_date.clear();
+  this->m_data.clear();
+  this->m_sorted.clear();
+  this->m_legendMarkers.clear();
+  this->m_cursorIndex.clear();
+  this->m_cursorTimer->stop();
+  this->m_cursorPending = false;
+  this->m_decimatedBuckets = 0;
   this->removeTraceLines();
   return;
 }
@@ -168,20 +202,48 @@ void ChartView::initializeLegendMarkers() {
   return;
 }
 
+//...Adds a series that is drawn as given, without the decimation and
+//   cursor tracking of addSeries. It still follows the OpenGL setting
+void ChartView::addStaticSeries(QAbstractSeries *series) {
+  series->setUseOpenGL(this->m_useOpenGL);
+  this->chart()->addSeries(series);
+  return;
+}
+
 void ChartView::addSeries(QLineSeries *series, QString name) {
+  this->addSeries(series, series->pointsVector(), name);
+  return;
+}
+
+void ChartView::addSeries(QLineSeries *series, const QVector<QPointF> &points,
+                          QString name) {
   this->m_series.push_back(series);
   this->m_legendNames.push_back(name);
 
-  this->chart()->addSeries(series);
-
+  //...The full resolution data lives here. The series itself only ever
+  //   holds what is needed to draw the current view
   this->m_date.resize(this->m_date.size() + 1);
   this->m_data.resize(this->m_data.size() + 1);
-  this->m_date.last().resize(series->pointsVector().size());
-  this->m_data.last().resize(series->pointsVector().size());
-  for (size_t i = 0; i < series->pointsVector().size(); i++) {
-    this->m_date.last()[i] = series->pointsVector().at(i).x();
-    this->m_data.last()[i] = series->pointsVector().at(i).y();
+  this->m_date.last().resize(points.size());
+  this->m_data.last().resize(points.size());
+  for (int i = 0; i < points.size(); i++) {
+    this->m_date.last()[i] = points[i].x();
+    this->m_data.last()[i] = points[i].y();
   }
+  this->m_sorted.push_back(std::is_sorted(this->m_date.last().begin(),
+                                          this->m_date.last().end()));
+  series->setUseOpenGL(this->m_useOpenGL);
+
+  if (points.isEmpty())
+    series->clear();
+  else
+    this->decimateSeries(this->m_series.size() - 1, points.first().x(),
+                         points.last().x(), this->decimationBuckets());
+
+  this->chart()->addSeries(series);
+  this->m_legendMarkers.push_back(
+      this->chart()->legend()->markers(series).value(0, nullptr));
+  this->m_cursorIndex.push_back(0);
 
   if (this->xAxis() != nullptr)
     series->attachAxis(this->xAxis());
@@ -192,19 +254,184 @@ void ChartView::addSeries(QLineSeries *series, QString name) {
   return;
 }
 
-void ChartView::rebuild() {
-  for (size_t j = 0; j < this->chart()->series().length(); j++) {
-    QLineSeries *series =
-        static_cast<QLineSeries *>(this->chart()->series().at(j));
-    for (size_t i = 0; i < series->pointsVector().length(); i++) {
-      this->m_date[j][i] = series->pointsVector().at(i).x();
-      this->m_data[j][i] = series->pointsVector().at(i).y();
+void ChartView::offsetSeries(qreal dx) {
+  for (int j = 0; j < this->m_date.size(); j++) {
+    for (int i = 0; i < this->m_date[j].size(); i++) {
+      this->m_date[j][i] += dx;
     }
   }
+  this->m_decimatedBuckets = 0;
+  return;
+}
+
+void ChartView::rebuild() {
   this->initializeAxisLimits();
   return;
 }
 
+bool ChartView::decimation() const { return this->m_decimation; }
+
+void ChartView::setDecimation(bool decimation) {
+  this->m_decimation = decimation;
+  this->decimateAllSeries(true);
+  return;
+}
+
+bool ChartView::useOpenGL() const { return this->m_useOpenGL; }
+
+void ChartView::setUseOpenGL(bool useOpenGL) {
+  if (useOpenGL == this->m_useOpenGL) return;
+  this->m_useOpenGL = useOpenGL;
+  this->setSeriesOpenGL(useOpenGL);
+  return;
+}
+
+//...Applies to every series in the chart, including those added directly
+//   to the chart such as the scatter series of the high water mark plots
+void ChartView::setSeriesOpenGL(bool useOpenGL) {
+  foreach (QAbstractSeries *series, this->chart()->series()) {
+    series->setUseOpenGL(useOpenGL);
+  }
+  return;
+}
+
+void ChartView::renderChart(QPainter *painter, const QRectF &target) {
+  //...Accelerated series are drawn on a GL surface stacked over the view
+  //   and are not part of the scene, so a scene render would leave them
+  //   out. Drop back to the raster path for the duration of the export.
+  //   The chart rebuilds the series items through posted events, so those
+  //   are processed with animations off before the scene is rendered
+  QList<QAbstractSeries *> accelerated;
+  foreach (QAbstractSeries *series, this->chart()->series()) {
+    if (series->useOpenGL()) accelerated.push_back(series);
+  }
+
+  QChart::AnimationOptions animation = this->chart()->animationOptions();
+  if (!accelerated.isEmpty()) {
+    this->chart()->setAnimationOptions(QChart::NoAnimation);
+    foreach (QAbstractSeries *series, accelerated) {
+      series->setUseOpenGL(false);
+    }
+    QCoreApplication::processEvents(QEventLoop::ExcludeUserInputEvents);
+  }
+
+  this->render(painter, target);
+
+  if (!accelerated.isEmpty()) {
+    foreach (QAbstractSeries *series, accelerated) {
+      series->setUseOpenGL(true);
+    }
+    this->chart()->setAnimationOptions(animation);
+  }
+  return;
+}
+
+int ChartView::decimationBuckets() {
+  int width = static_cast<int>(this->chart()->plotArea().width());
+  if (width <= 0) width = this->width();
+  return std::max(width, c_minimumBuckets);
+}
+
+void ChartView::visibleXRange(qreal &xmin, qreal &xmax) const {
+  if (this->m_style == 1 && this->m_dateAxis != nullptr) {
+    xmin = this->m_dateAxis->min().toMSecsSinceEpoch();
+    xmax = this->m_dateAxis->max().toMSecsSinceEpoch();
+  } else if (this->m_xAxis != nullptr) {
+    xmin = this->m_xAxis->min();
+    xmax = this->m_xAxis->max();
+  } else {
+    xmin = this->current_x_axis_min;
+    xmax = this->current_x_axis_max;
+  }
+  return;
+}
+
+void ChartView::decimateSeries(int index, qreal xmin, qreal xmax,
+                               int buckets) {
+  const QVector<double> &x = this->m_date[index];
+  const QVector<double> &y = this->m_data[index];
+  int n = x.size();
+
+  QVector<QPointF> points;
+
+  if (!this->m_decimation || !this->m_sorted[index] ||
+      n <= c_pointsPerBucket * buckets) {
+    points.reserve(n);
+    for (int i = 0; i < n; i++) points.push_back(QPointF(x[i], y[i]));
+    this->m_series[index]->replace(points);
+    return;
+  }
+
+  //...Keep one point on either side of the window so the line runs
+  //   off the edge of the plot instead of stopping short
+  int first = static_cast<int>(std::lower_bound(x.begin(), x.end(), xmin) -
+                               x.begin());
+  int last = static_cast<int>(std::upper_bound(x.begin(), x.end(), xmax) -
+                              x.begin());
+  first = std::max(first - 1, 0);
+  last = std::min(last, n - 1);
+
+  if (last < first) {
+    this->m_series[index]->replace(points);
+    return;
+  }
+
+  double width = (x[last] - x[first]) / buckets;
+
+  if (last - first + 1 <= c_pointsPerBucket * buckets || width <= 0.0) {
+    points.reserve(last - first + 1);
+    for (int i = first; i <= last; i++) points.push_back(QPointF(x[i], y[i]));
+    this->m_series[index]->replace(points);
+    return;
+  }
+
+  points.reserve(c_pointsPerBucket * buckets + 2);
+  int i = first;
+  while (i <= last) {
+    int bucket = std::min(static_cast<int>((x[i] - x[first]) / width),
+                          buckets - 1);
+    double bucketEnd = x[first] + (bucket + 1) * width;
+    int iFirst = i, iMin = i, iMax = i;
+    for (i = i + 1;
+         i <= last && (x[i] < bucketEnd || bucket == buckets - 1); i++) {
+      if (y[i] < y[iMin]) iMin = i;
+      if (y[i] > y[iMax]) iMax = i;
+    }
+    int iLast = i - 1;
+
+    //...Emit the bucket in x order so the line does not double back
+    int idx[4] = {iFirst, std::min(iMin, iMax), std::max(iMin, iMax), iLast};
+    for (int k = 0; k < 4; k++) {
+      if (k == 0 || idx[k] != idx[k - 1])
+        points.push_back(QPointF(x[idx[k]], y[idx[k]]));
+    }
+  }
+
+  this->m_series[index]->replace(points);
+  return;
+}
+
+void ChartView::decimateAllSeries(bool force) {
+  if (this->m_series.isEmpty()) return;
+
+  qreal xmin, xmax;
+  this->visibleXRange(xmin, xmax);
+  int buckets = this->decimationBuckets();
+
+  if (!force && buckets == this->m_decimatedBuckets &&
+      xmin == this->m_decimatedXMin && xmax == this->m_decimatedXMax)
+    return;
+
+  this->m_decimatedXMin = xmin;
+  this->m_decimatedXMax = xmax;
+  this->m_decimatedBuckets = buckets;
+
+  for (int i = 0; i < this->m_series.size(); i++) {
+    this->decimateSeries(i, xmin, xmax, buckets);
+  }
+  return;
+}
+
 void ChartView::resizeEvent(QResizeEvent *event) {
   if (scene()) {
     scene()->setSceneRect(QRect(QPoint(0, 0), event->size()));
@@ -213,6 +440,7 @@ void ChartView::resizeEvent(QResizeEvent *event) {
       this->chart()->resize(event->size());
       this->m_coord->setPos(this->chart()->size().width() / 2 - 100,
                             this->chart()->size().height() - 20);
+      this->decimateAllSeries();
       if (this->m_displayValues) {
         this->removeTraceLines();
       }
@@ -225,16 +453,18 @@ void ChartView::resizeEvent(QResizeEvent *event) {
 void ChartView::removeTraceLines() {
   if (this->m_xTraceLinePtr != nullptr) {
     this->scene()->removeItem(this->m_xTraceLinePtr);
+    delete this->m_xTraceLinePtr;
     this->m_xTraceLinePtr = nullptr;
   }
   if (this->m_yTraceLinePtr != nullptr) {
     this->scene()->removeItem(this->m_yTraceLinePtr);
+    delete this->m_yTraceLinePtr;
     this->m_yTraceLinePtr = nullptr;
   }
   return;
 }
 
-void ChartView::addXTraceLine(QMouseEvent *event) {
+void ChartView::addXTraceLine(const QPoint &pos) {
   qreal ymin = this->chart()
                    ->mapToPosition(QPointF(this->current_x_axis_min,
                                            this->current_y_axis_min))
@@ -243,54 +473,78 @@ void ChartView::addXTraceLine(QMouseEvent *event) {
                    ->mapToPosition(QPointF(this->current_x_axis_max,
                                            this->current_y_axis_max))
                    .y();
-  this->removeTraceLines();
-  this->m_xTraceLine.setLine(event->pos().x(), ymin, event->pos().x(), ymax);
-  this->m_xTraceLinePtr = this->scene()->addLine(this->m_xTraceLine);
+  this->m_xTraceLine.setLine(pos.x(), ymin, pos.x(), ymax);
+  if (this->m_yTraceLinePtr != nullptr) this->removeTraceLines();
+  if (this->m_xTraceLinePtr == nullptr)
+    this->m_xTraceLinePtr = this->scene()->addLine(this->m_xTraceLine);
+  else
+    this->m_xTraceLinePtr->setLine(this->m_xTraceLine);
   return;
 }
 
-void ChartView::addXYTraceLine(QMouseEvent *event) {
+void ChartView::addXYTraceLine(const QPoint &pos) {
   QPointF min = this->chart()->mapToPosition(
       QPointF(this->current_x_axis_min, this->current_y_axis_min));
   QPointF max = this->chart()->mapToPosition(
       QPointF(this->current_x_axis_max, this->current_y_axis_max));
-  this->removeTraceLines();
-  this->m_xTraceLine.setLine(event->pos().x(), min.y(), event->pos().x(),
-                             max.y());
-  this->m_yTraceLine.setLine(min.x(), event->pos().y(), max.x(),
-                             event->pos().y());
-  this->m_xTraceLinePtr = this->scene()->addLine(this->m_xTraceLine);
-  this->m_yTraceLinePtr = this->scene()->addLine(this->m_yTraceLine);
+  this->m_xTraceLine.setLine(pos.x(), min.y(), pos.x(), max.y());
+  this->m_yTraceLine.setLine(min.x(), pos.y(), max.x(), pos.y());
+  if (this->m_xTraceLinePtr == nullptr || this->m_yTraceLinePtr == nullptr) {
+    this->removeTraceLines();
+    this->m_xTraceLinePtr = this->scene()->addLine(this->m_xTraceLine);
+    this->m_yTraceLinePtr = this->scene()->addLine(this->m_yTraceLine);
+  } else {
+    this->m_xTraceLinePtr->setLine(this->m_xTraceLine);
+    this->m_yTraceLinePtr->setLine(this->m_yTraceLine);
+  }
   return;
 }
 
-void ChartView::addTraceLines(QMouseEvent *event) {
+void ChartView::addTraceLines(const QPoint &pos) {
   if (this->m_style == 1) {
-    this->addXTraceLine(event);
+    this->addXTraceLine(pos);
   } else if (this->m_style == 2) {
-    this->addXYTraceLine(event);
+    this->addXYTraceLine(pos);
   }
   return;
 }
 
 bool ChartView::getNearestPointToCursor(qreal cursorXPosition, int seriesIndex,
                                         qreal &x, qreal &y) {
-  qreal x_ll = this->m_series[seriesIndex]->at(0).x();
-  qreal x_ul = this->m_series[seriesIndex]
-                   ->at(this->m_series[seriesIndex]->pointsVector().size() - 1)
-                   .x();
-
-  if (cursorXPosition >= x_ll && cursorXPosition <= x_ul) {
-    size_t i_min =
-        std::lower_bound(this->m_date[seriesIndex].begin(),
-                         this->m_date[seriesIndex].end(), cursorXPosition) -
-        this->m_date[seriesIndex].begin();
-    x = this->m_series[seriesIndex]->at(i_min).x();
-    y = this->m_series[seriesIndex]->at(i_min).y();
-    return true;
-  } else {
+  const QVector<double> &date = this->m_date[seriesIndex];
+  int n = date.size();
+  if (n == 0 || cursorXPosition < date.first() ||
+      cursorXPosition > date.last())
     return false;
+
+  //...The cursor usually moves a few samples between updates, so start
+  //   from the previous hit and only binary search on a large jump
+  int i = qBound(0, this->m_cursorIndex[seriesIndex], n - 1);
+  for (int step = 0; step < c_cursorSearchWindow; step++) {
+    if (date[i] < cursorXPosition && i < n - 1)
+      i++;
+    else if (i > 0 && date[i - 1] >= cursorXPosition)
+      i--;
+    else
+      break;
   }
+  if (date[i] < cursorXPosition || (i > 0 && date[i - 1] >= cursorXPosition))
+    i = static_cast<int>(
+        std::lower_bound(date.begin(), date.end(), cursorXPosition) -
+        date.begin());
+
+  if (i > 0 && cursorXPosition - date[i - 1] < date[i] - cursorXPosition) i--;
+  this->m_cursorIndex[seriesIndex] = i;
+
+  x = date[i];
+  y = this->m_data[seriesIndex][i];
+  return true;
+}
+
+void ChartView::setLegendLabel(int seriesIndex, const QString &label) {
+  QLegendMarker *marker = this->m_legendMarkers[seriesIndex];
+  if (marker != nullptr && marker->label() != label) marker->setLabel(label);
+  return;
 }
 
 void ChartView::addLineValuesToLegend(qreal x) {
@@ -298,10 +552,10 @@ void ChartView::addLineValuesToLegend(qreal x) {
     qreal xv, yv;
     bool found = getNearestPointToCursor(x, i, xv, yv);
     if (found)
-      this->chart()->series().at(i)->setName(this->m_legendNames.at(i) + ": " +
-                                             QString::number(yv));
+      this->setLegendLabel(
+          i, this->m_legendNames.at(i) + ": " + QString::number(yv));
     else
-      this->chart()->series().at(i)->setName(this->m_legendNames.at(i));
+      this->setLegendLabel(i, this->m_legendNames.at(i));
   }
   QDateTime date = QDateTime::fromMSecsSinceEpoch(x);
   date.setTimeSpec(Qt::UTC);
@@ -343,22 +597,45 @@ void ChartView::resetPlotLegend() {
   this->m_coord->setText("");
   if (this->m_statusBar) this->m_statusBar->clearMessage();
   for (int i = 0; i < this->m_series.length(); i++)
-    this->chart()->series().at(i)->setName(this->m_legendNames.at(i));
+    this->setLegendLabel(i, this->m_legendNames.at(i));
   this->removeTraceLines();
 }
 
+void ChartView::updateCursorValues(const QPoint &pos) {
+  qreal x = this->chart()->mapToValue(pos).x();
+  qreal y = this->chart()->mapToValue(pos).y();
+
+  if (this->isOnPlot(x, y)) {
+    this->makeDynamicLegendLabels(x, y);
+    this->addTraceLines(pos);
+    this->displayInstructionsOnStatusBar();
+  } else {
+    this->resetPlotLegend();
+  }
+  return;
+}
+
+void ChartView::flushCursorValues() {
+  if (!this->m_cursorPending) return;
+  this->m_cursorPending = false;
+  if (this->m_displayValues) {
+    this->updateCursorValues(this->m_cursorPosition);
+    this->m_cursorTimer->start();
+  }
+  return;
+}
+
 void ChartView::mouseMoveEvent(QMouseEvent *event) {
   if (this->m_coord) {
     if (this->m_displayValues) {
-      qreal x = this->chart()->mapToValue(event->pos()).x();
-      qreal y = this->chart()->mapToValue(event->pos()).y();
-
-      if (this->isOnPlot(x, y)) {
-        this->makeDynamicLegendLabels(x, y);
-        this->addTraceLines(event);
-        this->displayInstructionsOnStatusBar();
+      //...Draw the first move right away, then hold any further moves
+      //   until the next frame so only the latest position is drawn
+      if (this->m_cursorTimer->isActive()) {
+        this->m_cursorPosition = event->pos();
+        this->m_cursorPending = true;
       } else {
-        this->resetPlotLegend();
+        this->updateCursorValues(event->pos());
+        this->m_cursorTimer->start();
       }
     } else {
       this->resetPlotLegend();
@@ -371,7 +648,10 @@ void ChartView::mouseMoveEvent(QMouseEvent *event) {
 
 void ChartView::mouseReleaseEvent(QMouseEvent *event) {
   QChartView::mouseReleaseEvent(event);
-  if (this->chart()) this->resetAxisLimits();
+  if (this->chart()) {
+    this->resetAxisLimits();
+    this->decimateAllSeries();
+  }
   return;
 }
 
@@ -392,6 +672,7 @@ void ChartView::wheelEvent(QWheelEvent *event) {
   QChartView::wheelEvent(event);
 
   this->resetAxisLimits();
+  this->decimateAllSeries();
 
   return;
 }
@@ -400,6 +681,7 @@ void ChartView::resetZoom() {
   if (this->chart()) {
     this->chart()->zoomReset();
     this->resetAxisLimits();
+    this->decimateAllSeries();
   }
   return;
 }
@@ -483,6 +765,7 @@ void ChartView::initializeAxisLimits() {
   this->current_y_axis_max = this->y_axis_max;
   this->current_x_axis_min = this->x_axis_min;
   this->current_y_axis_min = this->y_axis_min;
+  this->decimateAllSeries();
   return;
 }
 
@@ -23,6 +23,7 @@
 #include <QChartView>
 #include <QDateTimeAxis>
 #include <QLineF>
+#include <QLegendMarker>
 #include <QLineSeries>
 #include <QValueAxis>
 #include <QtCharts/QChartGlobal>
@@ -52,10 +53,22 @@ class ChartView : public QChartView {
   void resetZoom();
   void setStatusBar(QStatusBar *inStatusBar);
   void addSeries(QLineSeries *series, QString name);
+  void addSeries(QLineSeries *series, const QVector<QPointF> &points,
+                 QString name);
+  void addStaticSeries(QAbstractSeries *series);
+  void offsetSeries(qreal dx);
   void setDisplayValues(bool value);
   void rebuild();
   void clear();
 
+  bool decimation() const;
+  void setDecimation(bool decimation);
+
+  bool useOpenGL() const;
+  void setUseOpenGL(bool useOpenGL);
+
+  void renderChart(QPainter *painter, const QRectF &target = QRectF());
+
   QGraphicsSimpleTextItem *coord() const;
 
   int style() const;
@@ -103,10 +116,20 @@ class ChartView : public QChartView {
   QVector<QLineSeries *> m_series;
   QVector<QVector<double>> m_date;
   QVector<QVector<double>> m_data;
+  QVector<bool> m_sorted;
+  bool m_decimation;
+  qreal m_decimatedXMin, m_decimatedXMax;
+  int m_decimatedBuckets;
+  bool m_useOpenGL;
+  QVector<QLegendMarker *> m_legendMarkers;
+  QVector<int> m_cursorIndex;
+  QTimer *m_cursorTimer;
+  QPoint m_cursorPosition;
+  bool m_cursorPending;
   QLineF m_yTraceLine;
   QLineF m_xTraceLine;
-  QGraphicsItem *m_yTraceLinePtr;
-  QGraphicsItem *m_xTraceLinePtr;
+  QGraphicsLineItem *m_yTraceLinePtr;
+  QGraphicsLineItem *m_xTraceLinePtr;
   bool m_displayValues;
 
   QDateTimeAxis *m_dateAxis;
@@ -121,9 +144,9 @@ class ChartView : public QChartView {
   bool getNearestPointToCursor(qreal cursorXPosition, int seriesIndex, qreal &x,
                                qreal &y);
   bool isOnPlot(qreal x, qreal y);
-  void addTraceLines(QMouseEvent *event);
-  void addXTraceLine(QMouseEvent *event);
-  void addXYTraceLine(QMouseEvent *event);
+  void addTraceLines(const QPoint &pos);
+  void addXTraceLine(const QPoint &pos);
+  void addXYTraceLine(const QPoint &pos);
   void removeTraceLines();
 
   void addLineValuesToLegend(qreal x);
@@ -136,8 +159,20 @@ class ChartView : public QChartView {
 
   void resetPlotLegend();
 
+  void setLegendLabel(int seriesIndex, const QString &label);
+  void updateCursorValues(const QPoint &pos);
+
+  int decimationBuckets();
+  void visibleXRange(qreal &xmin, qreal &xmax) const;
+  void decimateSeries(int index, qreal xmin, qreal xmax, int buckets);
+  void decimateAllSeries(bool force = false);
+  void setSeriesOpenGL(bool useOpenGL);
+
  public slots:
   void handleLegendMarkerClicked();
+
+ private slots:
+  void flushCursorValues();
 };
 
 #endif  // CHARTVIEW_H
@@ -1,24 +1,36 @@
 #include "dflow.h"
 #include <QtMath>
+#include <algorithm>
+#include <cstring>
+#include <vector>
 #include "errors.h"
 #include "hmdf.h"
 #include "metoceanviewer.h"
-#include "netcdf"
+#include "netcdf.h"
 
-using namespace netCDF;
-using namespace netCDF::exceptions;
+//...Value D-Flow FM writes for missing data
+static const double c_fillValue = -999.0;
 
-Dflow::Dflow(QString filename, QObject *parent) : QObject(parent) {
+//...Memory used for each block of layers read from the file
+static const size_t c_layerBlockBytes = 64 * 1024 * 1024;
+
+//...The schema is taken from the detected file type rather than read from
+//   the file again
+Dflow::Dflow(const FiletypeInfo &info, QObject *parent) : QObject(parent) {
   this->_isInitialized = false;
   this->_readError = true;
-  this->_filename = filename;
+  this->_filename = info.filename;
   this->_is3d = false;
   this->error = new Errors(this);
   this->_nSteps = 0;
   this->_nStations = 0;
   this->_nLayers = 0;
+  this->_ncid = -1;
+  this->_lazyLayer = 0;
+  this->_hasTime = false;
+  this->_cache.setMaxCost(MetOceanViewer::STATION_CACHE_SAMPLES);
 
-  int ierr = this->_init();
+  int ierr = this->_init(info);
 
   this->error->setErrorCode(ierr);
 
@@ -32,6 +44,8 @@ Dflow::Dflow(QString filename, QObject *parent) : QObject(parent) {
   return;
 }
 
+Dflow::~Dflow() { this->_close(); }
+
 bool Dflow::is3d() { return this->_is3d; }
 
 QStringList Dflow::getVaribleList() { return QStringList(this->_plotvarnames); }
@@ -51,202 +65,197 @@ bool Dflow::variableIs3d(QString variable) {
     return false;
 }
 
-int Dflow::_get2DVelocityMagnitude(int layer, QVector<QVector<double>> &data) {
-  int ierr, i, j;
-  QVector<QVector<double>> x_data, y_data;
-
-  ierr = this->_getVar(QStringLiteral("x_velocity"), layer, x_data);
-  if (ierr != MetOceanViewer::Error::NOERR) {
-    this->error->setErrorCode(MetOceanViewer::Error::DFLOW_NOXVELOCITY);
-    return this->error->errorCode();
-  }
-
-  ierr = this->_getVar(QStringLiteral("y_velocity"), layer, y_data);
-  if (ierr != MetOceanViewer::Error::NOERR) {
-    this->error->setErrorCode(MetOceanViewer::Error::DFLOW_NOYVELOCITY);
-    return this->error->errorCode();
+//...Speed and direction are computed from the components in one pass over
+//   the raw [time, station] blocks. Each component is read once for the
+//   whole station range
+int Dflow::_getMagnitude(const QStringList &components, int layer, int first,
+                         int n, QVector<QVector<double>> &data) {
+  static const int componentError[] = {
+      MetOceanViewer::Error::DFLOW_NOXVELOCITY,
+      MetOceanViewer::Error::DFLOW_NOYVELOCITY,
+      MetOceanViewer::Error::DFLOW_NOZVELOCITY};
+
+  int nc = components.size();
+  std::vector<std::vector<double>> raw(nc);
+  for (int c = 0; c < nc; c++) {
+    int ierr = this->_readRaw(components[c], layer, first, n, raw[c]);
+    if (ierr != MetOceanViewer::Error::NOERR) {
+      this->error->setErrorCode(componentError[qMin(c, 2)]);
+      return this->error->errorCode();
+    }
   }
 
-  data.resize(this->_nStations);
-  for (i = 0; i < this->_nStations; i++) {
-    data[i].resize(this->_nSteps);
-    for (j = 0; j < this->_nSteps; j++) {
-      if (x_data[i][j] == MetOceanViewer::NULL_TS ||
-          y_data[i][j] == MetOceanViewer::NULL_TS)
-        data[i][j] = MetOceanViewer::NULL_TS;
-      else
-        data[i][j] = qSqrt(qPow(x_data[i][j], 2.0) + qPow(y_data[i][j], 2.0));
+  data.resize(n);
+  for (int j = 0; j < n; j++) data[j].resize(this->_nSteps);
+
+  for (int i = 0; i < this->_nSteps; i++) {
+    for (int j = 0; j < n; j++) {
+      size_t k = static_cast<size_t>(i) * n + j;
+      double sum = 0.0;
+      bool isNull = false;
+      for (int c = 0; c < nc; c++) {
+        double v = raw[c][k];
+        if (v == c_fillValue) isNull = true;
+        sum += v * v;
+      }
+      data[j][i] = isNull ? MetOceanViewer::NULL_TS : qSqrt(sum);
     }
   }
   return MetOceanViewer::Error::NOERR;
 }
 
-int Dflow::_get2DVelocityDirection(int layer, QVector<QVector<double>> &data) {
-  int ierr, i, j;
-  QVector<QVector<double>> x_data, y_data;
+int Dflow::_getDirection(const QString &xComponent, const QString &yComponent,
+                         int layer, int first, int n,
+                         QVector<QVector<double>> &data) {
+  std::vector<double> x, y;
 
-  ierr = this->_getVar(QStringLiteral("x_velocity"), layer, x_data);
+  int ierr = this->_readRaw(xComponent, layer, first, n, x);
   if (ierr != MetOceanViewer::Error::NOERR) {
     this->error->setErrorCode(MetOceanViewer::Error::DFLOW_NOXVELOCITY);
     return this->error->errorCode();
   }
 
-  ierr = this->_getVar(QStringLiteral("y_velocity"), layer, y_data);
+  ierr = this->_readRaw(yComponent, layer, first, n, y);
   if (ierr != MetOceanViewer::Error::NOERR) {
     this->error->setErrorCode(MetOceanViewer::Error::DFLOW_NOYVELOCITY);
     return this->error->errorCode();
   }
 
-  data.resize(this->_nStations);
-  for (i = 0; i < this->_nStations; i++) {
-    data[i].resize(this->_nSteps);
-    for (j = 0; j < this->_nSteps; j++)
-      if (x_data[i][j] == MetOceanViewer::NULL_TS ||
-          y_data[i][j] == MetOceanViewer::NULL_TS)
-        data[i][j] = MetOceanViewer::NULL_TS;
+  data.resize(n);
+  for (int j = 0; j < n; j++) data[j].resize(this->_nSteps);
+
+  for (int i = 0; i < this->_nSteps; i++) {
+    for (int j = 0; j < n; j++) {
+      size_t k = static_cast<size_t>(i) * n + j;
+      if (x[k] == c_fillValue || y[k] == c_fillValue)
+        data[j][i] = MetOceanViewer::NULL_TS;
       else
-        data[i][j] = qAtan2(y_data[i][j], x_data[i][j]) * 180.0 / M_PI;
+        data[j][i] = qAtan2(y[k], x[k]) * 180.0 / M_PI;
+    }
   }
   return MetOceanViewer::Error::NOERR;
 }
 
-int Dflow::_get3DVeloctiyMagnitude(int layer, QVector<QVector<double>> &data) {
-  int ierr, i, j;
-  QVector<QVector<double>> x_data, y_data, z_data;
+//...Reads a variable, or one derived from it, for n consecutive stations
+//   starting at first
+int Dflow::_getData(QString variable, int layer, int first, int n,
+                    QVector<QVector<double>> &data) {
+  if (variable == QStringLiteral("2D_current_speed"))
+    return this->_getMagnitude(
+        QStringList() << QStringLiteral("x_velocity")
+                      << QStringLiteral("y_velocity"),
+        layer, first, n, data);
+  else if (variable == QStringLiteral("2D_current_direction"))
+    return this->_getDirection(QStringLiteral("x_velocity"),
+                               QStringLiteral("y_velocity"), layer, first, n,
+                               data);
+  else if (variable == QStringLiteral("3D_current_speed"))
+    return this->_getMagnitude(QStringList() << QStringLiteral("x_velocity")
+                                             << QStringLiteral("y_velocity")
+                                             << QStringLiteral("z_velocity"),
+                               layer, first, n, data);
+  else if (variable == QStringLiteral("wind_speed"))
+    return this->_getMagnitude(
+        QStringList() << QStringLiteral("windx") << QStringLiteral("windy"), 0,
+        first, n, data);
+  else if (variable == QStringLiteral("wind_direction"))
+    return this->_getDirection(QStringLiteral("windx"),
+                               QStringLiteral("windy"), 0, first, n, data);
 
-  ierr = this->_getVar(QStringLiteral("x_velocity"), layer, x_data);
-  if (ierr != MetOceanViewer::Error::NOERR) {
-    this->error->setErrorCode(MetOceanViewer::Error::DFLOW_NOXVELOCITY);
-    return this->error->errorCode();
-  }
+  QString base;
+  LayerReduction reduction;
+  if (this->_layerReduction(variable, base, reduction))
+    return this->_getLayerReduction(base, reduction, first, n, data);
 
-  ierr = this->_getVar(QStringLiteral("y_velocity"), layer, y_data);
-  if (ierr != MetOceanViewer::Error::NOERR) {
-    this->error->setErrorCode(MetOceanViewer::Error::DFLOW_NOYVELOCITY);
-    return this->error->errorCode();
-  }
+  return this->_getVar(variable, layer, first, n, data);
+}
 
-  ierr = this->_getVar(QStringLiteral("z_velocity"), layer, z_data);
-  if (ierr != MetOceanViewer::Error::NOERR) {
-    this->error->setErrorCode(MetOceanViewer::Error::DFLOW_NOZVELOCITY);
-    return this->error->errorCode();
-  }
+int Dflow::getVariable(QString variable, int layer, Hmdf *hmdf) {
+  int i, ierr;
+  QVector<QVector<double>> data;
 
-  data.resize(this->_nStations);
-  for (i = 0; i < this->_nStations; i++) {
-    data[i].resize(this->_nSteps);
-    for (j = 0; j < this->_nSteps; j++) {
-      if (x_data[i][j] == MetOceanViewer::NULL_TS ||
-          y_data[i][j] == MetOceanViewer::NULL_TS ||
-          z_data[i][j] == MetOceanViewer::NULL_TS)
-        data[i][j] = MetOceanViewer::NULL_TS;
-      else
-        data[i][j] = qSqrt(qPow(x_data[i][j], 2.0) + qPow(y_data[i][j], 2.0) +
-                           qPow(z_data[i][j], 2.0));
-    }
-  }
-  return MetOceanViewer::Error::NOERR;
-}
+  ierr = this->_getTime();
+  this->error->setErrorCode(ierr);
+  if (this->error->isError()) return this->error->errorCode();
 
-int Dflow::_getWindVelocityMagnitude(QVector<QVector<double>> &data) {
-  int ierr, i, j;
-  QVector<QVector<double>> x_data, y_data;
+  //...Check for derrived data or just retrieve the
+  //   requested variable
+  ierr = this->_getData(variable, layer, 0, this->_nStations, data);
 
-  ierr = this->_getVar(QStringLiteral("windx"), 0, x_data);
   if (ierr != MetOceanViewer::Error::NOERR) {
-    this->error->setErrorCode(MetOceanViewer::Error::DFLOW_NOXVELOCITY);
-    return this->error->errorCode();
-  }
-  ierr = this->_getVar(QStringLiteral("windy"), 0, y_data);
-  if (ierr != MetOceanViewer::Error::NOERR) {
-    this->error->setErrorCode(MetOceanViewer::Error::DFLOW_NOYVELOCITY);
+    this->error->setErrorCode(ierr);
     return this->error->errorCode();
   }
-  data.resize(this->_nStations);
-  for (i = 0; i < this->_nStations; i++) {
-    data[i].resize(this->_nSteps);
-    for (j = 0; j < this->_nSteps; j++) {
-      if (x_data[i][j] == MetOceanViewer::NULL_TS ||
-          y_data[i][j] == MetOceanViewer::NULL_TS)
-        data[i][j] = MetOceanViewer::NULL_TS;
-      else
-        data[i][j] = qSqrt(qPow(x_data[i][j], 2.0) + qPow(y_data[i][j], 2.0));
-    }
-  }
-  return MetOceanViewer::Error::NOERR;
-}
 
-int Dflow::_getWindDirection(QVector<QVector<double>> &data) {
-  int ierr, i, j;
-  QVector<QVector<double>> x_data, y_data;
+  hmdf->setSuccess(false);
+  hmdf->setDatum("dflowfm_datum");
+  hmdf->setHeader1("DFlowFM");
+  hmdf->setHeader2("DFlowFM");
+  hmdf->setHeader3("DFlowFM");
+  hmdf->store()->reserve(this->_nStations,
+                         static_cast<size_t>(this->_nStations) *
+                             this->_time.size());
 
-  ierr = this->_getVar(QStringLiteral("windx"), 0, x_data);
-  if (ierr != MetOceanViewer::Error::NOERR) {
-    this->error->setErrorCode(MetOceanViewer::Error::DFLOW_NOXVELOCITY);
-    return this->error->errorCode();
-  }
-  ierr = this->_getVar(QStringLiteral("windy"), 0, y_data);
-  if (ierr != MetOceanViewer::Error::NOERR) {
-    this->error->setErrorCode(MetOceanViewer::Error::DFLOW_NOYVELOCITY);
-    return this->error->errorCode();
-  }
-  data.resize(this->_nStations);
   for (i = 0; i < this->_nStations; i++) {
-    data[i].resize(this->_nSteps);
-    for (j = 0; j < this->_nSteps; j++)
-      if (x_data[i][j] == MetOceanViewer::NULL_TS ||
-          y_data[i][j] == MetOceanViewer::NULL_TS)
-        data[i][j] = MetOceanViewer::NULL_TS;
-      else
-        data[i][j] = qAtan2(y_data[i][j], x_data[i][j]) * 180.0 / M_PI;
+    HmdfStation *station = new HmdfStation(hmdf->store());
+    station->setDate(this->_time);
+    station->setData(std::move(data[i]));
+    station->setLatitude(this->_yCoordinates[i]);
+    station->setLongitude(this->_xCoordinates[i]);
+    station->setStationIndex(i);
+    station->setId(QString::number(i));
+    station->setName(this->_stationNames[i]);
+    hmdf->addStation(station);
   }
+  hmdf->setSuccess(true);
+
   return MetOceanViewer::Error::NOERR;
 }
 
-int Dflow::getVariable(QString variable, int layer, Hmdf *hmdf) {
-  int i, ierr;
-  QVector<qint64> time;
-  QVector<QVector<double>> data;
+//...Lazy counterpart of getVariable. Only the station locations and names are
+//   added to the Hmdf and each station's series is read on demand through
+//   station()
+int Dflow::getStationList(QString variable, int layer, Hmdf *hmdf) {
+  int ierr;
+
+  this->_cache.clear();
+  this->_lazyVariable.clear();
 
-  ierr = this->_getTime(time);
+  ierr = this->_getTime();
   this->error->setErrorCode(ierr);
   if (this->error->isError()) return this->error->errorCode();
 
-  //...Check for derrived data or just retrieve the
-  //   requested variable
-  if (variable == QStringLiteral("2D_current_speed"))
-    ierr = this->_get2DVelocityMagnitude(layer, data);
-  else if (variable == QStringLiteral("2D_current_direction"))
-    ierr = this->_get2DVelocityDirection(layer, data);
-  else if (variable == QStringLiteral("3D_current_speed"))
-    ierr = this->_get3DVeloctiyMagnitude(layer, data);
-  else if (variable == QStringLiteral("wind_speed"))
-    ierr = this->_getWindVelocityMagnitude(data);
-  else if (variable == QStringLiteral("wind_direction"))
-    ierr = this->_getWindDirection(data);
-  else
-    ierr = this->_getVar(variable, layer, data);
-
-  if (ierr != MetOceanViewer::Error::NOERR) {
-    this->error->setErrorCode(ierr);
+  QString base;
+  LayerReduction reduction;
+  if (variable != QStringLiteral("2D_current_speed") &&
+      variable != QStringLiteral("2D_current_direction") &&
+      variable != QStringLiteral("3D_current_speed") &&
+      variable != QStringLiteral("wind_speed") &&
+      variable != QStringLiteral("wind_direction") &&
+      !this->_layerReduction(variable, base, reduction) &&
+      !this->_varnames.contains(variable)) {
+    this->error->setErrorCode(MetOceanViewer::Error::DFLOW_VARNOTFOUND);
     return this->error->errorCode();
   }
 
+  this->_lazyVariable = variable;
+  this->_lazyLayer = layer;
+
   hmdf->setSuccess(false);
   hmdf->setDatum("dflowfm_datum");
   hmdf->setHeader1("DFlowFM");
   hmdf->setHeader2("DFlowFM");
   hmdf->setHeader3("DFlowFM");
+  hmdf->store()->reserve(this->_nStations, 0);
 
-  for (i = 0; i < this->_nStations; i++) {
-    HmdfStation *station = new HmdfStation(hmdf);
-    station->setDate(time);
-    station->setData(data[i]);
+  for (int i = 0; i < this->_nStations; i++) {
+    HmdfStation *station = new HmdfStation(hmdf->store());
     station->setLatitude(this->_yCoordinates[i]);
     station->setLongitude(this->_xCoordinates[i]);
     station->setStationIndex(i);
     station->setId(QString::number(i));
     station->setName(this->_stationNames[i]);
+    station->setIsNull(false);
     hmdf->addStation(station);
   }
   hmdf->setSuccess(true);
@@ -254,10 +263,63 @@ int Dflow::getVariable(QString variable, int layer, Hmdf *hmdf) {
   return MetOceanViewer::Error::NOERR;
 }
 
-int Dflow::_init() {
+//...Returns the series of one station after getStationList(). The most
+//   recently used stations are kept in a cache. The returned station stays
+//   valid for as long as the caller holds it, even after it has been
+//   evicted. Returns a null pointer if the station cannot be read
+QSharedPointer<HmdfStation> Dflow::station(int index) {
+  if (this->_lazyVariable.isEmpty() || index < 0 ||
+      index >= this->_nStations)
+    return QSharedPointer<HmdfStation>();
+
+  QSharedPointer<HmdfStation> *cached = this->_cache.object(index);
+  if (cached) return *cached;
+
+  QVector<QVector<double>> data;
+  int ierr =
+      this->_getData(this->_lazyVariable, this->_lazyLayer, index, 1, data);
+  if (ierr != MetOceanViewer::Error::NOERR) {
+    this->error->setErrorCode(ierr);
+    return QSharedPointer<HmdfStation>();
+  }
+
+  QSharedPointer<HmdfStation> s(new HmdfStation());
+  s->setDate(this->_time);
+  s->setData(std::move(data[0]));
+  s->setLatitude(this->_yCoordinates[index]);
+  s->setLongitude(this->_xCoordinates[index]);
+  s->setStationIndex(index);
+  s->setId(QString::number(index));
+  s->setName(this->_stationNames[index]);
+  s->setIsNull(false);
+
+  //...A series larger than the whole cache is not cached
+  this->_cache.insert(index, new QSharedPointer<HmdfStation>(s),
+                      this->_nSteps);
+  return s;
+}
+
+void Dflow::_close() {
+  if (this->_ncid >= 0) nc_close(this->_ncid);
+  this->_ncid = -1;
+  this->_cache.clear();
+}
+
+//...The file is opened once and the handle is shared by every read made
+//   through this object
+int Dflow::_init(const FiletypeInfo &info) {
   int ierr;
 
-  ierr = this->_getPlottingVariables();
+  ierr = nc_open(this->_filename.toStdString().c_str(), NC_NOWRITE,
+                 &this->_ncid);
+  if (ierr != NC_NOERR) {
+    this->_ncid = -1;
+    this->error->setErrorCode(MetOceanViewer::Error::NETCDF);
+    this->error->setNcErrorCode(ierr);
+    return MetOceanViewer::Error::NETCDF;
+  }
+
+  ierr = this->_getPlottingVariables(info);
   if (ierr != MetOceanViewer::Error::NOERR) {
     this->error->setErrorCode(MetOceanViewer::Error::DFLOW_GETPLOTVARS);
     return this->error->errorCode();
@@ -272,10 +334,7 @@ int Dflow::_init() {
   return MetOceanViewer::Error::NOERR;
 }
 
-int Dflow::_get3d() {
-  int ierr, ncid;
-  size_t nLayers;
-
+int Dflow::_get3d(const FiletypeInfo &info) {
   if (this->_dimnames.contains("laydimw"))
     this->_is3d = true;
   else {
@@ -283,111 +342,45 @@ int Dflow::_get3d() {
     return MetOceanViewer::Error::NOERR;
   }
 
-  ierr = nc_open(this->_filename.toStdString().c_str(), NC_NOWRITE, &ncid);
-  if (ierr != NC_NOERR) {
-    this->error->setErrorCode(MetOceanViewer::Error::NETCDF);
-    this->error->setNcErrorCode(ierr);
-    return MetOceanViewer::Error::NETCDF;
-  }
-
-  ierr = nc_inq_dimlen(ncid, this->_dimnames["laydim"], &nLayers);
-  if (ierr != NC_NOERR) {
-    this->error->setErrorCode(MetOceanViewer::Error::NETCDF);
-    this->error->setNcErrorCode(ierr);
-    return MetOceanViewer::Error::NETCDF;
-  }
-
-  ierr = nc_close(ncid);
-  if (ierr != NC_NOERR) {
+  if (!this->_dimnames.contains("laydim")) {
     this->error->setErrorCode(MetOceanViewer::Error::NETCDF);
-    this->error->setNcErrorCode(ierr);
+    this->error->setNcErrorCode(NC_EBADDIM);
     return MetOceanViewer::Error::NETCDF;
   }
 
-  this->_nLayers = (int)nLayers;
+  this->_nLayers =
+      static_cast<int>(info.dimensionLengths.value(this->_dimnames["laydim"]));
 
   return MetOceanViewer::Error::NOERR;
 }
 
-int Dflow::_getPlottingVariables() {
-  int ncid, nvar, ndim;
+int Dflow::_getPlottingVariables(const FiletypeInfo &info) {
   int nd;
   int i, ierr;
   QString sname;
 
-  ierr = nc_open(this->_filename.toStdString().c_str(), NC_NOWRITE, &ncid);
-  this->error->setNcErrorCode(ierr);
-  if (this->error->isNcError()) {
-    this->error->setErrorCode(MetOceanViewer::Error::NETCDF);
-    return this->error->errorCode();
-  }
-
-  ierr = nc_inq_nvars(ncid, &nvar);
-  this->error->setNcErrorCode(ierr);
-  if (this->error->isNcError()) {
+  if (!info.isNetcdf) {
     this->error->setErrorCode(MetOceanViewer::Error::NETCDF);
-    ierr = nc_close(ncid);
     return this->error->errorCode();
   }
 
-  ierr = nc_inq_ndims(ncid, &ndim);
-  this->error->setNcErrorCode(ierr);
-  if (this->error->isNcError()) {
-    this->error->setErrorCode(MetOceanViewer::Error::NETCDF);
-    ierr = nc_close(ncid);
-    return this->error->errorCode();
-  }
-
-  char *varname = (char *)malloc(sizeof(char) * (NC_MAX_NAME + 1));
-  int *dims = (int *)malloc(sizeof(int) * NC_MAX_DIMS);
+  this->_dimnames = info.dimensions;
 
-  for (i = 0; i < ndim; i++) {
-    ierr = nc_inq_dimname(ncid, i, varname);
-    if (ierr != NC_NOERR) {
-      free(varname);
-      free(dims);
-      this->error->setErrorCode(MetOceanViewer::Error::NETCDF);
-      this->error->setNcErrorCode(ierr);
-      ierr = nc_close(ncid);
-      return MetOceanViewer::Error::NETCDF;
-    }
-    sname = QString(varname);
-    this->_dimnames[sname] = i;
-  }
+  //...Variables are listed in the order they appear in the file
+  int nvar = info.variableDimensions.size();
+  QVector<QString> names(nvar);
+  for (QMap<QString, int>::const_iterator it = info.variables.constBegin();
+       it != info.variables.constEnd(); ++it)
+    names[it.value()] = it.key();
 
   for (i = 0; i < nvar; i++) {
-    ierr = nc_inq_varname(ncid, i, varname);
-    if (ierr != NC_NOERR) {
-      free(varname);
-      free(dims);
-      this->error->setErrorCode(MetOceanViewer::Error::NETCDF);
-      this->error->setNcErrorCode(ierr);
-      ierr = nc_close(ncid);
-      return MetOceanViewer::Error::NETCDF;
-    }
-    sname = QString(varname);
-
-    ierr = nc_inq_varndims(ncid, i, &nd);
-    if (ierr != NC_NOERR) {
-      free(varname);
-      free(dims);
-      this->error->setErrorCode(MetOceanViewer::Error::NETCDF);
-      this->error->setNcErrorCode(ierr);
-      ierr = nc_close(ncid);
-      return MetOceanViewer::Error::NETCDF;
-    }
-
-    this->_nDims[sname] = (int)nd;
-
-    ierr = nc_inq_vardimid(ncid, i, dims);
-    if (ierr != NC_NOERR) {
-      free(varname);
-      free(dims);
-      this->error->setErrorCode(MetOceanViewer::Error::NETCDF);
-      this->error->setNcErrorCode(ierr);
-      ierr = nc_close(ncid);
-      return MetOceanViewer::Error::NETCDF;
-    }
+    sname = names[i];
+    const QVector<int> &dims = info.variableDimensions[i];
+    nd = dims.size();
+    this->_nDims[sname] = nd;
+    if (nd == 3)
+      this->_nVarLayers[sname] =
+          static_cast<int>(info.dimensionLengths.value(dims[2]));
 
     if (nd == 2) {
       if (dims[0] == this->_dimnames["time"] &&
@@ -406,21 +399,22 @@ int Dflow::_getPlottingVariables() {
     this->_varnames[sname] = i;
   }
 
-  free(varname);
-  free(dims);
-
-  ierr = nc_close(ncid);
-  if (ierr != NC_NOERR) {
-    this->error->setErrorCode(MetOceanViewer::Error::NETCDF);
-    this->error->setNcErrorCode(ierr);
-    return MetOceanViewer::Error::NETCDF;
-  }
-
-  ierr = this->_get3d();
+  ierr = this->_get3d(info);
   if (ierr != MetOceanViewer::Error::NOERR)
     return MetOceanViewer::Error::DFLOW_3DVARS;
 
   if (this->is3d()) {
+    //...Depth average, surface and bottom of every layered variable
+    QStringList layered;
+    for (int j = 0; j < this->_plotvarnames.size(); j++)
+      if (this->_nDims[this->_plotvarnames[j]] == 3)
+        layered.append(this->_plotvarnames[j]);
+    for (int j = 0; j < layered.size(); j++) {
+      this->_plotvarnames.append(layered[j] + "_depth_average");
+      this->_plotvarnames.append(layered[j] + "_surface");
+      this->_plotvarnames.append(layered[j] + "_bottom");
+    }
+
     if (this->_plotvarnames.contains("x_velocity") &&
         this->_plotvarnames.contains("y_velocity") &&
         this->_plotvarnames.contains("z_velocity"))
@@ -442,253 +436,350 @@ int Dflow::_getPlottingVariables() {
   return MetOceanViewer::Error::NOERR;
 }
 
-int Dflow::_getStations() {
-  int i;
-  size_t nstation, name_len;
-  std::vector<size_t> start, count;
-
-  NcFile file;
-  file.open(this->_filename.toStdString(), NcFile::read);
-  NcDim stationDimension = file.getDim("stations");
-  NcDim stationNameLength = file.getDim("name_len");
-  NcVar xvar = file.getVar("station_x_coordinate");
-  NcVar yvar = file.getVar("station_y_coordinate");
-  NcVar nameVar = file.getVar("station_name");
-
-  nstation = stationDimension.getSize();
-  this->_nStations = (int)nstation;
-  name_len = stationNameLength.getSize();
-  char *stationName = (char *)malloc(sizeof(char) * name_len);
-  double *xcoor = (double *)malloc(sizeof(double) * nstation);
-  double *ycoor = (double *)malloc(sizeof(double) * nstation);
-  this->_xCoordinates.resize(this->_nStations);
-  this->_yCoordinates.resize(this->_nStations);
-  this->_stationNames.resize(this->_nStations);
-
-  start.resize(2);
-  count.resize(2);
-  count[0] = 1;
-  count[1] = name_len;
-
-  for (i = 0; i < nstation; i++) {
-    start[0] = i;
-    start[1] = 0;
-    nameVar.getVar(start, count, stationName);
-    this->_stationNames[i] = QString(stationName);
-  }
-
-  start.resize(1);
-  count.resize(1);
-  start[0] = 0;
-  count[0] = nstation;
-
-  xvar.getVar(start, count, xcoor);
-  yvar.getVar(start, count, ycoor);
-
-  for (i = 0; i < this->_nStations; i++) {
-    this->_xCoordinates[i] = xcoor[i];
-    this->_yCoordinates[i] = ycoor[i];
+//...Splits a derived layer variable such as "salinity_depth_average" into
+//   the 3D variable it is computed from and the reduction to apply
+bool Dflow::_layerReduction(const QString &variable, QString &base,
+                            LayerReduction &reduction) {
+  static const struct {
+    const char *suffix;
+    LayerReduction reduction;
+  } suffixes[] = {{"_depth_average", DepthAverage},
+                  {"_surface", Surface},
+                  {"_bottom", Bottom}};
+
+  for (size_t i = 0; i < sizeof(suffixes) / sizeof(suffixes[0]); i++) {
+    QString suffix = QLatin1String(suffixes[i].suffix);
+    if (!variable.endsWith(suffix)) continue;
+    base = variable.left(variable.length() - suffix.length());
+    if (this->_nDims.value(base) != 3) continue;
+    reduction = suffixes[i].reduction;
+    return true;
   }
-
-  file.close();
-
-  free(xcoor);
-  free(ycoor);
-  free(stationName);
-
-  return 0;
+  return false;
 }
 
-int Dflow::_getTime(QVector<qint64> &timeList) {
-  int i, ierr, ncid;
-  size_t nsteps, unitsLen;
-  double *time;
-  char *refstring;
-  int varid_time = this->_varnames["time"];
-  int dimid_time = this->_dimnames["time"];
-  char *units = strdup("units");
-  QString refString;
+//...Reads the [time, station, layer] hyperslab for a range of stations and
+//   layers of a variable on the layer (or interface) dimension. Layers are
+//   zero based here
+int Dflow::_readLayerBlock(QString variable, int firstStation, int nStation,
+                           int firstLayer, int nLayer,
+                           std::vector<double> &d) {
+  size_t start[3] = {0, static_cast<size_t>(firstStation),
+                     static_cast<size_t>(firstLayer)};
+  size_t count[3] = {static_cast<size_t>(this->_nSteps),
+                     static_cast<size_t>(nStation),
+                     static_cast<size_t>(nLayer)};
+
+  if (!this->_varnames.contains(variable))
+    return MetOceanViewer::Error::DFLOW_VARNOTFOUND;
+  if (this->_nDims[variable] != 3)
+    return MetOceanViewer::Error::DFLOW_ILLEGALDIMENSION;
 
-  ierr = nc_open(this->_filename.toStdString().c_str(), NC_NOWRITE, &ncid);
+  d.resize(count[0] * count[1] * count[2]);
+
+  int ierr = nc_get_vara_double(this->_ncid, this->_varnames[variable], start,
+                                count, d.data());
   if (ierr != NC_NOERR) {
-    free(units);
     this->error->setErrorCode(MetOceanViewer::Error::NETCDF);
     this->error->setNcErrorCode(ierr);
     return MetOceanViewer::Error::NETCDF;
   }
+  return MetOceanViewer::Error::NOERR;
+}
 
-  ierr = nc_inq_dimlen(ncid, dimid_time, &nsteps);
-  if (ierr != NC_NOERR) {
-    free(units);
-    this->error->setErrorCode(MetOceanViewer::Error::NETCDF);
-    this->error->setNcErrorCode(ierr);
-    return MetOceanViewer::Error::NETCDF;
+//...Extracts a set of layers of a 3D variable for a set of stations. When
+//   the selection fits in memory it is read as one hyperslab covering the
+//   selected station and layer ranges, otherwise one hyperslab is read per
+//   station. Empty station or layer lists select all of them. Layers are
+//   numbered from 1 (bottom) to the length of the variable's own layer
+//   dimension (surface), which is getNumLayers() + 1 on laydimw
+int Dflow::getLayers(QString variable, QVector<int> stations,
+                     QVector<int> layers, DflowLayerBlock &block) {
+  int ierr = this->_getTime();
+  if (ierr != MetOceanViewer::Error::NOERR) return ierr;
+
+  if (!this->_varnames.contains(variable) || this->_nDims[variable] != 3) {
+    this->error->setErrorCode(MetOceanViewer::Error::DFLOW_ILLEGALDIMENSION);
+    return this->error->errorCode();
   }
 
-  ierr = nc_inq_attlen(ncid, varid_time, units, &unitsLen);
-  if (ierr != NC_NOERR) {
-    free(units);
-    this->error->setErrorCode(MetOceanViewer::Error::NETCDF);
-    this->error->setNcErrorCode(ierr);
-    return MetOceanViewer::Error::NETCDF;
+  if (stations.isEmpty())
+    for (int i = 0; i < this->_nStations; i++) stations.push_back(i);
+  int nLayers = this->_nVarLayers.value(variable);
+  if (layers.isEmpty())
+    for (int i = 1; i <= nLayers; i++) layers.push_back(i);
+
+  for (int i = 0; i < stations.size(); i++)
+    if (stations[i] < 0 || stations[i] >= this->_nStations) {
+      this->error->setErrorCode(MetOceanViewer::Error::DFLOW_GETSTATIONS);
+      return this->error->errorCode();
+    }
+  for (int i = 0; i < layers.size(); i++)
+    if (layers[i] < 1 || layers[i] > nLayers) {
+      this->error->setErrorCode(MetOceanViewer::Error::DFLOW_3DVARS);
+      return this->error->errorCode();
+    }
+
+  int s0 = *std::min_element(stations.begin(), stations.end());
+  int s1 = *std::max_element(stations.begin(), stations.end());
+  int l0 = *std::min_element(layers.begin(), layers.end()) - 1;
+  int l1 = *std::max_element(layers.begin(), layers.end()) - 1;
+  int ns = s1 - s0 + 1;
+  int nl = l1 - l0 + 1;
+
+  block.stations = stations;
+  block.layers = layers;
+  block.time = this->_time;
+  block.nSteps = this->_nSteps;
+  block.values.assign(static_cast<size_t>(stations.size()) * layers.size() *
+                          this->_nSteps,
+                      0.0);
+
+  size_t spanBytes =
+      static_cast<size_t>(this->_nSteps) * ns * nl * sizeof(double);
+  bool singleRead = spanBytes <= c_layerBlockBytes || stations.size() == 1;
+
+  std::vector<double> raw;
+  if (singleRead) {
+    ierr = this->_readLayerBlock(variable, s0, ns, l0, nl, raw);
+    if (ierr != MetOceanViewer::Error::NOERR) return ierr;
+  }
+
+  for (int s = 0; s < stations.size(); s++) {
+    int rawStation = stations[s] - s0;
+    int rawStations = ns;
+    if (!singleRead) {
+      ierr = this->_readLayerBlock(variable, stations[s], 1, l0, nl, raw);
+      if (ierr != MetOceanViewer::Error::NOERR) return ierr;
+      rawStation = 0;
+      rawStations = 1;
+    }
+    for (int l = 0; l < layers.size(); l++) {
+      int rawLayer = layers[l] - 1 - l0;
+      double *out = &block.values[(static_cast<size_t>(s) * layers.size() + l) *
+                                  this->_nSteps];
+      for (int t = 0; t < this->_nSteps; t++) {
+        double v = raw[(static_cast<size_t>(t) * rawStations + rawStation) *
+                           nl +
+                       rawLayer];
+        out[t] = v == c_fillValue ? MetOceanViewer::NULL_TS : v;
+      }
+    }
   }
 
-  refstring = (char *)malloc(sizeof(char) * unitsLen);
+  return MetOceanViewer::Error::NOERR;
+}
+
+//...Depth average, surface or bottom value of a 3D variable for n stations
+//   starting at first. Surface and bottom are the highest and lowest layers
+//   holding data, so z-layer models with dry layers are handled. The depth
+//   average is weighted by layer thickness from zcoordinate_w when the file
+//   has it, otherwise the layers are weighted equally
+int Dflow::_getLayerReduction(QString variable, LayerReduction reduction,
+                              int first, int n,
+                              QVector<QVector<double>> &data) {
+  int nl = this->_nLayers;
+  bool weighted = reduction == DepthAverage &&
+                  this->_varnames.contains(QStringLiteral("zcoordinate_w")) &&
+                  this->_nDims[QStringLiteral("zcoordinate_w")] == 3;
+
+  data.resize(n);
+  for (int j = 0; j < n; j++) data[j].resize(this->_nSteps);
+
+  //...Stations are processed in groups so that the layer block stays within
+  //   the memory budget
+  size_t stationBytes = static_cast<size_t>(this->_nSteps) * (nl + 1) *
+                        sizeof(double) * (weighted ? 2 : 1);
+  int groupSize = static_cast<int>(
+      qMax(c_layerBlockBytes / qMax(stationBytes, size_t(1)), size_t(1)));
+
+  std::vector<double> raw, zw;
+  for (int g = 0; g < n; g += groupSize) {
+    int ng = qMin(groupSize, n - g);
+    int ierr = this->_readLayerBlock(variable, first + g, ng, 0, nl, raw);
+    if (ierr == MetOceanViewer::Error::NOERR && weighted)
+      ierr = this->_readLayerBlock(QStringLiteral("zcoordinate_w"), first + g,
+                                   ng, 0, nl + 1, zw);
+    if (ierr != MetOceanViewer::Error::NOERR) return ierr;
+
+    for (int t = 0; t < this->_nSteps; t++) {
+      for (int j = 0; j < ng; j++) {
+        const double *v = &raw[(static_cast<size_t>(t) * ng + j) * nl];
+        const double *z =
+            weighted ? &zw[(static_cast<size_t>(t) * ng + j) * (nl + 1)]
+                     : nullptr;
+        double result = MetOceanViewer::NULL_TS;
+
+        if (reduction == Bottom) {
+          for (int k = 0; k < nl; k++)
+            if (v[k] != c_fillValue) {
+              result = v[k];
+              break;
+            }
+        } else if (reduction == Surface) {
+          for (int k = nl - 1; k >= 0; k--)
+            if (v[k] != c_fillValue) {
+              result = v[k];
+              break;
+            }
+        } else {
+          double sum = 0.0, weight = 0.0;
+          for (int k = 0; k < nl; k++) {
+            if (v[k] == c_fillValue) continue;
+            double w = 1.0;
+            if (z) {
+              if (z[k] == c_fillValue || z[k + 1] == c_fillValue) continue;
+              w = z[k + 1] - z[k];
+              if (w <= 0.0) continue;
+            }
+            sum += w * v[k];
+            weight += w;
+          }
+          if (weight > 0.0) result = sum / weight;
+        }
+        data[g + j][t] = result;
+      }
+    }
+  }
+  return MetOceanViewer::Error::NOERR;
+}
 
-  ierr = nc_get_att(ncid, varid_time, units, refstring);
+int Dflow::_getStations() {
+  int ierr, dimid_station, dimid_namelen, varid_x, varid_y, varid_name;
+  size_t nstation = 0, name_len = 0;
+
+  ierr = nc_inq_dimid(this->_ncid, "stations", &dimid_station);
+  if (ierr == NC_NOERR)
+    ierr = nc_inq_dimid(this->_ncid, "name_len", &dimid_namelen);
+  if (ierr == NC_NOERR)
+    ierr = nc_inq_dimlen(this->_ncid, dimid_station, &nstation);
+  if (ierr == NC_NOERR)
+    ierr = nc_inq_dimlen(this->_ncid, dimid_namelen, &name_len);
+  if (ierr == NC_NOERR)
+    ierr = nc_inq_varid(this->_ncid, "station_x_coordinate", &varid_x);
+  if (ierr == NC_NOERR)
+    ierr = nc_inq_varid(this->_ncid, "station_y_coordinate", &varid_y);
+  if (ierr == NC_NOERR)
+    ierr = nc_inq_varid(this->_ncid, "station_name", &varid_name);
   if (ierr != NC_NOERR) {
-    free(units);
-    free(refstring);
     this->error->setErrorCode(MetOceanViewer::Error::NETCDF);
     this->error->setNcErrorCode(ierr);
     return MetOceanViewer::Error::NETCDF;
   }
 
-  refString = QString(refstring);
-  refString = refString.mid(0, (int)unitsLen).right(19);
-  free(units);
-  free(refstring);
-
-  this->_refTime =
-      QDateTime::fromString(refString, QStringLiteral("yyyy-MM-dd hh:mm:ss"));
-  this->_refTime.setTimeSpec(Qt::UTC);
-
-  timeList.resize((int)nsteps);
-  time = (double *)malloc(sizeof(double) * nsteps);
-  this->_nSteps = (int)nsteps;
+  this->_nStations = (int)nstation;
+  this->_xCoordinates.resize(this->_nStations);
+  this->_yCoordinates.resize(this->_nStations);
+  this->_stationNames.resize(this->_nStations);
 
-  ierr = nc_get_var_double(ncid, varid_time, time);
+  //...Names, x and y are each read with a single call
+  std::vector<char> names(nstation * name_len);
+  ierr = nc_get_var_text(this->_ncid, varid_name, names.data());
+  if (ierr == NC_NOERR)
+    ierr = nc_get_var_double(this->_ncid, varid_x, this->_xCoordinates.data());
+  if (ierr == NC_NOERR)
+    ierr = nc_get_var_double(this->_ncid, varid_y, this->_yCoordinates.data());
   if (ierr != NC_NOERR) {
-    free(time);
     this->error->setErrorCode(MetOceanViewer::Error::NETCDF);
     this->error->setNcErrorCode(ierr);
     return MetOceanViewer::Error::NETCDF;
   }
 
-  for (i = 0; i < this->_nSteps; i++)
-    timeList[i] =
-        this->_refTime.addMSecs(qRound64(time[i] * 1000.0)).toMSecsSinceEpoch();
-
-  free(time);
+  for (int i = 0; i < this->_nStations; i++) {
+    const char *name = names.data() + i * name_len;
+    this->_stationNames[i] =
+        QString::fromLatin1(name, (int)strnlen(name, name_len));
+  }
 
   return MetOceanViewer::Error::NOERR;
 }
 
-int Dflow::_getVar(QString variable, int layer,
-                   QVector<QVector<double>> &data) {
-  if (this->_nDims[variable] == 2)
-    return this->_getVar2D(variable, data);
-  else if (this->_nDims[variable] == 3)
-    return this->_getVar3D(variable, layer, data);
-  else
-    return MetOceanViewer::Error::DFLOW_ILLEGALDIMENSION;
-}
-
-int Dflow::_getVar2D(QString variable, QVector<QVector<double>> &data) {
-  int i, j, ierr, ncid, varid;
-  double *d =
-      (double *)malloc(sizeof(double) * this->_nSteps * this->_nStations);
-  size_t *start = (size_t *)malloc(sizeof(size_t) * 2);
-  size_t *count = (size_t *)malloc(sizeof(size_t) * 2);
+//...The decoded time axis is cached, so it is only read once per file
+int Dflow::_getTime() {
+  int ierr;
+  size_t nsteps, unitsLen;
+  int varid_time = this->_varnames["time"];
+  int dimid_time = this->_dimnames["time"];
 
-  data.resize(this->_nStations);
-  for (i = 0; i < this->_nStations; i++) data[i].resize(this->_nSteps);
+  if (this->_hasTime) return MetOceanViewer::Error::NOERR;
 
-  varid = this->_varnames[variable];
-  ierr = nc_open(this->_filename.toStdString().c_str(), NC_NOWRITE, &ncid);
+  ierr = nc_inq_dimlen(this->_ncid, dimid_time, &nsteps);
+  if (ierr == NC_NOERR)
+    ierr = nc_inq_attlen(this->_ncid, varid_time, "units", &unitsLen);
   if (ierr != NC_NOERR) {
-    free(start);
-    free(count);
-    free(d);
     this->error->setErrorCode(MetOceanViewer::Error::NETCDF);
     this->error->setNcErrorCode(ierr);
     return MetOceanViewer::Error::NETCDF;
   }
 
-  start[0] = 0;
-  start[1] = 0;
-  count[0] = this->_nSteps;
-  count[1] = this->_nStations;
-  ierr = nc_get_vara_double(ncid, varid, start, count, d);
+  std::vector<char> units(unitsLen + 1, 0);
+  std::vector<double> time(nsteps);
+  ierr = nc_get_att_text(this->_ncid, varid_time, "units", units.data());
+  if (ierr == NC_NOERR)
+    ierr = nc_get_var_double(this->_ncid, varid_time, time.data());
   if (ierr != NC_NOERR) {
-    free(d);
-    free(start);
-    free(count);
     this->error->setErrorCode(MetOceanViewer::Error::NETCDF);
     this->error->setNcErrorCode(ierr);
     return MetOceanViewer::Error::NETCDF;
   }
 
-  for (i = 0; i < this->_nSteps; i++)
-    for (j = 0; j < this->_nStations; j++) {
-      if (d[i * this->_nStations + j] == -999.0)
-        data[j][i] = MetOceanViewer::NULL_TS;
-      else
-        data[j][i] = d[i * this->_nStations + j];
-    }
+  QString refString = QString(units.data()).mid(0, (int)unitsLen).right(19);
+  this->_refTime =
+      QDateTime::fromString(refString, QStringLiteral("yyyy-MM-dd hh:mm:ss"));
+  this->_refTime.setTimeSpec(Qt::UTC);
 
-  free(d);
-  free(start);
-  free(count);
+  this->_nSteps = (int)nsteps;
+  this->_time.resize(this->_nSteps);
 
-  ierr = nc_close(ncid);
-  if (ierr != NC_NOERR) {
-    this->error->setErrorCode(MetOceanViewer::Error::NETCDF);
-    this->error->setNcErrorCode(ierr);
-    return MetOceanViewer::Error::NETCDF;
-  }
+  qint64 refMsec = this->_refTime.toMSecsSinceEpoch();
+  for (int i = 0; i < this->_nSteps; i++)
+    this->_time[i] = refMsec + qRound64(time[i] * 1000.0);
 
+  this->_hasTime = true;
   return MetOceanViewer::Error::NOERR;
 }
 
-int Dflow::_getVar3D(QString variable, int layer,
-                     QVector<QVector<double>> &data) {
-  int i, j, ierr, ncid, varid;
-  double *d =
-      (double *)malloc(sizeof(double) * this->_nSteps * this->_nStations);
-  size_t *start = (size_t *)malloc(sizeof(size_t) * 3);
-  size_t *count = (size_t *)malloc(sizeof(size_t) * 3);
+int Dflow::_getVar(QString variable, int layer, int first, int n,
+                   QVector<QVector<double>> &data) {
+  std::vector<double> d;
 
-  data.resize(this->_nStations);
-  for (i = 0; i < this->_nStations; i++) data[i].resize(this->_nSteps);
+  int ierr = this->_readRaw(variable, layer, first, n, d);
+  if (ierr != MetOceanViewer::Error::NOERR) return ierr;
 
-  varid = this->_varnames[variable];
-  ierr = nc_open(this->_filename.toStdString().c_str(), NC_NOWRITE, &ncid);
-  if (ierr != NC_NOERR) {
-    free(d);
-    free(start);
-    free(count);
-    this->error->setErrorCode(MetOceanViewer::Error::NETCDF);
-    this->error->setNcErrorCode(ierr);
-    return MetOceanViewer::Error::NETCDF;
-  }
-
-  start[0] = 0;
-  start[1] = 0;
-  start[2] = layer - 1;
-  count[0] = this->_nSteps;
-  count[1] = this->_nStations;
-  count[2] = 1;
-  ierr = nc_get_vara_double(ncid, varid, start, count, d);
-  if (ierr != NC_NOERR) {
-    this->error->setErrorCode(MetOceanViewer::Error::NETCDF);
-    this->error->setNcErrorCode(ierr);
-    return MetOceanViewer::Error::NETCDF;
-  }
+  data.resize(n);
+  for (int j = 0; j < n; j++) data[j].resize(this->_nSteps);
 
-  for (i = 0; i < this->_nSteps; i++)
-    for (j = 0; j < this->_nStations; j++) {
-      if (d[i * this->_nStations + j] == -999.0)
-        data[j][i] = MetOceanViewer::NULL_TS;
-      else
-        data[j][i] = d[i * this->_nStations + j];
+  for (int i = 0; i < this->_nSteps; i++)
+    for (int j = 0; j < n; j++) {
+      double v = d[static_cast<size_t>(i) * n + j];
+      data[j][i] = v == c_fillValue ? MetOceanViewer::NULL_TS : v;
     }
 
-  free(d);
-  free(start);
-  free(count);
+  return MetOceanViewer::Error::NOERR;
+}
+
+//...Reads the [time, station] hyperslab of n stations starting at first,
+//   at one layer for 3D variables, without any conversion
+int Dflow::_readRaw(QString variable, int layer, int first, int n,
+                    std::vector<double> &d) {
+  size_t start[3] = {0, static_cast<size_t>(first),
+                     static_cast<size_t>(layer - 1)};
+  size_t count[3] = {static_cast<size_t>(this->_nSteps),
+                     static_cast<size_t>(n), 1};
+
+  if (!this->_varnames.contains(variable))
+    return MetOceanViewer::Error::DFLOW_VARNOTFOUND;
+
+  int nDims = this->_nDims[variable];
+  if (nDims == 2)
+    start[2] = 0;
+  else if (nDims != 3)
+    return MetOceanViewer::Error::DFLOW_ILLEGALDIMENSION;
+
+  d.resize(static_cast<size_t>(this->_nSteps) * n);
 
-  ierr = nc_close(ncid);
+  int ierr = nc_get_vara_double(this->_ncid, this->_varnames[variable], start,
+                                count, d.data());
   if (ierr != NC_NOERR) {
     this->error->setErrorCode(MetOceanViewer::Error::NETCDF);
     this->error->setNcErrorCode(ierr);
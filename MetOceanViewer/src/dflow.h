@@ -1,18 +1,41 @@
 #ifndef DFLOW_H
 #define DFLOW_H
 
+#include <QCache>
 #include <QDateTime>
 #include <QList>
 #include <QMap>
 #include <QObject>
 #include <QVector>
+#include <vector>
 #include "errors.h"
+#include "filetypes.h"
 #include "hmdf.h"
 
+//...Values of a 3D variable for a set of stations and layers. The values
+//   are stored station major, then layer, then time. value() takes
+//   positions in the stations and layers lists, not file indices
+struct DflowLayerBlock {
+  DflowLayerBlock() : nSteps(0) {}
+
+  QVector<int> stations;
+  QVector<int> layers;
+  QVector<qint64> time;
+  int nSteps;
+  std::vector<double> values;
+
+  double value(int station, int layer, int step) const {
+    return values[(static_cast<size_t>(station) * layers.size() + layer) *
+                      nSteps +
+                  step];
+  }
+};
+
 class Dflow : public QObject {
   Q_OBJECT
  public:
-  explicit Dflow(QString filename, QObject *parent = nullptr);
+  explicit Dflow(const FiletypeInfo &info, QObject *parent = nullptr);
+  ~Dflow();
 
   QStringList getVaribleList();
 
@@ -22,6 +45,13 @@ class Dflow : public QObject {
 
   int getVariable(QString variable, int layer, Hmdf *hmdf);
 
+  int getStationList(QString variable, int layer, Hmdf *hmdf);
+
+  QSharedPointer<HmdfStation> station(int index);
+
+  int getLayers(QString variable, QVector<int> stations, QVector<int> layers,
+                DflowLayerBlock &block);
+
   int getNumLayers();
 
   bool is3d();
@@ -31,30 +61,49 @@ class Dflow : public QObject {
   Errors *error;
 
  private:
-  int _init();
-  int _getPlottingVariables();
+  enum LayerReduction { DepthAverage, Surface, Bottom };
+
+  int _init(const FiletypeInfo &info);
+  int _getPlottingVariables(const FiletypeInfo &info);
   int _getStations();
-  int _get3d();
-  int _getTime(QVector<qint64> &timeList);
-  int _getVar(QString variable, int layer, QVector<QVector<double>> &data);
-  int _getVar2D(QString variable, QVector<QVector<double>> &data);
-  int _getVar3D(QString variable, int layer, QVector<QVector<double>> &data);
-  int _get2DVelocityMagnitude(int layer, QVector<QVector<double>> &data);
-  int _get2DVelocityDirection(int layer, QVector<QVector<double>> &data);
-  int _get3DVeloctiyMagnitude(int layer, QVector<QVector<double>> &data);
-  int _getWindVelocityMagnitude(QVector<QVector<double>> &data);
-  int _getWindDirection(QVector<QVector<double>> &data);
+  int _get3d(const FiletypeInfo &info);
+  int _getTime();
+  int _getData(QString variable, int layer, int first, int n,
+               QVector<QVector<double>> &data);
+  int _getVar(QString variable, int layer, int first, int n,
+              QVector<QVector<double>> &data);
+  int _readRaw(QString variable, int layer, int first, int n,
+               std::vector<double> &d);
+  int _getMagnitude(const QStringList &components, int layer, int first,
+                    int n, QVector<QVector<double>> &data);
+  int _getDirection(const QString &xComponent, const QString &yComponent,
+                    int layer, int first, int n,
+                    QVector<QVector<double>> &data);
+  bool _layerReduction(const QString &variable, QString &base,
+                       LayerReduction &reduction);
+  int _readLayerBlock(QString variable, int firstStation, int nStation,
+                      int firstLayer, int nLayer, std::vector<double> &d);
+  int _getLayerReduction(QString variable, LayerReduction reduction,
+                         int first, int n, QVector<QVector<double>> &data);
+  void _close();
 
   bool _isInitialized;
   bool _readError;
   bool _is3d;
+  bool _hasTime;
   int _nStations;
   int _nSteps;
   int _nLayers;
+  int _ncid;
+  int _lazyLayer;
+  QString _lazyVariable;
+  QVector<qint64> _time;
+  QCache<int, QSharedPointer<HmdfStation>> _cache;
   QString _filename;
   QMap<QString, int> _varnames;
   QMap<QString, int> _dimnames;
   QMap<QString, int> _nDims;
+  QMap<QString, int> _nVarLayers;
   QList<QString> _plotvarnames;
   QVector<double> _xCoordinates;
   QVector<double> _yCoordinates;
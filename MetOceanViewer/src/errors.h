@@ -24,6 +24,7 @@
 #include <QObject>
 #include "metoceanviewer.h"
 
+//...Views with more stations than this are drawn as clusters
 #define MAX_NUM_DISPLAYED_STATIONS 500
 
 class Errors : public QObject {
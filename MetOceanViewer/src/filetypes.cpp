@@ -1,7 +1,13 @@
 #include "filetypes.h"
+#include <QFile>
 #include <QFileInfo>
+#include <QHash>
 #include <QMap>
+#include <QMutex>
+#include <cstring>
+#include <string>
 #include "netcdf.h"
+#include "netcdftimeseries.h"
 
 static QMap<QString, int> filetypeMapString = {
     {QStringLiteral("NETCDF-ADCIRC"), MetOceanViewer::FileType::NETCDF_ADCIRC},
@@ -22,130 +28,159 @@ static QMap<int, QString> filetypeMapInt = {
 Filetypes::Filetypes(QObject *parent) : QObject(parent) {}
 
 int Filetypes::getIntegerFiletype(QString filename) {
-  if (Filetypes::_checkNetcdfGeneric(filename))
-    return MetOceanViewer::FileType::NETCDF_GENERIC;
-  if (Filetypes::_checkNetcdfAdcirc(filename))
-    return MetOceanViewer::FileType::NETCDF_ADCIRC;
-  if (Filetypes::_checkNetcdfDflow(filename))
-    return MetOceanViewer::FileType::NETCDF_DFLOW;
-  if (Filetypes::_checkASCIIImeds(filename))
-    return MetOceanViewer::FileType::ASCII_IMEDS;
-  if (Filetypes::_checkASCIIAdcirc(filename))
-    return MetOceanViewer::FileType::ASCII_ADCIRC;
-  return MetOceanViewer::FileType::FILETYPE_ERROR;
+  return Filetypes::getFiletypeInfo(filename).filetype;
 }
 
 QString Filetypes::getStringFiletype(QString filename) {
-  if (Filetypes::_checkNetcdfGeneric(filename))
-    return QStringLiteral("NETCDF-GENERIC");
-  if (Filetypes::_checkNetcdfAdcirc(filename))
-    return QStringLiteral("NETCDF-ADCIRC");
-  if (Filetypes::_checkNetcdfDflow(filename))
-    return QStringLiteral("NETCDf-DFLOW");
-  if (Filetypes::_checkASCIIAdcirc(filename))
-    return QStringLiteral("ASCII-ADCIRC");
-  if (Filetypes::_checkASCIIImeds(filename))
-    return QStringLiteral("ASCII-IMEDS");
-  return QStringLiteral("ERROR");
+  int filetype = Filetypes::getIntegerFiletype(filename);
+  if (filetype == MetOceanViewer::FileType::FILETYPE_ERROR)
+    return QStringLiteral("ERROR");
+  return Filetypes::integerFiletypeToString(filetype);
 }
 
-bool Filetypes::_checkNetcdfAdcirc(QString filename) {
-  int ncid, ierr;
-  size_t attlen;
-  char *attname = strdup("model");
-  char *model;
-  QString models;
+//...Detected types are cached per file and reused as long as the file's
+//   size and modification time are unchanged, so the dialog and the
+//   readers that follow it only pay for detection once
+FiletypeInfo Filetypes::getFiletypeInfo(QString filename) {
+  static QHash<QString, FiletypeInfo> cache;
+  static QMutex cacheMutex;
 
-  ierr = nc_open(filename.toStdString().c_str(), NC_NOWRITE, &ncid);
-  if (ierr != 0) {
-    free(attname);
-    return false;
+  QFileInfo file(filename);
+  QString key = file.absoluteFilePath();
+  qint64 size = file.size();
+  QDateTime lastModified = file.lastModified();
+
+  {
+    QMutexLocker lock(&cacheMutex);
+    QHash<QString, FiletypeInfo>::const_iterator it = cache.constFind(key);
+    if (it != cache.constEnd() && it->size == size &&
+        it->lastModified == lastModified) {
+      FiletypeInfo info = it.value();
+      info.filename = filename;
+      return info;
+    }
   }
 
-  ierr = nc_inq_attlen(ncid, NC_GLOBAL, attname, &attlen);
-  if (ierr != 0) {
-    free(attname);
-    ierr = nc_close(ncid);
-    return false;
+  FiletypeInfo info = Filetypes::_sniff(filename);
+  info.filename = filename;
+  info.size = size;
+  info.lastModified = lastModified;
+
+  if (info.filetype != MetOceanViewer::FileType::FILETYPE_ERROR) {
+    QMutexLocker lock(&cacheMutex);
+    cache.insert(key, info);
   }
+  return info;
+}
 
-  model = (char *)malloc(sizeof(char) * attlen);
-  ierr = nc_get_att(ncid, NC_GLOBAL, attname, model);
-  if (ierr != 0) {
-    free(attname);
-    free(model);
-    nc_close(ncid);
-    return false;
+//...Files that start with a netCDF or HDF5 signature are opened once to
+//   tell the netCDF formats apart. Anything else is only classified by its
+//   suffix
+FiletypeInfo Filetypes::_sniff(const QString &filename) {
+  FiletypeInfo info;
+
+  if (Filetypes::_hasNetcdfSignature(filename)) {
+    Filetypes::_readNetcdfMetadata(filename, info);
+    return info;
   }
-  nc_close(ncid);
 
-  models = QString(model).mid(0, (int)attlen);
+  QString suffix = QFileInfo(filename).suffix();
+  if (suffix.toUpper() == QStringLiteral("IMEDS"))
+    info.filetype = MetOceanViewer::FileType::ASCII_IMEDS;
+  else if (suffix == "61" || suffix == "62" || suffix == "71" ||
+           suffix == "72")
+    info.filetype = MetOceanViewer::FileType::ASCII_ADCIRC;
+  return info;
+}
 
-  free(attname);
-  free(model);
+//...Classic, 64-bit offset and CDF-5 files start with their signature. The
+//   HDF5 signature of a netCDF-4 file may follow a user block, so it is also
+//   looked for at 512 bytes and each doubling of that offset
+bool Filetypes::_hasNetcdfSignature(const QString &filename) {
+  QFile file(filename);
+  if (!file.open(QIODevice::ReadOnly)) return false;
 
-  if (models == QStringLiteral("ADCIRC"))
+  QByteArray magic = file.read(8);
+  if (magic.startsWith("CDF\x01") || magic.startsWith("CDF\x02") ||
+      magic.startsWith("CDF\x05"))
     return true;
-  else
-    return false;
+
+  const QByteArray hdf5("\x89HDF\r\n\x1a\n", 8);
+  for (qint64 offset = 0; offset + 8 <= file.size();
+       offset = offset == 0 ? 512 : offset * 2) {
+    if (offset > 0) {
+      if (!file.seek(offset)) return false;
+      magic = file.read(8);
+    }
+    if (magic == hdf5) return true;
+  }
+  return false;
 }
 
-bool Filetypes::_checkNetcdfDflow(QString filename) {
-  int ierr, ncid;
-  int varid_stationx, varid_stationy;
-  char *varname_stationx = strdup("station_x_coordinate");
-  char *varname_stationy = strdup("station_y_coordinate");
+//...Reads the whole schema in the single nc_open made while detecting
+bool Filetypes::_readNetcdfMetadata(const QString &filename,
+                                    FiletypeInfo &info) {
+  int ncid, nvar, ndim, nd;
+  size_t len;
+  char name[NC_MAX_NAME + 1];
 
-  ierr = nc_open(filename.toStdString().c_str(), NC_NOWRITE, &ncid);
-  if (ierr != 0) {
-    free(varname_stationx);
-    free(varname_stationy);
+  if (nc_open(filename.toStdString().c_str(), NC_NOWRITE, &ncid) != NC_NOERR)
     return false;
-  }
 
-  ierr = nc_inq_varid(ncid, varname_stationx, &varid_stationx);
-  if (ierr != 0) {
-    free(varname_stationx);
-    free(varname_stationy);
-    ierr = nc_close(ncid);
+  if (nc_inq_nvars(ncid, &nvar) != NC_NOERR ||
+      nc_inq_ndims(ncid, &ndim) != NC_NOERR) {
+    nc_close(ncid);
     return false;
   }
 
-  ierr = nc_inq_varid(ncid, varname_stationy, &varid_stationy);
-  if (ierr != 0) {
-    free(varname_stationx);
-    free(varname_stationy);
-    ierr = nc_close(ncid);
-    return false;
-  }
+  info.isNetcdf = true;
 
-  ierr = nc_close(ncid);
+  info.dimensionLengths.resize(ndim);
+  for (int i = 0; i < ndim; i++) {
+    if (nc_inq_dim(ncid, i, name, &len) != NC_NOERR) continue;
+    info.dimensions.insert(QString(name), i);
+    info.dimensionLengths[i] = len;
+  }
 
-  return true;
-}
+  info.variableDimensions.resize(nvar);
+  for (int i = 0; i < nvar; i++) {
+    if (nc_inq_varname(ncid, i, name) != NC_NOERR ||
+        nc_inq_varndims(ncid, i, &nd) != NC_NOERR)
+      continue;
+    info.variables.insert(QString(name), i);
+    info.variableDimensions[i].resize(nd);
+    if (nd > 0) nc_inq_vardimid(ncid, i, info.variableDimensions[i].data());
+  }
 
-bool Filetypes::_checkASCIIAdcirc(QString filename) {
-  QFileInfo file(filename);
-  QString suffix = file.suffix();
-  if (suffix == "61" || suffix == "62" || suffix == "71" || suffix == "72")
-    return true;
-  return false;
-}
+  const char *attributes[] = {"model", "fileformat"};
+  QString *values[] = {&info.model, &info.fileformat};
+  for (int i = 0; i < 2; i++) {
+    nc_type type;
+    if (nc_inq_att(ncid, NC_GLOBAL, attributes[i], &type, &len) != NC_NOERR ||
+        type != NC_CHAR)
+      continue;
+    std::string text(len, '\0');
+    if (nc_get_att_text(ncid, NC_GLOBAL, attributes[i], &text[0]) == NC_NOERR)
+      *values[i] = QString::fromStdString(text).left(
+          static_cast<int>(strnlen(text.c_str(), len)));
+  }
 
-bool Filetypes::_checkASCIIImeds(QString filename) {
-  QFileInfo file(filename);
-  QString suffix = file.suffix().toUpper();
-  if (suffix == "IMEDS") return true;
-  return false;
-}
+  if (NetcdfTimeseries::isHmdfNetcdf(ncid)) {
+    info.filetype = MetOceanViewer::FileType::NETCDF_GENERIC;
+    int epsg;
+    if (info.variables.contains(QStringLiteral("stationXCoordinate")) &&
+        nc_get_att_int(ncid,
+                       info.variables[QStringLiteral("stationXCoordinate")],
+                       "HorizontalProjectionEPSG", &epsg) == NC_NOERR)
+      info.epsg = epsg;
+  } else if (info.model == QStringLiteral("ADCIRC")) {
+    info.filetype = MetOceanViewer::FileType::NETCDF_ADCIRC;
+  } else if (info.variables.contains(QStringLiteral("station_x_coordinate")) &&
+             info.variables.contains(QStringLiteral("station_y_coordinate"))) {
+    info.filetype = MetOceanViewer::FileType::NETCDF_DFLOW;
+  }
 
-bool Filetypes::_checkNetcdfGeneric(QString filename) {
-  int ierr, ncid, varid;
-  ierr = nc_open(filename.toStdString().c_str(), NC_NOWRITE, &ncid);
-  if (ierr != 0) return false;
-  ierr = nc_inq_varid(ncid, "time_station_0001", &varid);
   nc_close(ncid);
-  if (ierr != 0) return false;
   return true;
 }
 
@@ -1,9 +1,43 @@
 #ifndef FILETYPES_H
 #define FILETYPES_H
 
+#include <QDateTime>
+#include <QMap>
 #include <QObject>
+#include <QVector>
 #include "metoceanviewer.h"
 
+//...Result of detecting a file's type. For netCDF files the schema read
+//   while detecting is kept so the reader that follows does not have to
+//   query it again. Ids stay valid for any later nc_open of the same file
+//   as long as it is unchanged
+struct FiletypeInfo {
+  FiletypeInfo()
+      : filetype(MetOceanViewer::FileType::FILETYPE_ERROR),
+        isNetcdf(false),
+        epsg(-1),
+        size(-1) {}
+
+  QString filename;
+  int filetype;
+  bool isNetcdf;
+  QString model;
+  QString fileformat;
+
+  //...Projection of an HMDF netCDF file, -1 when not given
+  int epsg;
+
+  //...Dimension ids and variable ids by name, the length of each dimension
+  //   and the dimension ids of each variable, indexed by id
+  QMap<QString, int> dimensions;
+  QMap<QString, int> variables;
+  QVector<size_t> dimensionLengths;
+  QVector<QVector<int>> variableDimensions;
+
+  qint64 size;
+  QDateTime lastModified;
+};
+
 class Filetypes : public QObject {
   Q_OBJECT
 public:
@@ -12,13 +46,12 @@ public:
   static int getIntegerFiletype(QString filename);
   static QString getStringFiletype(QString filename);
   static QString integerFiletypeToString(int filetype);
+  static FiletypeInfo getFiletypeInfo(QString filename);
 
 private:
-  static bool _checkNetcdfAdcirc(QString filename);
-  static bool _checkNetcdfDflow(QString filename);
-  static bool _checkASCIIAdcirc(QString filename);
-  static bool _checkASCIIImeds(QString filename);
-  static bool _checkNetcdfGeneric(QString filename);
+  static FiletypeInfo _sniff(const QString &filename);
+  static bool _hasNetcdfSignature(const QString &filename);
+  static bool _readNetcdfMetadata(const QString &filename, FiletypeInfo &info);
 };
 
 #endif // FILETYPES_H
@@ -206,7 +206,7 @@ int Hwm::plotRegression() {
   this->m_chartView->setAxisLimits(min, max, min, max);
 
   for (int i = 0; i < 8; i++) {
-    this->m_chartView->chart()->addSeries(scatterSeries[i]);
+    this->m_chartView->addStaticSeries(scatterSeries[i]);
     scatterSeries[i]->attachAxis(this->m_chartView->xAxis());
     scatterSeries[i]->attachAxis(this->m_chartView->yAxis());
     scatterSeries[i]->setName(tr("High Water Marks"));
@@ -221,7 +221,7 @@ int Hwm::plotRegression() {
   One2OneLine->append(-1000, -1000);
   One2OneLine->append(1000, 1000);
   One2OneLine->setPen(QPen(QBrush(One2OneColor), 3));
-  this->m_chartView->chart()->addSeries(One2OneLine);
+  this->m_chartView->addStaticSeries(One2OneLine);
   One2OneLine->attachAxis(this->m_chartView->xAxis());
   One2OneLine->attachAxis(this->m_chartView->yAxis());
   One2OneLine->setName("1:1 Line");
@@ -233,7 +233,7 @@ int Hwm::plotRegression() {
   RegressionLine->append(
       1000, this->m_hwm->slope() * 1000 + this->m_hwm->intercept());
   RegressionLine->setPen(QPen(QBrush(RegColor), 3));
-  this->m_chartView->chart()->addSeries(RegressionLine);
+  this->m_chartView->addStaticSeries(RegressionLine);
   RegressionLine->attachAxis(this->m_chartView->xAxis());
   RegressionLine->attachAxis(this->m_chartView->yAxis());
   RegressionLine->setName(tr("Regression Line"));
@@ -245,7 +245,7 @@ int Hwm::plotRegression() {
     UpperBoundLine->append(-1000, -1000 + boundValue);
     UpperBoundLine->append(1000, 1000 + boundValue);
     UpperBoundLine->setPen(QPen(QBrush(BoundColor), 3));
-    this->m_chartView->chart()->addSeries(UpperBoundLine);
+    this->m_chartView->addStaticSeries(UpperBoundLine);
     UpperBoundLine->attachAxis(this->m_chartView->xAxis());
     UpperBoundLine->attachAxis(this->m_chartView->yAxis());
     UpperBoundLine->setName(tr("Standard Deviation Interval"));
@@ -255,7 +255,7 @@ int Hwm::plotRegression() {
     LowerBoundLine->append(-1000, -1000 - boundValue);
     LowerBoundLine->append(1000, 1000 - boundValue);
     LowerBoundLine->setPen(QPen(QBrush(BoundColor), 3));
-    this->m_chartView->chart()->addSeries(LowerBoundLine);
+    this->m_chartView->addStaticSeries(LowerBoundLine);
     LowerBoundLine->attachAxis(this->m_chartView->xAxis());
     LowerBoundLine->attachAxis(this->m_chartView->yAxis());
     LowerBoundLine->setName(tr("Standard Deviation Interval"));
@@ -396,7 +396,7 @@ int Hwm::saveRegressionPlot(QString outputFile, QString filter) {
     painter.setRenderHint(QPainter::Antialiasing, true);
     painter.begin(&printer);
 
-    this->m_chartView->render(&painter);
+    this->m_chartView->renderChart(&painter);
 
     painter.end();
   } else if (filter == "JPG (*.jpg *.jpeg)") {
@@ -412,7 +412,7 @@ int Hwm::saveRegressionPlot(QString outputFile, QString filter) {
     imagePainter.setRenderHints(QPainter::Antialiasing |
                                 QPainter::TextAntialiasing |
                                 QPainter::SmoothPixmapTransform);
-    this->m_chartView->render(&imagePainter, chartRect);
+    this->m_chartView->renderChart(&imagePainter, chartRect);
 
     output.open(QIODevice::WriteOnly);
     pixmap.save(&output, "JPG", 100);
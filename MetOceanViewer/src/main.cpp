@@ -23,6 +23,14 @@
 #include "mainwindow.h"
 
 int main(int argc, char *argv[]) {
+  //...Accelerated charts can be forced onto a software OpenGL
+  //   implementation (llvmpipe with Mesa) for machines without a usable
+  //   GPU driver or for headless use
+  if (qEnvironmentVariableIsSet("METOCEANVIEWER_SOFTWARE_OPENGL")) {
+    QCoreApplication::setAttribute(Qt::AA_UseSoftwareOpenGL);
+    qputenv("LIBGL_ALWAYS_SOFTWARE", "1");
+  }
+
   QApplication a(argc, argv);
   QString sessionFile;
   bool doSession;
@@ -325,9 +325,13 @@ void MainWindow::setupNoaaMap() {
   this->mapFunctions->setMapQmlFile(ui->quick_noaaMap);
   this->noaaMarkerLocations =
       StationLocations::readMarkers(StationLocations::NOAA);
+  this->noaaMarkerIndex = StationLocations::markerIndex(StationLocations::NOAA);
+  this->noaaMarkerClusters.build(this->noaaMarkerLocations);
   QObject *noaaItem = ui->quick_noaaMap->rootObject();
   QObject::connect(noaaItem, SIGNAL(markerChanged(QString)), this,
                    SLOT(changeNoaaMarker(QString)));
+  QObject::connect(noaaItem, SIGNAL(viewChanged()), this,
+                   SLOT(on_button_refreshNoaaStations_clicked()));
   ui->Date_StartTime->setDateTime(QDateTime::currentDateTimeUtc().addDays(-1));
   ui->Date_EndTime->setDateTime(QDateTime::currentDateTimeUtc());
 
@@ -359,6 +363,8 @@ void MainWindow::setupNdbcMap() {
   this->mapFunctions->setMapQmlFile(ui->quick_ndbcMap);
   this->ndbcMarkerLocations =
       StationLocations::readMarkers(StationLocations::NDBC);
+  this->ndbcMarkerIndex = StationLocations::markerIndex(StationLocations::NDBC);
+  this->ndbcMarkerClusters.build(this->ndbcMarkerLocations);
   QObject *ndbcItem = ui->quick_ndbcMap->rootObject();
   QObject::connect(ndbcItem, SIGNAL(markerChanged(QString)), this,
                    SLOT(changeNdbcMarker(QString)));
@@ -371,7 +377,9 @@ void MainWindow::setupNdbcMap() {
                             Q_ARG(QVariant, 1.69));
 
   this->mapFunctions->refreshMarkers(this->ndbcStationModel, ui->quick_ndbcMap,
-                                     this->ndbcMarkerLocations, false, true);
+                                     this->ndbcMarkerLocations,
+                                     this->ndbcMarkerIndex,
+                                     this->ndbcMarkerClusters, false, true);
 
   return;
 }
@@ -397,6 +405,8 @@ void MainWindow::setupUsgsMap() {
   this->setupMarkerClasses(ui->quick_usgsMap);
   this->usgsMarkerLocations =
       StationLocations::readMarkers(StationLocations::USGS);
+  this->usgsMarkerIndex = StationLocations::markerIndex(StationLocations::USGS);
+  this->usgsMarkerClusters.build(this->usgsMarkerLocations);
   this->mapFunctions->setMapTypes(ui->combo_usgs_maptype);
   ui->combo_usgs_maptype->setCurrentIndex(
       this->mapFunctions->getDefaultMapIndex());
@@ -406,6 +416,8 @@ void MainWindow::setupUsgsMap() {
   QObject *usgsItem = ui->quick_usgsMap->rootObject();
   QObject::connect(usgsItem, SIGNAL(markerChanged(QString)), this,
                    SLOT(changeUsgsMarker(QString)));
+  QObject::connect(usgsItem, SIGNAL(viewChanged()), this,
+                   SLOT(on_button_refreshUsgsStations_clicked()));
   QMetaObject::invokeMethod(usgsItem, "setMapLocation",
                             Q_ARG(QVariant, -124.66), Q_ARG(QVariant, 36.88),
                             Q_ARG(QVariant, 1.69));
@@ -428,6 +440,9 @@ void MainWindow::setupXTideMap() {
   this->setupMarkerClasses(ui->quick_xtideMap);
   this->xtideMarkerLocations =
       StationLocations::readMarkers(StationLocations::XTIDE);
+  this->xtideMarkerIndex =
+      StationLocations::markerIndex(StationLocations::XTIDE);
+  this->xtideMarkerClusters.build(this->xtideMarkerLocations);
   this->mapFunctions->setMapTypes(ui->combo_xtide_maptype);
   ui->combo_xtide_maptype->setCurrentIndex(
       this->mapFunctions->getDefaultMapIndex());
@@ -437,6 +452,8 @@ void MainWindow::setupXTideMap() {
   QObject *xtideItem = ui->quick_xtideMap->rootObject();
   QObject::connect(xtideItem, SIGNAL(markerChanged(QString)), this,
                    SLOT(changeXtideMarker(QString)));
+  QObject::connect(xtideItem, SIGNAL(viewChanged()), this,
+                   SLOT(on_button_refreshXtideStations_clicked()));
   QMetaObject::invokeMethod(xtideItem, "setMapLocation",
                             Q_ARG(QVariant, -124.66), Q_ARG(QVariant, 36.88),
                             Q_ARG(QVariant, 1.69));
@@ -639,38 +656,24 @@ void MainWindow::on_button_hwmDisplayValues_toggled(bool checked) {
 }
 
 void MainWindow::on_button_refreshUsgsStations_clicked() {
-  int n = this->mapFunctions->refreshMarkers(
+  this->mapFunctions->refreshMarkers(
       this->usgsStationModel, ui->quick_usgsMap, this->usgsMarkerLocations,
-      true, true);
-  this->stationDisplayWarning(n);
+      this->usgsMarkerIndex, this->usgsMarkerClusters, true, true);
   return;
 }
 
 void MainWindow::on_button_refreshNoaaStations_clicked() {
   bool active = ui->check_noaaActiveOnly->isChecked();
-  int n = this->mapFunctions->refreshMarkers(
+  this->mapFunctions->refreshMarkers(
       this->noaaStationModel, ui->quick_noaaMap, this->noaaMarkerLocations,
-      true, active);
-  this->stationDisplayWarning(n);
+      this->noaaMarkerIndex, this->noaaMarkerClusters, true, active);
   return;
 }
 
 void MainWindow::on_button_refreshXtideStations_clicked() {
-  int n = this->mapFunctions->refreshMarkers(
+  this->mapFunctions->refreshMarkers(
       this->xtideStationModel, ui->quick_xtideMap, this->xtideMarkerLocations,
-      true, true);
-  this->stationDisplayWarning(n);
-  return;
-}
-
-void MainWindow::stationDisplayWarning(int n) {
-  if (n > MAX_NUM_DISPLAYED_STATIONS) {
-    QMessageBox::critical(this, "Error",
-                          QString::number(n) +
-                              " stations in current view (max: " +
-                              QString::number(MAX_NUM_DISPLAYED_STATIONS) +
-                              "). Zoom in and try again.");
-  }
+      this->xtideMarkerIndex, this->xtideMarkerClusters, true, true);
   return;
 }
 
@@ -692,6 +695,16 @@ void MainWindow::on_actionOpenStreetMap_toggled(bool arg1) {
   return;
 }
 
+void MainWindow::on_actionAccelerated_Charts_toggled(bool arg1) {
+  ui->noaa_graphics->setUseOpenGL(arg1);
+  ui->usgs_graphics->setUseOpenGL(arg1);
+  ui->ndbc_graphics->setUseOpenGL(arg1);
+  ui->xtide_graphics->setUseOpenGL(arg1);
+  ui->timeseries_graphics->setUseOpenGL(arg1);
+  ui->graphics_hwm->setUseOpenGL(arg1);
+  return;
+}
+
 void MainWindow::on_actionMapBox_toggled(bool arg1) {
   if (!this->initialized) return;
   if (arg1) this->resetMapSource(MapFunctions::MapSource::MapBox);
@@ -234,6 +234,8 @@ class MainWindow : public QMainWindow {
 
   void on_actionOpenStreetMap_toggled(bool arg1);
 
+  void on_actionAccelerated_Charts_toggled(bool arg1);
+
   void on_button_fetchndbc_clicked();
 
   void on_combo_ndbcproduct_currentIndexChanged(int index);
@@ -294,8 +296,6 @@ class MainWindow : public QMainWindow {
 
   void plotXTideStation();
 
-  void stationDisplayWarning(int n);
-
   void setTimeseriesTableRow(int row, AddTimeseriesDialog *dialog);
 
   void resetMapSource(MapFunctions::MapSource source);
@@ -341,6 +341,16 @@ class MainWindow : public QMainWindow {
   QVector<Station> noaaMarkerLocations;
   QVector<Station> usgsMarkerLocations;
 
+  StationIndex xtideMarkerIndex;
+  StationIndex ndbcMarkerIndex;
+  StationIndex noaaMarkerIndex;
+  StationIndex usgsMarkerIndex;
+
+  StationClusters xtideMarkerClusters;
+  StationClusters ndbcMarkerClusters;
+  StationClusters noaaMarkerClusters;
+  StationClusters usgsMarkerClusters;
+
   QString noaaSelectedStation;
   QString ndbcSelectedStation;
   QString usgsSelectedStation;
@@ -71,11 +71,10 @@ MapFunctions::MapFunctions(QObject *parent) : QObject(parent) {
 }
 
 int MapFunctions::refreshMarkers(StationModel *model, QQuickWidget *map,
-                                 QVector<Station> &locations, bool filter,
-                                 bool activeOnly) {
-  //...Clear current markers
-  model->clear();
-
+                                 QVector<Station> &locations,
+                                 const StationIndex &index,
+                                 const StationClusters &clusters,
+                                 bool filter, bool activeOnly) {
   if (filter) {
     //...Get the bounding area
     QVariant var;
@@ -84,46 +83,41 @@ int MapFunctions::refreshMarkers(StationModel *model, QQuickWidget *map,
     QGeoShape visibleRegion = qvariant_cast<QGeoShape>(var);
     QGeoRectangle boundingBox = visibleRegion.boundingGeoRectangle();
 
-    //...Get coordinates
+    //...Get coordinates. The box runs east from the left edge to the
+    //   right edge, so a view across the antimeridian has x1 > x2
     double x1 = boundingBox.topLeft().longitude();
     double y1 = boundingBox.topLeft().latitude();
     double x2 = boundingBox.bottomRight().longitude();
     double y2 = boundingBox.bottomRight().latitude();
-
-    //...Orient box to 0->360
-    if (x1 < 0.0) x1 = x1 + 360.0;
-    if (x2 < 0.0) x2 = x2 + 360.0;
-
-    double xl = std::min(x1, x2);
-    double xr = std::max(x1, x2);
-    double yb = std::min(y1, y2);
-    double yt = std::max(y1, y2);
-
-    QVector<Station> visibleMarkers;
+    if (boundingBox.width() >= 360.0) x2 = x1 + 360.0;
 
     //...Get the objects inside the viewport
-    for (int i = 0; i < locations.size(); i++) {
-      double x = locations.at(i).coordinate().longitude();
-      double y = locations.at(i).coordinate().latitude();
-
-      if (x < 0.0) x = x + 360.0;
-
-      if (x <= xr && x >= xl && y <= yt && y >= yb) {
-        if (activeOnly) {
-          if (locations.at(i).active()) {
-            visibleMarkers.push_back(locations.at(i));
-          }
-        } else
-          visibleMarkers.push_back(locations.at(i));
-      }
+    QVector<int> inside = index.box(x1, y2, x2, y1);
+    QVector<int> visible;
+    visible.reserve(inside.size());
+    for (int i : inside) {
+      if (!activeOnly || locations.at(i).active()) visible.push_back(i);
     }
 
-    if (visibleMarkers.length() <= MAX_NUM_DISPLAYED_STATIONS) {
-      model->addMarkers(visibleMarkers);
+    QVector<Station> visibleMarkers;
+    QVector<int> clusterSizes;
+    if (visible.length() <= MAX_NUM_DISPLAYED_STATIONS) {
+      visibleMarkers.reserve(visible.size());
+      for (int i : visible) visibleMarkers.push_back(locations.at(i));
+    } else {
+      //...Too many to draw one by one, so group them for this zoom level
+      QVariant zoom;
+      QMetaObject::invokeMethod(map->rootObject(), "getZoomLevel",
+                                Q_RETURN_ARG(QVariant, zoom));
+      clusters.markers(zoom.toDouble(), locations, visible, activeOnly,
+                       visibleMarkers, clusterSizes);
     }
+
+    //...Only markers entering or leaving the view are touched
+    model->setMarkers(visibleMarkers, clusterSizes);
     return visibleMarkers.length();
   } else {
-    model->addMarkers(locations);
+    model->setMarkers(locations);
     return locations.length();
   }
 }
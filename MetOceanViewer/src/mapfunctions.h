@@ -24,6 +24,8 @@
 #include <QObject>
 #include <memory>
 #include "station.h"
+#include "stationclusters.h"
+#include "stationindex.h"
 #include "stationmodel.h"
 
 class MapFunctions : public QObject {
@@ -35,7 +37,8 @@ class MapFunctions : public QObject {
   explicit MapFunctions(QObject *parent = nullptr);
 
   int refreshMarkers(StationModel *model, QQuickWidget *map,
-                     QVector<Station> &locations, bool filter = true,
+                     QVector<Station> &locations, const StationIndex &index,
+                     const StationClusters &clusters, bool filter = true,
                      bool activeOnly = true);
 
   void setMapTypes(QComboBox *comboBox);
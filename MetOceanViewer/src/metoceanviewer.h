@@ -11,6 +11,9 @@ const int NULL_HOUR = 0;
 const int NULL_MINUTE = 0;
 const int NULL_SECOND = 0;
 
+//...Number of samples held by the cache of lazily loaded station series
+const int STATION_CACHE_SAMPLES = 8 * 1024 * 1024;
+
 namespace FileType {
 enum _filetype {
   NETCDF_ADCIRC,
@@ -116,11 +116,13 @@ int Ndbc::plot(int index) {
   series1->setPen(
       QPen(QColor(0, 0, 255), 3, Qt::SolidLine, Qt::RoundCap, Qt::RoundJoin));
 
+  QVector<QPointF> points;
+  points.reserve(s->numSnaps());
   for (int j = 0; j < s->numSnaps(); j++) {
-    series1->append(s->date(j) - offset, s->data(j));
+    points.push_back(QPointF(s->date(j) - offset, s->data(j)));
   }
 
-  this->m_chartView->addSeries(series1, s->name());
+  this->m_chartView->addSeries(series1, points, s->name());
 
   this->m_chartView->setDateFormat(startDate, endDate);
   this->m_chartView->setAxisLimits(startDate, endDate, ymin, ymax);
@@ -150,7 +152,7 @@ int Ndbc::saveImage(QString filename, QString filter) {
     painter.begin(&printer);
 
     //...Page 1 - Chart
-    this->m_chartView->render(&painter);
+    this->m_chartView->renderChart(&painter);
 
     //...Page 2 - Map
     printer.newPage();
@@ -180,7 +182,7 @@ int Ndbc::saveImage(QString filename, QString filter) {
                                 QPainter::TextAntialiasing |
                                 QPainter::SmoothPixmapTransform);
     // this->map->render(&imagePainter, QPoint(0, 0));
-    this->m_chartView->render(&imagePainter, chartRect);
+    this->m_chartView->renderChart(&imagePainter, chartRect);
 
     outputFile.open(QIODevice::WriteOnly);
     pixmap.save(&outputFile, "JPG", 100);
@@ -124,8 +124,8 @@ int Noaa::getDataBounds(double &ymin, double &ymax) {
 
   for (int i = 0; i < this->m_currentStationData.length(); i++) {
     if (!this->m_currentStationData[i]->null()) {
-      QVector<double> data =
-          this->m_currentStationData[i]->station(0)->allData();
+      HmdfSpan<const double> data =
+          this->m_currentStationData[i]->station(0)->dataSpan();
       double min = *std::min_element(data.begin(), data.end());
       double max = *std::max_element(data.begin(), data.end());
       ymin = std::min(ymin, min);
@@ -218,6 +218,7 @@ int Noaa::plotChart() {
   QLineSeries *series2 = new QLineSeries(this->m_chartView->chart());
   series1->setName(S1);
   series2->setName(S2);
+  QVector<QPointF> points1, points2;
   series1->setPen(
       QPen(QColor(0, 0, 255), 3, Qt::SolidLine, Qt::RoundCap, Qt::RoundJoin));
   series2->setPen(
@@ -240,13 +241,14 @@ int Noaa::plotChart() {
             this->m_offsetSeconds)
             .isValid()) {
       if (this->m_currentStationData[0]->station(0)->data(j) != 0.0)
-        series1->append(this->m_currentStationData[0]->station(0)->date(j) +
-                            this->m_offsetSeconds - offset,
-                        this->m_currentStationData[0]->station(0)->data(j));
+        points1.push_back(
+            QPointF(this->m_currentStationData[0]->station(0)->date(j) +
+                        this->m_offsetSeconds - offset,
+                    this->m_currentStationData[0]->station(0)->data(j)));
     }
   }
 
-  this->m_chartView->addSeries(series1, series1->name());
+  this->m_chartView->addSeries(series1, points1, series1->name());
 
   if (this->m_productIndex == 0) {
     for (int j = 0; j < this->m_currentStationData[1]->station(0)->numSnaps();
@@ -256,11 +258,12 @@ int Noaa::plotChart() {
               this->m_offsetSeconds)
               .isValid()) {
         if (this->m_currentStationData[1]->station(0)->data(j) != 0.0)
-          series2->append(this->m_currentStationData[1]->station(0)->date(j) +
-                              this->m_offsetSeconds - offset,
-                          this->m_currentStationData[1]->station(0)->data(j));
+          points2.push_back(
+              QPointF(this->m_currentStationData[1]->station(0)->date(j) +
+                          this->m_offsetSeconds - offset,
+                      this->m_currentStationData[1]->station(0)->data(j)));
       }
-    this->m_chartView->addSeries(series2, series2->name());
+    this->m_chartView->addSeries(series2, points2, series2->name());
   }
 
   this->m_chartView->chart()->setTitle(tr("NOAA Station ") +
@@ -393,7 +396,7 @@ int Noaa::saveNOAAImage(QString filename, QString filter) {
     painter.begin(&printer);
 
     //...Page 1 - Chart
-    this->m_chartView->render(&painter);
+    this->m_chartView->renderChart(&painter);
 
     //...Page 2 - Map
     printer.newPage();
@@ -423,7 +426,7 @@ int Noaa::saveNOAAImage(QString filename, QString filter) {
                                 QPainter::TextAntialiasing |
                                 QPainter::SmoothPixmapTransform);
     this->m_quickMap->render(&imagePainter, QPoint(0, 0));
-    this->m_chartView->render(&imagePainter, chartRect);
+    this->m_chartView->renderChart(&imagePainter, chartRect);
 
     outputFile.open(QIODevice::WriteOnly);
     pixmap.save(&outputFile, "JPG", 100);
@@ -459,22 +462,7 @@ int Noaa::replotChart(Timezone *newTimezone) {
   int offset = newTimezone->utcOffset() * 1000;
   int totalOffset = -this->m_priorOffsetSeconds + offset;
 
-  QVector<QLineSeries *> series;
-  series.resize(this->m_chartView->chart()->series().length());
-
-  for (int i = 0; i < this->m_chartView->chart()->series().length(); i++) {
-    series[i] =
-        static_cast<QLineSeries *>(this->m_chartView->chart()->series().at(i));
-  }
-
-  for (int i = 0; i < series.length(); i++) {
-    QList<QPointF> data = series[i]->points();
-    series[i]->clear();
-    for (int j = 0; j < data.length(); j++) {
-      data[j].setX(data[j].x() + totalOffset);
-    }
-    series[i]->append(data);
-  }
+  this->m_chartView->offsetSeries(totalOffset);
 
   QDateTime minDateTime = this->m_startDateEdit->dateTime();
   QDateTime maxDateTime = this->m_endDateEdit->dateTime();
@@ -495,7 +483,7 @@ int Noaa::replotChart(Timezone *newTimezone) {
 
   this->m_chartView->update();
 
-  this->m_chartView->chart()->zoomReset();
+  this->m_chartView->resetZoom();
 
   return 0;
 }
@@ -0,0 +1,143 @@
+/*-------------------------------GPL-------------------------------------//
+//
+// MetOcean Viewer - A simple interface for viewing hydrodynamic model data
+// Copyright (C) 2018  Zach Cobell
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------*/
+#include "stationclusters.h"
+#include <QHash>
+#include <algorithm>
+#include <cmath>
+#include "constants.h"
+
+//...Finest zoom level that is clustered
+static const int c_maxClusterZoom = 14;
+
+//...Cell size in screen pixels and map tile size
+static const int c_cellSize = 64;
+static const int c_tileSize = 256;
+
+//...Web mercator latitude limit
+static const double c_maxLatitude = 85.0511287798;
+
+static quint32 toCell(double x, double cells) {
+  double c = std::floor(x * cells);
+  return static_cast<quint32>(std::max(0.0, std::min(c, cells - 1.0)));
+}
+
+StationClusters::StationClusters() {}
+
+StationClusters::StationClusters(const QVector<Station> &stations) {
+  this->build(stations);
+}
+
+int StationClusters::maximumZoom() { return c_maxClusterZoom; }
+
+void StationClusters::build(const QVector<Station> &stations) {
+  int n = stations.size();
+
+  //...Cell of each station at the finest level. Coarser levels are found
+  //   by shifting since each zoom level halves the number of cells
+  double cells =
+      std::ldexp(1.0, c_maxClusterZoom) * c_tileSize / c_cellSize;
+  QVector<quint32> cellX(n), cellY(n);
+  for (int i = 0; i < n; ++i) {
+    double lon = stations[i].coordinate().longitude();
+    double lat = std::max(-c_maxLatitude,
+                          std::min(c_maxLatitude,
+                                   stations[i].coordinate().latitude()));
+    double s = std::sin(Constants::toRadians(lat));
+    double x = (lon + 180.0) / 360.0;
+    double y = 0.5 - std::log((1.0 + s) / (1.0 - s)) / (4.0 * Constants::pi());
+    cellX[i] = toCell(x, cells);
+    cellY[i] = toCell(y, cells);
+  }
+
+  for (int a = 0; a < 2; ++a) {
+    this->m_levels[a].clear();
+    this->m_levels[a].resize(c_maxClusterZoom + 1);
+    for (int z = 0; z <= c_maxClusterZoom; ++z) {
+      Level &level = this->m_levels[a][z];
+      level.member.fill(-1, n);
+
+      int shift = c_maxClusterZoom - z;
+      QHash<quint64, int> cellMap;
+      for (int i = 0; i < n; ++i) {
+        if (a == 1 && !stations[i].active()) continue;
+        quint64 key = (static_cast<quint64>(cellX[i] >> shift) << 32) |
+                      (cellY[i] >> shift);
+        int c = cellMap.value(key, -1);
+        if (c < 0) {
+          c = level.clusters.size();
+          cellMap.insert(key, c);
+          level.clusters.push_back({0.0, 0.0, 0});
+        }
+        Cluster &cluster = level.clusters[c];
+        cluster.longitude += stations[i].coordinate().longitude();
+        cluster.latitude += stations[i].coordinate().latitude();
+        cluster.count++;
+        level.member[i] = c;
+      }
+
+      for (Cluster &cluster : level.clusters) {
+        cluster.longitude /= cluster.count;
+        cluster.latitude /= cluster.count;
+      }
+    }
+  }
+  return;
+}
+
+void StationClusters::markers(double zoomLevel,
+                              const QVector<Station> &stations,
+                              const QVector<int> &visible, bool activeOnly,
+                              QVector<Station> &markers,
+                              QVector<int> &clusterSizes) const {
+  markers.clear();
+  clusterSizes.clear();
+
+  const QVector<Level> &levels = this->m_levels[activeOnly ? 1 : 0];
+  int z = std::max(0, static_cast<int>(std::floor(zoomLevel)));
+
+  if (z > c_maxClusterZoom || levels.isEmpty()) {
+    for (int i : visible) {
+      if (activeOnly && !stations[i].active()) continue;
+      markers.push_back(stations[i]);
+      clusterSizes.push_back(1);
+    }
+    return;
+  }
+
+  const Level &level = levels[z];
+  QVector<bool> used(level.clusters.size(), false);
+  for (int i : visible) {
+    int c = level.member[i];
+    if (c < 0 || used[c]) continue;
+    used[c] = true;
+
+    const Cluster &cluster = level.clusters[c];
+    if (cluster.count == 1) {
+      markers.push_back(stations[i]);
+    } else {
+      markers.push_back(
+          Station(QGeoCoordinate(cluster.latitude, cluster.longitude),
+                  QString("cluster_%1_%2").arg(z).arg(c),
+                  QString::number(cluster.count) + " stations"));
+    }
+    clusterSizes.push_back(cluster.count);
+  }
+  return;
+}
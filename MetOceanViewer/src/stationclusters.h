@@ -0,0 +1,65 @@
+/*-------------------------------GPL-------------------------------------//
+//
+// MetOcean Viewer - A simple interface for viewing hydrodynamic model data
+// Copyright (C) 2018  Zach Cobell
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------*/
+#ifndef STATIONCLUSTERS_H
+#define STATIONCLUSTERS_H
+
+#include <QVector>
+#include "station.h"
+
+//...Grid clustering of a station list for the map views. Stations are
+//   projected to web mercator once and binned into fixed size screen
+//   cells at every zoom level up to maximumZoom(). Cluster positions and
+//   counts cover the whole list, so a cluster does not move or change
+//   count as the view is panned.
+class StationClusters {
+ public:
+  StationClusters();
+  explicit StationClusters(const QVector<Station> &stations);
+
+  void build(const QVector<Station> &stations);
+
+  static int maximumZoom();
+
+  //...Markers for the visible stations (indices into the list the
+  //   clusters were built from) at the given map zoom level. A cell
+  //   holding one station gives that station, otherwise one marker is
+  //   placed at the mean position of the cell and its station count is
+  //   written to clusterSizes. Above maximumZoom() nothing is clustered
+  void markers(double zoomLevel, const QVector<Station> &stations,
+               const QVector<int> &visible, bool activeOnly,
+               QVector<Station> &markers, QVector<int> &clusterSizes) const;
+
+ private:
+  struct Cluster {
+    double longitude;
+    double latitude;
+    int count;
+  };
+
+  struct Level {
+    QVector<Cluster> clusters;
+    QVector<int> member;
+  };
+
+  //...Levels for all stations [0] and for active stations only [1]
+  QVector<Level> m_levels[2];
+};
+
+#endif  // STATIONCLUSTERS_H
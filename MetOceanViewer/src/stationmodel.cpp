@@ -18,6 +18,7 @@
 //
 //-----------------------------------------------------------------------*/
 #include "stationmodel.h"
+#include <algorithm>
 
 StationModel::StationModel(QObject *parent) : QAbstractListModel(parent) {
   this->buildRoles();
@@ -37,12 +38,19 @@ void StationModel::buildRoles() {
   this->m_roles[startDateRole] = "startDate";
   this->m_roles[endDateRole] = "endDate";
   this->m_roles[activeRole] = "active";
+  this->m_roles[clusterSizeRole] = "clusterSize";
   return;
 }
 
 void StationModel::addMarker(Station &station) {
+  this->addMarker(station, 1);
+}
+
+void StationModel::addMarker(Station &station, int clusterSize) {
   this->beginInsertRows(QModelIndex(), rowCount(), rowCount());
   this->m_stations.append(station);
+  this->m_stations.last().setSelected(this->m_selected.contains(station.id()));
+  this->m_clusterSizes.append(clusterSize);
   this->m_stationMap[station.id()] =
       this->m_stations.at(this->m_stations.length() - 1);
   this->m_stationLocationMap[station.id()] = this->m_stations.length() - 1;
@@ -56,6 +64,94 @@ void StationModel::addMarkers(QVector<Station> &stations) {
   return;
 }
 
+void StationModel::setMarkers(const QVector<Station> &stations,
+                              const QVector<int> &clusterSizes) {
+  //...Pending selection rows refer to the current layout
+  this->flushSelectionChanges();
+
+  QHash<QString, int> incoming;
+  incoming.reserve(stations.size());
+  for (int i = 0; i < stations.size(); ++i) {
+    if (!incoming.contains(stations[i].id()))
+      incoming.insert(stations[i].id(), i);
+  }
+
+  //...Remove rows that are not in the new set, working back from the end
+  //   so the rows still to be checked keep their numbers. Neighbouring
+  //   rows are removed together
+  int row = this->m_stations.size() - 1;
+  while (row >= 0) {
+    if (incoming.contains(this->m_stations[row].id())) {
+      row--;
+      continue;
+    }
+    int last = row;
+    while (row >= 0 && !incoming.contains(this->m_stations[row].id())) {
+      this->m_stationMap.remove(this->m_stations[row].id());
+      row--;
+    }
+    this->beginRemoveRows(QModelIndex(), row + 1, last);
+    this->m_stations.erase(this->m_stations.begin() + row + 1,
+                           this->m_stations.begin() + last + 1);
+    this->m_clusterSizes.erase(this->m_clusterSizes.begin() + row + 1,
+                               this->m_clusterSizes.begin() + last + 1);
+    this->endRemoveRows();
+  }
+
+  //...Renumber the rows that stayed and refresh any whose marker changed,
+  //   for example a cluster that now holds a different set of stations
+  this->m_stationLocationMap.clear();
+  int changedFirst = -1;
+  int changedLast = -1;
+  for (int i = 0; i < this->m_stations.size(); ++i) {
+    QString id = this->m_stations[i].id();
+    this->m_stationLocationMap[id] = i;
+
+    int j = incoming.value(id);
+    int clusterSize = j < clusterSizes.size() ? clusterSizes[j] : 1;
+    const Station &s = stations[j];
+    if (this->m_clusterSizes[i] != clusterSize ||
+        this->m_stations[i].coordinate() != s.coordinate() ||
+        this->m_stations[i].name() != s.name() ||
+        this->m_stations[i].active() != s.active()) {
+      bool selected = this->m_stations[i].selected();
+      this->m_stations[i] = s;
+      this->m_stations[i].setSelected(selected);
+      this->m_clusterSizes[i] = clusterSize;
+      this->m_stationMap[id] = this->m_stations[i];
+      if (changedFirst < 0) changedFirst = i;
+      changedLast = i;
+    }
+  }
+  if (changedFirst >= 0) {
+    emit dataChanged(this->index(changedFirst), this->index(changedLast));
+  }
+
+  //...Append the markers that are new in one block
+  QVector<int> added;
+  for (int j = 0; j < stations.size(); ++j) {
+    if (!this->m_stationLocationMap.contains(stations[j].id()) &&
+        incoming.value(stations[j].id()) == j)
+      added.push_back(j);
+  }
+  if (added.isEmpty()) return;
+
+  int first = this->m_stations.size();
+  this->beginInsertRows(QModelIndex(), first, first + added.size() - 1);
+  for (int j : added) {
+    this->m_stations.append(stations[j]);
+    this->m_stations.last().setSelected(
+        this->m_selected.contains(stations[j].id()));
+    this->m_clusterSizes.append(j < clusterSizes.size() ? clusterSizes[j]
+                                                        : 1);
+    this->m_stationMap[stations[j].id()] = this->m_stations.last();
+    this->m_stationLocationMap[stations[j].id()] =
+        this->m_stations.size() - 1;
+  }
+  this->endInsertRows();
+  return;
+}
+
 int StationModel::rowCount(const QModelIndex &parent) const {
   Q_UNUSED(parent)
   return this->m_stations.count();
@@ -95,6 +191,8 @@ QVariant StationModel::data(const QModelIndex &index, int role) const {
         this->m_stations[index.row()].endValidDate().toString("MM/dd/yyyy"));
   } else if (role == StationModel::activeRole) {
     return QVariant::fromValue(this->m_stations[index.row()].active());
+  } else if (role == StationModel::clusterSizeRole) {
+    return QVariant::fromValue(this->m_clusterSizes[index.row()]);
   } else {
     return QVariant();
   }
@@ -111,19 +209,58 @@ Station StationModel::findStation(QString stationName) {
 }
 
 void StationModel::selectStation(QString name) {
-  if (this->m_stationLocationMap.contains(name)) {
-    this->m_stations[this->m_stationLocationMap[name]].setSelected(true);
-  }
+  this->setStationSelected(name, true);
   return;
 }
 
 void StationModel::deselectStation(QString name) {
-  if (this->m_stationLocationMap.contains(name)) {
-    this->m_stations[this->m_stationLocationMap[name]].setSelected(false);
+  this->setStationSelected(name, false);
+  return;
+}
+
+void StationModel::deselectAllStations() {
+  QList<QString> selected = this->m_selected.values();
+  for (const QString &name : selected) this->setStationSelected(name, false);
+  return;
+}
+
+void StationModel::setStationSelected(const QString &name, bool selected) {
+  //...The selection is kept by id so it survives the station leaving and
+  //   re-entering the view
+  if (selected)
+    this->m_selected.insert(name);
+  else
+    this->m_selected.remove(name);
+
+  int row = this->m_stationLocationMap.value(name, -1);
+  if (row < 0 || this->m_stations[row].selected() == selected) return;
+  this->m_stations[row].setSelected(selected);
+  this->m_stationMap[name].setSelected(selected);
+
+  //...Changes made in one pass through the event loop are reported
+  //   together as a single row range
+  if (this->m_selectionFirst < 0) {
+    this->m_selectionFirst = row;
+    this->m_selectionLast = row;
+    QMetaObject::invokeMethod(this, "flushSelectionChanges",
+                              Qt::QueuedConnection);
+  } else {
+    this->m_selectionFirst = std::min(this->m_selectionFirst, row);
+    this->m_selectionLast = std::max(this->m_selectionLast, row);
   }
   return;
 }
 
+void StationModel::flushSelectionChanges() {
+  if (this->m_selectionFirst < 0) return;
+  QModelIndex first = this->index(this->m_selectionFirst);
+  QModelIndex last = this->index(this->m_selectionLast);
+  this->m_selectionFirst = -1;
+  this->m_selectionLast = -1;
+  emit dataChanged(first, last, QVector<int>() << StationModel::selectedRole);
+  return;
+}
+
 void StationModel::boundingBox(QRectF &box, bool activeOnly) {
   if (this->m_stations.length() == 0) {
     box = QRectF();
@@ -201,13 +338,19 @@ void StationModel::fitMarkers(QQuickWidget *quickWidget, StationModel *model,
 void StationModel::clear() {
   this->beginResetModel();
   this->m_stations.clear();
+  this->m_clusterSizes.clear();
   this->m_stationMap.clear();
+  this->m_stationLocationMap.clear();
+  this->m_selected.clear();
+  this->m_selectionFirst = -1;
+  this->m_selectionLast = -1;
   this->endResetModel();
 }
 
 bool StationModel::removeRows(int row, int count, const QModelIndex &parent) {
   beginRemoveRows(parent, row, count - 1);
   this->m_stations.clear();
+  this->m_clusterSizes.clear();
   this->m_stationMap.clear();
   endRemoveRows();
   return true;
@@ -27,6 +27,7 @@
 #include <QQuickItem>
 #include <QQuickView>
 #include <QQuickWidget>
+#include <QSet>
 #include "station.h"
 
 class StationModel : public QAbstractListModel {
@@ -48,7 +49,8 @@ class StationModel : public QAbstractListModel {
     selectedRole,
     startDateRole,
     endDateRole,
-    activeRole
+    activeRole,
+    clusterSizeRole
   };
 
   StationModel(QObject *parent = Q_NULLPTR);
@@ -57,6 +59,13 @@ class StationModel : public QAbstractListModel {
 
   void addMarkers(QVector<Station> &stations);
 
+  //...Replace the contents with a new marker set. Rows are matched by
+  //   station id, so only markers entering or leaving the set are inserted
+  //   or removed. Entry i stands in for clusterSizes[i] stations, entries
+  //   with a size of one (or past the end of clusterSizes) are stations
+  void setMarkers(const QVector<Station> &stations,
+                  const QVector<int> &clusterSizes = QVector<int>());
+
   int rowCount(const QModelIndex &parent = QModelIndex()) const override;
 
   QVariant data(const QModelIndex &index,
@@ -79,16 +88,29 @@ class StationModel : public QAbstractListModel {
 
   void deselectStation(QString name);
 
+  void deselectAllStations();
+
+ private slots:
+  void flushSelectionChanges();
+
  private:
   void buildRoles();
 
+  void setStationSelected(const QString &name, bool selected);
+
   bool removeRows(int row, int count,
                   const QModelIndex &parent = QModelIndex());
 
+  void addMarker(Station &station, int clusterSize);
+
   QList<Station> m_stations;
+  QList<int> m_clusterSizes;
   QHash<QString, Station> m_stationMap;
   QHash<QString, int> m_stationLocationMap;
   QHash<int, QByteArray> m_roles;
+  QSet<QString> m_selected;
+  int m_selectionFirst = -1;
+  int m_selectionLast = -1;
 };
 
 #endif  // STATIONMODEL_H
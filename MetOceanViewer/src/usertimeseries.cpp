@@ -18,6 +18,8 @@
 //
 //-----------------------------------------------------------------------*/
 #include "usertimeseries.h"
+#include <QHash>
+#include <QtMath>
 #include "adcircstationoutput.h"
 #include "dflow.h"
 #include "errors.h"
@@ -52,6 +54,7 @@ UserTimeseries::UserTimeseries(
   this->m_markerId = 0;
   this->m_stationmodel = inStationModel;
   this->m_currentStation = inSelectedStation;
+  this->m_lazyLoading = true;
 }
 
 UserTimeseries::~UserTimeseries() {}
@@ -72,65 +75,23 @@ int UserTimeseries::getDataBounds(double &ymin, double &ymax,
     double unitConversion = this->m_table->item(i, 3)->text().toDouble();
     double addY = this->m_table->item(i, 5)->text().toDouble();
     for (int k = 0; k < this->m_selectedStations.length(); k++) {
-      if (!this->m_fileDataUnique[i]
-               ->station(this->m_selectedStations[k])
-               ->isNull()) {
-        for (int j = 0; j < this->m_fileDataUnique[i]
-                                ->station(this->m_selectedStations[k])
-                                ->numSnaps();
-             j++) {
-          if (this->m_fileDataUnique[i]
-                              ->station(this->m_selectedStations[k])
-                              ->data(j) *
-                          unitConversion +
-                      addY <
-                  ymin &&
-              this->m_fileDataUnique[i]
-                      ->station(this->m_selectedStations[k])
-                      ->data(j) != MetOceanViewer::NULL_TS)
-            ymin = this->m_fileDataUnique[i]
-                           ->station(this->m_selectedStations[k])
-                           ->data(j) *
-                       unitConversion +
-                   addY;
-          if (this->m_fileDataUnique[i]
-                              ->station(this->m_selectedStations[k])
-                              ->data(j) *
-                          unitConversion +
-                      addY >
-                  ymax &&
-              this->m_fileDataUnique[i]
-                      ->station(this->m_selectedStations[k])
-                      ->data(j) != MetOceanViewer::NULL_TS)
-            ymax = this->m_fileDataUnique[i]
-                           ->station(this->m_selectedStations[k])
-                           ->data(j) *
-                       unitConversion +
-                   addY;
-          if (this->m_fileDataUnique[i]
-                          ->station(this->m_selectedStations[k])
-                          ->date(j) +
-                      (timeAddList[i] * 3600.0) <
-                  minDate &&
-              this->m_fileDataUnique[i]
-                      ->station(this->m_selectedStations[k])
-                      ->date(j) != nullDate)
-            minDate = this->m_fileDataUnique[i]
-                          ->station(this->m_selectedStations[k])
-                          ->date(j) +
-                      (timeAddList[i] * 3600.0);
-          if (this->m_fileDataUnique[i]
-                          ->station(this->m_selectedStations[k])
-                          ->date(j) +
-                      (timeAddList[i] * 3600.0) >
-                  maxDate &&
-              this->m_fileDataUnique[i]
-                      ->station(this->m_selectedStations[k])
-                      ->date(j) != nullDate)
-            maxDate = this->m_fileDataUnique[i]
-                          ->station(this->m_selectedStations[k])
-                          ->date(j) +
-                      (timeAddList[i] * 3600.0);
+      QSharedPointer<const HmdfStation> station =
+          this->stationSeries(i, this->m_selectedStations[k]);
+      if (!station || station->isNull()) continue;
+      for (int j = 0; j < station->numSnaps(); j++) {
+        double value = station->data(j);
+        qint64 date = station->date(j);
+        if (value != MetOceanViewer::NULL_TS) {
+          if (value * unitConversion + addY < ymin)
+            ymin = value * unitConversion + addY;
+          if (value * unitConversion + addY > ymax)
+            ymax = value * unitConversion + addY;
+        }
+        if (date != nullDate) {
+          if (date + (timeAddList[i] * 3600.0) < minDate)
+            minDate = date + (timeAddList[i] * 3600.0);
+          if (date + (timeAddList[i] * 3600.0) > maxDate)
+            maxDate = date + (timeAddList[i] * 3600.0);
         }
       }
     }
@@ -156,7 +117,7 @@ int UserTimeseries::saveImage(QString filename, QString filter) {
     painter.begin(&printer);
 
     //...Page 1 - Chart
-    this->m_chartView->render(&painter);
+    this->m_chartView->renderChart(&painter);
 
     //...Page 2 - Map
     printer.newPage();
@@ -186,7 +147,7 @@ int UserTimeseries::saveImage(QString filename, QString filter) {
                                 QPainter::TextAntialiasing |
                                 QPainter::SmoothPixmapTransform);
     this->m_quickMap->render(&imagePainter, QPoint(0, 0));
-    this->m_chartView->render(&imagePainter, chartRect);
+    this->m_chartView->renderChart(&imagePainter, chartRect);
 
     outputFile.open(QIODevice::WriteOnly);
     pixmap.save(&outputFile, "JPG", 100);
@@ -298,38 +259,32 @@ void UserTimeseries::plot() {
       addX =
           this->m_table->item(seriesCounter - 1, 4)->text().toDouble() * 3.6e+6;
       addY = this->m_table->item(seriesCounter - 1, 5)->text().toDouble();
-      for (j = 0;
-           j < this->m_fileDataUnique[i]->station(this->m_markerId)->numSnaps();
-           j++) {
-        if (this->m_fileDataUnique[i]->station(this->m_markerId)->data(j) !=
-                MetOceanViewer::NULL_TS &&
-            this->m_fileDataUnique[i]->station(this->m_markerId)->date(j) >=
-                startDate &&
-            this->m_fileDataUnique[i]->station(this->m_markerId)->date(j) <=
-                endDate) {
-          TempDate =
-              this->m_fileDataUnique[i]->station(this->m_markerId)->date(j) +
-              addX - offset;
-          TempValue =
-              this->m_fileDataUnique[i]->station(this->m_markerId)->data(j) *
-                  unitConversion +
-              addY;
-          series[seriesCounter - 1]->append(TempDate, TempValue);
+      QSharedPointer<const HmdfStation> station =
+          this->stationSeries(i, this->m_markerId);
+      int nSnaps = station ? static_cast<int>(station->numSnaps()) : 0;
+      QVector<QPointF> points;
+      points.reserve(nSnaps);
+      for (j = 0; j < nSnaps; j++) {
+        if (station->data(j) != MetOceanViewer::NULL_TS &&
+            station->date(j) >= startDate && station->date(j) <= endDate) {
+          TempDate = station->date(j) + addX - offset;
+          TempValue = station->data(j) * unitConversion + addY;
+          points.push_back(QPointF(TempDate, TempValue));
         }
       }
 
-      if (series[seriesCounter - 1]->points().size() > 0) {
+      if (points.size() > 0) {
         plottedSeriesCounter = plottedSeriesCounter + 1;
-        this->m_chartView->addSeries(series[seriesCounter - 1],
+        this->m_chartView->addSeries(series[seriesCounter - 1], points,
                                      series[seriesCounter - 1]->name());
       }
     } else {
       //...Plot multiple stations. We use random colors and append the station
       // number
       for (k = 0; k < this->m_selectedStations.length(); k++) {
-        if (!this->m_fileDataUnique[i]
-                 ->station(this->m_selectedStations[k])
-                 ->isNull()) {
+        QSharedPointer<const HmdfStation> station =
+            this->stationSeries(i, this->m_selectedStations[k]);
+        if (station && !station->isNull()) {
           seriesCounter = seriesCounter + 1;
           colorCounter = colorCounter + 1;
 
@@ -351,40 +306,19 @@ void UserTimeseries::plot() {
           unitConversion = this->m_table->item(i, 3)->text().toDouble();
           addX = this->m_table->item(i, 4)->text().toDouble() * 3.6e+6;
           addY = this->m_table->item(i, 5)->text().toDouble();
-          for (j = 0; j < this->m_fileDataUnique[i]
-                              ->station(this->m_selectedStations[k])
-                              ->numSnaps();
-               j++) {
-            if (this->m_fileDataUnique[i]
-                        ->station(this->m_selectedStations[k])
-                        ->data(j) != MetOceanViewer::NULL_TS &&
-                this->m_fileDataUnique[i]
-                        ->station(this->m_selectedStations[k])
-                        ->date(j) >= startDate &&
-                this->m_fileDataUnique[i]
-                        ->station(this->m_selectedStations[k])
-                        ->date(j) <= endDate) {
-              TempDate = this->m_fileDataUnique[i]
-                             ->station(this->m_selectedStations[k])
-                             ->date(j) +
-                         addX - offset;
-              TempValue = this->m_fileDataUnique[i]
-                                  ->station(this->m_selectedStations[k])
-                                  ->data(j) *
-                              unitConversion +
-                          addY;
-              series[seriesCounter - 1]->append(TempDate, TempValue);
+          QVector<QPointF> points;
+          points.reserve(station->numSnaps());
+          for (j = 0; j < station->numSnaps(); j++) {
+            if (station->data(j) != MetOceanViewer::NULL_TS &&
+                station->date(j) >= startDate && station->date(j) <= endDate) {
+              TempDate = station->date(j) + addX - offset;
+              TempValue = station->data(j) * unitConversion + addY;
+              points.push_back(QPointF(TempDate, TempValue));
             }
           }
 
-          if (series[seriesCounter - 1]->points().size() > 0) {
-            this->m_chartView->chart()->addSeries(series[seriesCounter - 1]);
-            this->m_chartView->chart()
-                ->legend()
-                ->markers()
-                .at(seriesCounter - 1)
-                ->setFont(QFont("Helvetica", 10, QFont::Bold));
-            this->m_chartView->addSeries(series[seriesCounter - 1],
+          if (points.size() > 0) {
+            this->m_chartView->addSeries(series[seriesCounter - 1], points,
                                          series[seriesCounter - 1]->name());
           }
         }
@@ -408,6 +342,32 @@ void UserTimeseries::plot() {
 
 QString UserTimeseries::getErrorString() { return this->m_errorString; }
 
+bool UserTimeseries::lazyLoading() const { return this->m_lazyLoading; }
+
+void UserTimeseries::setLazyLoading(bool lazyLoading) {
+  this->m_lazyLoading = lazyLoading;
+}
+
+//...Returns the series to plot for a station of the unique station list.
+//   Files opened in lazy mode only hold the station locations, so the series
+//   is fetched from the file's reader. All reads of series data go through
+//   here. The returned station stays valid while the caller holds it
+QSharedPointer<const HmdfStation> UserTimeseries::stationSeries(int file,
+                                                                int station) {
+  HmdfStation *s = this->m_fileDataUnique[file]->station(station);
+  if (s->isNull() || !this->isLazySource(file)) return s->sharedFromThis();
+  if (this->m_adcircSources[file])
+    return this->m_adcircSources[file]->station(s->stationIndex());
+  return this->m_dflowSources[file]->station(s->stationIndex());
+}
+
+//...True when the stations of a file only hold locations and the series
+//   are read from the file on demand
+bool UserTimeseries::isLazySource(int file) const {
+  return this->m_adcircSources.value(file) != nullptr ||
+         this->m_dflowSources.value(file) != nullptr;
+}
+
 int UserTimeseries::processImedsData(int tableIndex, Hmdf *data) {
   QString tempFile = this->m_table->item(tableIndex, 6)->text();
 
@@ -423,13 +383,20 @@ int UserTimeseries::processImedsData(int tableIndex, Hmdf *data) {
   return MetOceanViewer::Error::NOERR;
 }
 
-int UserTimeseries::processAdcircNetcdfData(int tableIndex, Hmdf *data) {
-  QString tempFile = this->m_table->item(tableIndex, 6)->text();
+int UserTimeseries::processAdcircNetcdfData(int tableIndex,
+                                            const FiletypeInfo &info,
+                                            Hmdf *data) {
+  QString tempFile = info.filename;
   QDateTime coldStart = QDateTime::fromString(
       this->m_table->item(tableIndex, 7)->text(), "yyyy-MM-dd hh:mm:ss");
   AdcircStationOutput *adcircData = new AdcircStationOutput(this);
-  int ierr = adcircData->read(tempFile, coldStart);
+  int ierr;
+  if (this->m_lazyLoading)
+    ierr = adcircData->open(info, coldStart);
+  else
+    ierr = adcircData->read(info, coldStart);
   if (ierr != MetOceanViewer::Error::NOERR) {
+    delete adcircData;
     this->m_errorString = tr("Error reading file: ") + tempFile;
     return MetOceanViewer::Error::ADCIRC_NETCDFREADERROR;
   }
@@ -439,7 +406,12 @@ int UserTimeseries::processAdcircNetcdfData(int tableIndex, Hmdf *data) {
     delete adcircData;
     return ierr;
   }
-  delete adcircData;
+
+  //...In lazy mode the reader stays open to serve the station series
+  if (this->m_lazyLoading)
+    this->m_adcircSources[tableIndex] = adcircData;
+  else
+    delete adcircData;
 
   if (!data->success()) return MetOceanViewer::Error::ADCIRC_NETCDFTOIMEDS;
   return MetOceanViewer::Error::NOERR;
@@ -469,13 +441,16 @@ int UserTimeseries::processAdcircAsciiData(int tableIndex, Hmdf *data) {
   return MetOceanViewer::Error::NOERR;
 }
 
-int UserTimeseries::processDflowData(int tableIndex, Hmdf *data) {
-  QString tempFile = this->m_table->item(tableIndex, 6)->text();
-
-  Dflow *dflow = new Dflow(tempFile, this);
+int UserTimeseries::processDflowData(int tableIndex, const FiletypeInfo &info,
+                                     Hmdf *data) {
+  Dflow *dflow = new Dflow(info, this);
   QString dflowVar = this->m_table->item(tableIndex, 12)->text();
   int dflowLayer = this->m_table->item(tableIndex, 13)->text().toInt();
-  int ierr = dflow->getVariable(dflowVar, dflowLayer, data);
+  int ierr;
+  if (this->m_lazyLoading)
+    ierr = dflow->getStationList(dflowVar, dflowLayer, data);
+  else
+    ierr = dflow->getVariable(dflowVar, dflowLayer, data);
 
   if (ierr != MetOceanViewer::Error::NOERR) {
     this->m_errorString =
@@ -483,7 +458,12 @@ int UserTimeseries::processDflowData(int tableIndex, Hmdf *data) {
     delete dflow;
     return MetOceanViewer::Error::DFLOW_FILEREADERROR;
   }
-  delete dflow;
+
+  //...In lazy mode the file stays open to serve the station series
+  if (this->m_lazyLoading)
+    this->m_dflowSources[tableIndex] = dflow;
+  else
+    delete dflow;
   return MetOceanViewer::Error::NOERR;
 }
 
@@ -502,19 +482,21 @@ int UserTimeseries::processDataFiles() {
   int ierr;
 
   for (int i = 0; i < this->m_table->rowCount(); i++) {
-    int inputFileType =
-        Filetypes::getIntegerFiletype(this->m_table->item(i, 6)->text());
+    FiletypeInfo info =
+        Filetypes::getFiletypeInfo(this->m_table->item(i, 6)->text());
     this->m_epsg.push_back(this->m_table->item(i, 11)->text().toInt());
+    this->m_adcircSources.push_back(nullptr);
+    this->m_dflowSources.push_back(nullptr);
 
     Hmdf *stationData = new Hmdf(this);
 
-    switch (inputFileType) {
+    switch (info.filetype) {
       case MetOceanViewer::FileType::ASCII_IMEDS:
         ierr = this->processImedsData(i, stationData);
         this->m_allFileData.push_back(stationData);
         break;
       case MetOceanViewer::FileType::NETCDF_ADCIRC:
-        ierr = this->processAdcircNetcdfData(i, stationData);
+        ierr = this->processAdcircNetcdfData(i, info, stationData);
         this->m_allFileData.push_back(stationData);
         break;
       case MetOceanViewer::FileType::ASCII_ADCIRC:
@@ -522,7 +504,7 @@ int UserTimeseries::processDataFiles() {
         this->m_allFileData.push_back(stationData);
         break;
       case MetOceanViewer::FileType::NETCDF_DFLOW:
-        ierr = this->processDflowData(i, stationData);
+        ierr = this->processDflowData(i, info, stationData);
         this->m_allFileData.push_back(stationData);
         break;
       case MetOceanViewer::FileType::NETCDF_GENERIC:
@@ -632,6 +614,60 @@ int UserTimeseries::processData() {
   return MetOceanViewer::Error::NOERR;
 }
 
+//-------------------------------------------//
+// Station matching grid. Cells are the size of
+// the duplicate tolerance, so any station within
+// the tolerance of a location is in the same or
+// one of the eight neighboring cells
+//-------------------------------------------//
+typedef QHash<qint64, QVector<int>> StationGrid;
+
+static inline qint64 stationGridKey(qint64 ix, qint64 iy) {
+  return static_cast<qint64>((static_cast<quint64>(ix) << 32) ^
+                             static_cast<quint32>(iy));
+}
+
+static inline bool stationGridCell(double x, double y, double tolerance,
+                                   qint64 &ix, qint64 &iy) {
+  if (!qIsFinite(x) || !qIsFinite(y)) return false;
+  ix = static_cast<qint64>(qFloor(x / tolerance));
+  iy = static_cast<qint64>(qFloor(y / tolerance));
+  return true;
+}
+
+static void addToStationGrid(StationGrid &grid, double x, double y,
+                             double tolerance, int index) {
+  qint64 ix, iy;
+  if (stationGridCell(x, y, tolerance, ix, iy))
+    grid[stationGridKey(ix, iy)].push_back(index);
+}
+
+//...Lowest index of a station within the tolerance of (x, y), which is the
+//   station a linear search in index order would find, or -1
+static int findInStationGrid(const StationGrid &grid, const QVector<double> &X,
+                             const QVector<double> &Y, double x, double y,
+                             double tolerance) {
+  qint64 ix, iy;
+  if (!stationGridCell(x, y, tolerance, ix, iy)) return -1;
+
+  int found = -1;
+  for (qint64 i = ix - 1; i <= ix + 1; i++) {
+    for (qint64 j = iy - 1; j <= iy + 1; j++) {
+      StationGrid::const_iterator cell = grid.constFind(stationGridKey(i, j));
+      if (cell == grid.constEnd()) continue;
+      for (int k = 0; k < cell->size(); k++) {
+        int index = cell->at(k);
+        if (found != -1 && index >= found) continue;
+        double dx = X[index] - x;
+        double dy = Y[index] - y;
+        if (qSqrt(dx * dx + dy * dy) < tolerance) found = index;
+      }
+    }
+  }
+  return found;
+}
+//-------------------------------------------//
+
 //-------------------------------------------//
 // Generate a unique list of stations so that
 // we can later build a complete list of stations
@@ -641,21 +677,20 @@ int UserTimeseries::processData() {
 int UserTimeseries::getUniqueStationList(QVector<Hmdf *> Data,
                                          QVector<double> &X,
                                          QVector<double> &Y) {
+  StationGrid grid;
+  for (int k = 0; k < X.length(); k++)
+    addToStationGrid(grid, X[k], Y[k], this->m_duplicateStationTolerance, k);
+
   for (int i = 0; i < Data.length(); i++) {
     for (int j = 0; j < Data[i]->nstations(); j++) {
-      bool found = false;
-      for (int k = 0; k < X.length(); k++) {
-        double dx = Data[i]->station(j)->longitude() - X[k];
-        double dy = Data[i]->station(j)->latitude() - Y[k];
-        double d = qSqrt(qPow(dx, 2.0) + qPow(dy, 2.0));
-        if (d < this->m_duplicateStationTolerance) {
-          found = true;
-          break;
-        }
-      }
-      if (!found) {
-        X.push_back(Data[i]->station(j)->longitude());
-        Y.push_back(Data[i]->station(j)->latitude());
+      double x = Data[i]->station(j)->longitude();
+      double y = Data[i]->station(j)->latitude();
+      if (findInStationGrid(grid, X, Y, x, y,
+                            this->m_duplicateStationTolerance) == -1) {
+        addToStationGrid(grid, x, y, this->m_duplicateStationTolerance,
+                         X.length());
+        X.push_back(x);
+        Y.push_back(y);
       }
     }
   }
@@ -666,7 +701,8 @@ int UserTimeseries::getUniqueStationList(QVector<Hmdf *> Data,
 //-------------------------------------------//
 // Build a revised set of IMEDS data series
 // which will have null data where there was
-// not data in the file
+// not data in the file. The series are shared
+// with the input stations rather than copied
 //-------------------------------------------//
 int UserTimeseries::buildRevisedIMEDS(QVector<Hmdf *> Data, QVector<double> X,
                                       QVector<double> Y,
@@ -680,7 +716,7 @@ int UserTimeseries::buildRevisedIMEDS(QVector<Hmdf *> Data, QVector<double> X,
     DataOut[i]->setHeader3(Data[i]->header3());
 
     for (int j = 0; j < X.length(); j++) {
-      HmdfStation *station = new HmdfStation(DataOut[i]);
+      HmdfStation *station = new HmdfStation();
       station->setLongitude(X[j]);
       station->setLatitude(Y[j]);
       DataOut[i]->addStation(station);
@@ -688,24 +724,31 @@ int UserTimeseries::buildRevisedIMEDS(QVector<Hmdf *> Data, QVector<double> X,
   }
 
   for (int i = 0; i < Data.length(); i++) {
+    QVector<double> fileX(Data[i]->nstations());
+    QVector<double> fileY(Data[i]->nstations());
+    StationGrid grid;
+    for (int k = 0; k < Data[i]->nstations(); k++) {
+      fileX[k] = Data[i]->station(k)->longitude();
+      fileY[k] = Data[i]->station(k)->latitude();
+      addToStationGrid(grid, fileX[k], fileY[k],
+                       this->m_duplicateStationTolerance, k);
+    }
+
     for (int j = 0; j < DataOut[i]->nstations(); j++) {
-      bool found = false;
-      for (int k = 0; k < Data[i]->nstations(); k++) {
-        double dx = Data[i]->station(k)->longitude() -
-                    DataOut[i]->station(j)->longitude();
-        double dy = Data[i]->station(k)->latitude() -
-                    DataOut[i]->station(j)->latitude();
-        double d = qSqrt(qPow(dx, 2.0) + qPow(dy, 2.0));
-        if (d < this->m_duplicateStationTolerance) {
-          DataOut[i]->station(j)->setName(Data[i]->station(k)->name());
-          DataOut[i]->station(j)->setData(Data[i]->station(k)->allData());
-          DataOut[i]->station(j)->setDate(Data[i]->station(k)->allDate());
-          DataOut[i]->station(j)->setIsNull(false);
-          found = true;
-          break;
-        }
-      }
-      if (!found) {
+      int k = findInStationGrid(grid, fileX, fileY,
+                                DataOut[i]->station(j)->longitude(),
+                                DataOut[i]->station(j)->latitude(),
+                                this->m_duplicateStationTolerance);
+      if (k != -1) {
+        DataOut[i]->station(j)->setName(Data[i]->station(k)->name());
+        DataOut[i]->station(j)->setStationIndex(
+            Data[i]->station(k)->stationIndex());
+        //...Lazy stations have no series yet. stationSeries reads them
+        //   from the file using the station index
+        if (!this->isLazySource(i))
+          DataOut[i]->station(j)->shareSeries(Data[i]->station(k));
+        DataOut[i]->station(j)->setIsNull(false);
+      } else {
         // Build a station with a null dataset we can find later
         DataOut[i]->station(j)->setName("NONAME");
         DataOut[i]->station(j)->setNext(MetOceanViewer::NULL_TS, 0.0);
@@ -31,10 +31,14 @@
 #include <QVector>
 #include <QtCharts>
 #include "chartview.h"
+#include "filetypes.h"
 #include "generic.h"
 #include "hmdf.h"
 #include "stationmodel.h"
 
+class AdcircStationOutput;
+class Dflow;
+
 class UserTimeseries : public QObject {
   Q_OBJECT
 
@@ -59,6 +63,9 @@ class UserTimeseries : public QObject {
   QString getErrorString();
   void plot();
 
+  bool lazyLoading() const;
+  void setLazyLoading(bool lazyLoading);
+
  signals:
   void timeseriesError(QString);
 
@@ -79,11 +86,14 @@ class UserTimeseries : public QObject {
   int processDataFiles();
   int processImedsData(int tableIndex, Hmdf *data);
   int processAdcircAsciiData(int tableIndex, Hmdf *data);
-  int processAdcircNetcdfData(int tableIndex, Hmdf *data);
-  int processDflowData(int tableIndex, Hmdf *data);
+  int processAdcircNetcdfData(int tableIndex, const FiletypeInfo &info,
+                              Hmdf *data);
+  int processDflowData(int tableIndex, const FiletypeInfo &info, Hmdf *data);
   int processGenericNetcdfData(int tableIndex, Hmdf *data);
   int processStationLocations();
   int addMarkersToMap();
+  QSharedPointer<const HmdfStation> stationSeries(int file, int station);
+  bool isLazySource(int file) const;
 
   //...Private Variables
   int m_markerId;
@@ -94,6 +104,9 @@ class UserTimeseries : public QObject {
   QVector<int> m_selectedStations;
   QVector<QColor> m_randomColorList;
   QVector<int> m_epsg;
+  QVector<AdcircStationOutput *> m_adcircSources;
+  QVector<Dflow *> m_dflowSources;
+  bool m_lazyLoading;
   const double m_duplicateStationTolerance = 0.00001;
 
   //...Widgets
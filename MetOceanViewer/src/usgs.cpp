@@ -169,12 +169,14 @@ int Usgs::plotUSGS() {
   series1->setPen(
       QPen(QColor(0, 0, 255), 3, Qt::SolidLine, Qt::RoundCap, Qt::RoundJoin));
 
+  QVector<QPointF> points;
+  points.reserve(station->numSnaps());
   for (int j = 0; j < station->numSnaps(); j++) {
     if (QDateTime::fromMSecsSinceEpoch(station->date(j)).isValid()) {
-      series1->append(station->date(j), station->data(j));
+      points.push_back(QPointF(station->date(j), station->data(j)));
     }
   }
-  this->m_chartView->addSeries(series1, this->m_productName);
+  this->m_chartView->addSeries(series1, points, this->m_productName);
 
   this->m_chartView->dateAxis()->setTitleText("Date (" +
                                               this->m_tz->abbreviation() + ")");
@@ -213,7 +215,7 @@ int Usgs::saveUSGSImage(QString filename, QString filter) {
     painter.begin(&printer);
 
     //...Page 1 - Chart
-    this->m_chartView->render(&painter);
+    this->m_chartView->renderChart(&painter);
 
     //...Page 2 - Map
     printer.newPage();
@@ -243,7 +245,7 @@ int Usgs::saveUSGSImage(QString filename, QString filter) {
                                 QPainter::TextAntialiasing |
                                 QPainter::SmoothPixmapTransform);
     this->m_quickMap->render(&imagePainter, QPoint(0, 0));
-    this->m_chartView->render(&imagePainter, chartRect);
+    this->m_chartView->renderChart(&imagePainter, chartRect);
 
     outputFile.open(QIODevice::WriteOnly);
     pixmap.save(&outputFile, "JPG", 100);
@@ -283,21 +285,7 @@ int Usgs::replotChart(Timezone *newTimezone) {
   int offset = newTimezone->utcOffset() * 1000;
   int totalOffset = -this->m_priorOffsetSeconds + offset;
 
-  QVector<QLineSeries *> series;
-  series.resize(this->m_chartView->chart()->series().length());
-
-  for (int i = 0; i < this->m_chartView->chart()->series().length(); i++) {
-    series[i] =
-        static_cast<QLineSeries *>(this->m_chartView->chart()->series().at(i));
-  }
-  for (int i = 0; i < series.length(); i++) {
-    QList<QPointF> data = series[i]->points();
-    series[i]->clear();
-    for (int j = 0; j < data.length(); j++) {
-      data[j].setX(data[j].x() + totalOffset);
-    }
-    series[i]->append(data);
-  }
+  this->m_chartView->offsetSeries(totalOffset);
 
   QDateTime minDateTime = QDateTime::fromMSecsSinceEpoch(
       this->m_allStationData->station(0)->date(0));
@@ -326,7 +314,7 @@ int Usgs::replotChart(Timezone *newTimezone) {
 
   this->m_chartView->update();
 
-  this->m_chartView->chart()->zoomReset();
+  this->m_chartView->resetZoom();
 
   return 0;
 }
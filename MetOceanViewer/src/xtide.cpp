@@ -144,12 +144,14 @@ int XTide::plotChart() {
   this->m_chartView->dateAxis()->setTitleText("Date (GMT)");
   this->m_chartView->yAxis()->setTitleText(this->m_ylabel);
 
+  QVector<QPointF> points;
+  points.reserve(this->m_data->station(0)->numSnaps());
   for (int i = 0; i < this->m_data->station(0)->numSnaps(); i++) {
-    series1->append(this->m_data->station(0)->date(i),
-                    this->m_data->station(0)->data(i) * multiplier);
+    points.push_back(QPointF(this->m_data->station(0)->date(i),
+                             this->m_data->station(0)->data(i) * multiplier));
   }
 
-  this->m_chartView->addSeries(series1, series1->name());
+  this->m_chartView->addSeries(series1, points, series1->name());
   this->m_chartView->chart()->setTitle("XTide Station: " +
                                        this->m_station.name());
 
@@ -184,7 +186,7 @@ int XTide::saveXTidePlot(QString filename, QString filter) {
     painter.begin(&printer);
 
     //...Page 1 - Chart
-    this->m_chartView->render(&painter);
+    this->m_chartView->renderChart(&painter);
 
     //...Page 2 - Map
     printer.newPage();
@@ -214,7 +216,7 @@ int XTide::saveXTidePlot(QString filename, QString filter) {
                                 QPainter::TextAntialiasing |
                                 QPainter::SmoothPixmapTransform);
     this->m_quickMap->render(&imagePainter, QPoint(0, 0));
-    this->m_chartView->render(&imagePainter, chartRect);
+    this->m_chartView->renderChart(&imagePainter, chartRect);
 
     outputFile.open(QIODevice::WriteOnly);
     pixmap.save(&outputFile, "JPG", 100);
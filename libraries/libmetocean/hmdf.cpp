@@ -21,8 +21,16 @@
 #include <QFile>
 #include <QFileInfo>
 #include <QHostInfo>
+#include <QThread>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
 #include <fstream>
+#include <thread>
 #include "hmdfasciiparser.h"
+#include "hmdfreader.h"
+#include "hmdfwriter.h"
 #include "netcdf.h"
 #include "netcdftimeseries.h"
 #include "stringutil.h"
@@ -33,7 +41,9 @@
     return ierr;          \
   }
 
-Hmdf::Hmdf(QObject *parent) : QObject(parent) {
+Hmdf::Hmdf(QObject *parent)
+    : QObject(parent),
+      m_store(QSharedPointer<HmdfColumnStore>(new HmdfColumnStore())) {
   this->setHeader1("");
   this->setHeader2("");
   this->setHeader3("");
@@ -41,6 +51,14 @@ Hmdf::Hmdf(QObject *parent) : QObject(parent) {
   this->setSuccess(false);
   this->setUnits("");
   this->setNull(true);
+  this->setImedsParser(HmdfParserFast);
+  this->setReadMode(HmdfReadParallel);
+  this->setReadThreads(0);
+  this->setWriteThreads(0);
+  this->setNetcdfFormat(HmdfNetcdf20181101);
+  this->setNetcdfProfile(HmdfProfileFast);
+  this->setNetcdfChunking(HmdfChunkStation);
+  this->setNetcdfPrecision(0.0);
   // this->m_tz = new Timezone(this);
 }
 
@@ -81,18 +99,28 @@ void Hmdf::setDatum(const QString &datum) { this->m_datum = datum; }
 
 HmdfStation *Hmdf::station(int index) {
   Q_ASSERT(index >= 0 && index < this->m_station.size());
-  return this->m_station[index];
+  return this->m_station[index].data();
+}
+
+//...Stations may be shared between several Hmdf objects. The first Hmdf a
+//   station is added to takes ownership and any others share it
+static QSharedPointer<HmdfStation> sharedStation(HmdfStation *station) {
+  QSharedPointer<HmdfStation> s = station->sharedFromThis();
+  if (s.isNull()) s = QSharedPointer<HmdfStation>(station);
+  return s;
 }
 
 void Hmdf::setStation(int index, HmdfStation *station) {
   Q_ASSERT(index >= 0 && index < this->m_station.size());
-  this->m_station[index] = station;
+  this->m_station[index] = sharedStation(station);
 }
 
 void Hmdf::addStation(HmdfStation *station) {
-  this->m_station.push_back(station);
+  this->m_station.push_back(sharedStation(station));
 }
 
+QSharedPointer<HmdfColumnStore> Hmdf::store() const { return this->m_store; }
+
 bool Hmdf::success() const { return this->m_success; }
 
 void Hmdf::setSuccess(bool success) { this->m_success = success; }
@@ -101,10 +129,211 @@ bool Hmdf::null() const { return this->m_null; }
 
 void Hmdf::setNull(bool null) { this->m_null = null; }
 
+Hmdf::HmdfImedsParser Hmdf::imedsParser() const { return this->m_imedsParser; }
+
+void Hmdf::setImedsParser(const HmdfImedsParser &imedsParser) {
+  this->m_imedsParser = imedsParser;
+}
+
+Hmdf::HmdfReadMode Hmdf::readMode() const { return this->m_readMode; }
+
+void Hmdf::setReadMode(const HmdfReadMode &readMode) {
+  this->m_readMode = readMode;
+}
+
+int Hmdf::readThreads() const { return this->m_readThreads; }
+
+//...Number of threads used by the parallel IMEDS reader. Zero selects the
+//   number of cores available
+void Hmdf::setReadThreads(int readThreads) {
+  this->m_readThreads = readThreads;
+}
+
+Hmdf::HmdfNetcdfFormat Hmdf::netcdfFormat() const {
+  return this->m_netcdfFormat;
+}
+
+void Hmdf::setNetcdfFormat(const HmdfNetcdfFormat &netcdfFormat) {
+  this->m_netcdfFormat = netcdfFormat;
+}
+
+Hmdf::HmdfNetcdfProfile Hmdf::netcdfProfile() const {
+  return this->m_netcdfProfile;
+}
+
+//...Compression used for netCDF output. None writes uncompressed data,
+//   fast uses shuffle with deflate level 1 and archival uses shuffle with
+//   deflate level 9
+void Hmdf::setNetcdfProfile(const HmdfNetcdfProfile &netcdfProfile) {
+  this->m_netcdfProfile = netcdfProfile;
+}
+
+Hmdf::HmdfNetcdfChunking Hmdf::netcdfChunking() const {
+  return this->m_netcdfChunking;
+}
+
+//...Chunk shape for 2D [station, time] output. Station chunks hold a whole
+//   station's series and suit reading one station at a time. Time chunks
+//   hold all stations over a short span of time and suit reading snapshots
+void Hmdf::setNetcdfChunking(const HmdfNetcdfChunking &netcdfChunking) {
+  this->m_netcdfChunking = netcdfChunking;
+}
+
+double Hmdf::netcdfPrecision() const { return this->m_netcdfPrecision; }
+
+//...Absolute precision that values are quantized to in netCDF output so
+//   that they compress better. Zero keeps the values unchanged
+void Hmdf::setNetcdfPrecision(double netcdfPrecision) {
+  this->m_netcdfPrecision = netcdfPrecision;
+}
+
+//...Sets chunking and compression for a variable. shape holds the lengths
+//   of the variable's dimensions. Chunks hold at most 64k values
+int Hmdf::defineNetcdfStorage(int ncid, int varid, int ndims,
+                              const size_t *shape, HmdfNetcdfProfile profile,
+                              HmdfNetcdfChunking chunking) {
+  const size_t chunkValues = 65536;
+  size_t chunk[2];
+  int ierr;
+
+  for (int i = 0; i < ndims; i++)
+    if (shape[i] == 0) return NC_NOERR;
+
+  if (ndims == 1) {
+    chunk[0] = std::min(shape[0], chunkValues);
+  } else if (chunking == HmdfChunkStation) {
+    chunk[0] = 1;
+    chunk[1] = std::min(shape[1], chunkValues);
+  } else {
+    chunk[0] = std::min(shape[0], chunkValues);
+    chunk[1] = std::max(std::min(shape[1], chunkValues / chunk[0]),
+                        static_cast<size_t>(1));
+  }
+
+  ierr = nc_def_var_chunking(ncid, varid, NC_CHUNKED, chunk);
+  if (ierr != NC_NOERR) return ierr;
+
+  if (profile == HmdfProfileFast) {
+    return nc_def_var_deflate(ncid, varid, 1, 1, 1);
+  } else if (profile == HmdfProfileArchival) {
+    return nc_def_var_deflate(ncid, varid, 1, 1, 9);
+  }
+  return NC_NOERR;
+}
+
+//...Rounds values to a multiple of the largest power of two not greater
+//   than precision. This clears the low mantissa bits so the values
+//   compress well and keeps each value within precision / 2
+void Hmdf::quantize(const double *in, size_t n, double precision,
+                    double *out) {
+  if (precision <= 0.0) {
+    if (out != in) memcpy(out, in, n * sizeof(double));
+    return;
+  }
+  int exponent = static_cast<int>(std::floor(std::log2(precision)));
+  double q = std::ldexp(1.0, exponent);
+  for (size_t i = 0; i < n; i++) {
+    out[i] = std::isfinite(in[i]) ? std::round(in[i] / q) * q : in[i];
+  }
+  return;
+}
+
+int Hmdf::writeThreads() const { return this->m_writeThreads; }
+
+//...Number of threads used to format IMEDS and CSV output. Zero selects the
+//   number of cores available
+void Hmdf::setWriteThreads(int writeThreads) {
+  this->m_writeThreads = writeThreads;
+}
+
+//...Parses one IMEDS record with the selected parser
+bool Hmdf::parseImedsRecord(HmdfImedsParser parser, const char *begin,
+                            const char *end, qint64 &date, double &value) {
+  if (parser == HmdfParserFast) {
+    long long msec;
+    if (!HmdfAsciiParser::splitStringHmdfFormat(begin, end, msec, value))
+      return false;
+    date = msec;
+    return true;
+  }
+
+  int year, month, day, hour, minute, second;
+  std::string line(begin, end);
+  if (!HmdfAsciiParser::splitStringHmdfFormat(line, year, month, day, hour,
+                                              minute, second, value))
+    return false;
+
+  QDateTime datetime;
+  datetime.setTimeSpec(Qt::UTC);
+  datetime.setDate(QDate(year, month, day));
+  datetime.setTime(QTime(hour, minute, second));
+  date = datetime.toMSecsSinceEpoch();
+  return true;
+}
+
+//...Returns the end of the line starting at pos (the newline or end of file)
+static const char *imedsLineEnd(const char *pos, const char *end) {
+  const char *eol = static_cast<const char *>(
+      memchr(pos, '\n', static_cast<size_t>(end - pos)));
+  return eol ? eol : end;
+}
+
+static const char *imedsNextLine(const char *eol, const char *end) {
+  return eol < end ? eol + 1 : end;
+}
+
+//...Cheap test used to find station boundaries. A line that fails this test
+//   can never parse as a record (the first field is not an integer or there
+//   are fewer than six fields), so it must be a station header
+static bool imedsRecordCandidate(const char *pos, const char *end) {
+  while (pos != end && (*pos == ' ' || *pos == '\t')) ++pos;
+  if (pos != end && (*pos == '-' || *pos == '+')) ++pos;
+  if (pos == end || *pos < '0' || *pos > '9') return false;
+  int nFields = 0;
+  bool inField = false;
+  for (; pos != end; ++pos) {
+    bool space = *pos == ' ' || *pos == '\t' || *pos == '\r';
+    if (!space && !inField) {
+      if (++nFields == 6) return true;
+    }
+    inField = !space;
+  }
+  return false;
+}
+
+static bool imedsBlankLine(const char *pos, const char *end) {
+  for (; pos != end; ++pos)
+    if (*pos != ' ' && *pos != '\t' && *pos != '\r') return false;
+  return true;
+}
+
+static void imedsStationHeader(const char *begin, const char *end,
+                               HmdfStation *station) {
+  std::string templine(begin, end);
+  templine = StringUtil::sanitizeString(templine);
+  QStringList templist =
+      QString::fromStdString(templine).split(" ", QString::SkipEmptyParts);
+  station->setName(templist.value(0));
+  station->setLongitude(templist.value(2).toDouble());
+  station->setLatitude(templist.value(1).toDouble());
+}
+
 int Hmdf::readImeds(QString filename) {
+  //...Pipes and other non-regular files cannot be mapped
+  if (this->m_readMode == HmdfReadParallel && QFileInfo(filename).isFile())
+    return this->readImedsParallel(filename);
+  return this->readImedsSequential(filename);
+}
+
+int Hmdf::readImedsSequential(QString filename) {
   std::fstream fid(filename.toStdString().c_str());
   if (fid.bad()) return -1;
 
+  //...Size the store from the file size so that it is allocated once. A
+  //   typical IMEDS record is a little over 40 bytes
+  qint64 fileSize = QFileInfo(filename).size();
+  if (fileSize > 0) this->m_store->reserve(0, fileSize / 40);
+
   //...Read Header
   std::string templine;
   std::getline(fid, templine);
@@ -117,39 +346,33 @@ int Hmdf::readImeds(QString filename) {
   this->m_header3 =
       QString::fromStdString(StringUtil::sanitizeString(templine));
 
-  //...Read Body
-  std::getline(fid, templine);
-
-  while (!fid.eof()) {
-    HmdfStation *station = new HmdfStation(this);
-
-    templine = StringUtil::sanitizeString(templine);
-
-    QStringList templist =
-        QString::fromStdString(templine).split(" ", QString::SkipEmptyParts);
-
-    station->setName(templist.at(0));
-    station->setLongitude(templist.at(2).toDouble());
-    station->setLatitude(templist.at(1).toDouble());
+  //...Read Body. Station boundaries are found exactly as in the parallel
+  //   reader: blank lines are skipped and any other line that does not
+  //   parse as a record starts a new station
+  bool haveLine = static_cast<bool>(std::getline(fid, templine));
+
+  while (haveLine) {
+    const char *begin = templine.data();
+    const char *end = begin + templine.size();
+    if (imedsBlankLine(begin, end)) {
+      haveLine = static_cast<bool>(std::getline(fid, templine));
+      continue;
+    }
 
-    while (true) {
-      std::getline(fid, templine);
+    HmdfStation *station = new HmdfStation(this->m_store);
+    imedsStationHeader(begin, end, station);
 
-      int year, month, day, hour, minute, second;
+    while ((haveLine = static_cast<bool>(std::getline(fid, templine)))) {
+      qint64 date;
       double value;
 
-      bool status = HmdfAsciiParser::splitStringHmdfFormat(
-          templine, year, month, day, hour, minute, second, value);
+      bool status = Hmdf::parseImedsRecord(
+          this->m_imedsParser, templine.data(),
+          templine.data() + templine.size(), date, value);
 
       if (status) {
-        QDateTime datetime;
-        datetime.setTimeSpec(Qt::UTC);
-        datetime.setDate(QDate(year, month, day));
-        datetime.setTime(QTime(hour, minute, second));
-        qint64 secs = datetime.toMSecsSinceEpoch();
-
         //...Append to the station data
-        station->setNext(secs, value);
+        station->setNext(date, value);
       } else {
         break;
       }
@@ -164,15 +387,130 @@ int Hmdf::readImeds(QString filename) {
   return 0;
 }
 
+//...Memory maps the file, splits the body into runs of whole stations at
+//   station header lines and parses the runs on a pool of threads. Each run
+//   is parsed exactly as the sequential reader would and the stations are
+//   added in file order once all threads have finished
+int Hmdf::readImedsParallel(QString filename) {
+  QFile file(filename);
+  if (!file.open(QIODevice::ReadOnly)) return -1;
+
+  qint64 size = file.size();
+  uchar *map = size > 0 ? file.map(0, size) : nullptr;
+  if (!map) {
+    file.close();
+    return this->readImedsSequential(filename);
+  }
+
+  const char *begin = reinterpret_cast<const char *>(map);
+  const char *end = begin + size;
+  const char *pos = begin;
+
+  //...Read Header
+  QString *header[3] = {&this->m_header1, &this->m_header2, &this->m_header3};
+  for (int i = 0; i < 3; i++) {
+    const char *eol = imedsLineEnd(pos, end);
+    std::string templine(pos, eol);
+    *(header[i]) = QString::fromStdString(StringUtil::sanitizeString(templine));
+    pos = imedsNextLine(eol, end);
+  }
+
+  int nThreads = this->m_readThreads > 0 ? this->m_readThreads
+                                         : QThread::idealThreadCount();
+  nThreads = std::max(nThreads, 1);
+
+  //...Split the body at the first station header after evenly spaced
+  //   offsets. Several runs per thread keep the threads busy when station
+  //   sizes are uneven
+  std::vector<const char *> runStart;
+  runStart.push_back(pos);
+  size_t nRuns = static_cast<size_t>(nThreads) * 4;
+  for (size_t k = 1; k < nRuns; k++) {
+    const char *p = pos + (end - pos) * k / nRuns;
+    if (p <= runStart.back()) continue;
+    p = imedsNextLine(imedsLineEnd(p, end), end);
+    while (p < end) {
+      const char *eol = imedsLineEnd(p, end);
+      if (!imedsRecordCandidate(p, eol)) break;
+      p = imedsNextLine(eol, end);
+    }
+    if (p >= end) break;
+    if (p > runStart.back()) runStart.push_back(p);
+  }
+  runStart.push_back(end);
+
+  struct ImedsRun {
+    QSharedPointer<HmdfColumnStore> store;
+    std::vector<HmdfStation *> stations;
+  };
+  size_t nRun = runStart.size() - 1;
+  std::vector<ImedsRun> runs(nRun);
+  std::atomic<size_t> nextRun(0);
+
+  auto worker = [&]() {
+    for (size_t r = nextRun++; r < nRun; r = nextRun++) {
+      const char *p = runStart[r];
+      const char *runEnd = runStart[r + 1];
+
+      runs[r].store = QSharedPointer<HmdfColumnStore>(new HmdfColumnStore());
+      runs[r].store->reserve(0, static_cast<size_t>(runEnd - p) / 40);
+
+      while (p < runEnd) {
+        const char *eol = imedsLineEnd(p, runEnd);
+        if (imedsBlankLine(p, eol)) {
+          p = imedsNextLine(eol, runEnd);
+          continue;
+        }
+
+        HmdfStation *station = new HmdfStation(runs[r].store);
+        imedsStationHeader(p, eol, station);
+        p = imedsNextLine(eol, runEnd);
+
+        while (p < runEnd) {
+          qint64 date;
+          double value;
+          eol = imedsLineEnd(p, runEnd);
+          if (!Hmdf::parseImedsRecord(this->m_imedsParser, p, eol, date,
+                                      value))
+            break;
+          station->setNext(date, value);
+          p = imedsNextLine(eol, runEnd);
+        }
+        runs[r].stations.push_back(station);
+      }
+    }
+  };
+
+  std::vector<std::thread> threads;
+  size_t nWorkers = std::min(static_cast<size_t>(nThreads), nRun);
+  for (size_t i = 1; i < nWorkers; i++) threads.push_back(std::thread(worker));
+  worker();
+  for (size_t i = 0; i < threads.size(); i++) threads[i].join();
+
+  file.unmap(map);
+  file.close();
+
+  for (size_t r = 0; r < nRun; r++) {
+    for (size_t s = 0; s < runs[r].stations.size(); s++) {
+      this->addStation(runs[r].stations[s]);
+    }
+  }
+
+  this->setNull(false);
+
+  return 0;
+}
+
 int Hmdf::readNetcdf(QString filename) {
+  return this->readNetcdf(filename, QStringList());
+}
+
+//...Reads only the named stations, or every station when the list is empty
+int Hmdf::readNetcdf(QString filename, const QStringList &stations) {
   NetcdfTimeseries *ncts = new NetcdfTimeseries(this);
   ncts->setFilename(filename);
-  int ierr = ncts->read();
-  if (ierr != 0) {
-    delete ncts;
-    return 1;
-  }
-  ierr = ncts->toHmdf(this);
+  ncts->setStationNames(stations);
+  int ierr = ncts->read(this);
   delete ncts;
 
   if (ierr != 0) return 1;
@@ -183,100 +521,143 @@ int Hmdf::readNetcdf(QString filename) {
 }
 
 int Hmdf::writeCsv(QString filename) {
-  int i, s;
-  QString value;
-  QFile output(filename);
-
-  if (!output.open(QIODevice::WriteOnly)) return -1;
-
-  for (s = 0; s < this->nstations(); s++) {
-    output.write(
-        QString("Station: " + this->station(s)->name() + "\n").toUtf8());
-    output.write(QString("Datum: " + this->datum() + "\n").toUtf8());
-    output.write(QString("Units: " + this->units() + "\n").toUtf8());
-    output.write(QString("\n").toUtf8());
-    for (i = 0; i < this->station(s)->numSnaps(); i++) {
-      QDateTime d = QDateTime::fromMSecsSinceEpoch(this->station(s)->date(i));
-      d.setTimeSpec(Qt::UTC);
-      if (d.isValid()) {
-        value.sprintf("%10.4e", this->station(s)->data(i));
-        output.write(
-            QString(d.toString("MM/dd/yyyy,hh:mm,") + value + "\n").toUtf8());
-      }
-    }
-    output.write(QString("\n\n\n").toUtf8());
-  }
-  output.close();
-  return 0;
+  return this->writeStations(filename, HmdfCsv);
 }
 
 int Hmdf::writeImeds(QString filename) {
-  QString value;
-  QFile outputFile(filename);
-
-  if (!outputFile.open(QIODevice::WriteOnly)) return -1;
-
-  outputFile.write(QString("% IMEDS generic format\n").toUtf8());
-  outputFile.write(QString("% year month day hour min sec value\n").toUtf8());
-  outputFile.write(QString("MetOceanViewer    UTC    " + this->datum() + "   " +
-                           this->units() + "\n")
-                       .toUtf8());
-
-  for (int s = 0; s < this->nstations(); s++) {
-    QString stationName =
-        this->station(s)->name().replace(" ", "_").replace(",", "_").replace(
-            "__", "_");
-    outputFile.write(
-        QString(stationName + "   " +
-                QString::number(this->station(s)->latitude()) + "   " +
-                QString::number(this->station(s)->longitude()) + "\n")
-            .toUtf8());
-
-    for (int i = 0; i < this->station(s)->numSnaps(); i++) {
-      QDateTime d = QDateTime::fromMSecsSinceEpoch(this->station(s)->date(i));
-      d.setTimeSpec(Qt::UTC);
-
-      if (d.isValid()) {
-        value.sprintf("%10.4e", this->station(s)->data(i));
-        outputFile.write(
-            QString(d.toString("yyyy    MM    dd    hh    mm    ss") + "    " +
-                    value + "\n")
-                .toUtf8());
-      }
-    }
+  return this->writeStations(filename, HmdfImeds);
+}
+
+int Hmdf::writeStations(QString filename, HmdfFileType fileType) {
+  HmdfWriter writer;
+  writer.setFilename(filename);
+  writer.setFileType(fileType);
+  writer.setDatum(this->datum());
+  writer.setUnits(this->units());
+  writer.setThreads(this->m_writeThreads);
+  writer.setNetcdfProfile(this->m_netcdfProfile);
+  writer.setNetcdfChunking(this->m_netcdfChunking);
+  writer.setNetcdfPrecision(this->m_netcdfPrecision);
+
+  int ierr = writer.open();
+  if (ierr != 0) return ierr;
+
+  QVector<HmdfStation *> stations(this->m_station.size());
+  for (int s = 0; s < this->m_station.size(); s++)
+    stations[s] = this->m_station[s].data();
+
+  ierr = writer.write(stations);
+  if (ierr != 0) return ierr;
+
+  return writer.close();
+}
+
+int Hmdf::convert(QString inputFile, QString outputFile) {
+  return Hmdf::convert(inputFile, outputFile, HmdfConvertOptions());
+}
+
+//...Converts between any of the readable and writable formats one station
+//   at a time so that files larger than memory can be converted
+int Hmdf::convert(QString inputFile, QString outputFile,
+                  const HmdfConvertOptions &options) {
+  HmdfReader reader;
+  reader.setFilename(inputFile);
+  reader.setImedsParser(options.imedsParser);
+  int ierr = reader.open();
+  if (ierr != 0) return ierr;
+
+  QString suffix = QFileInfo(outputFile).suffix().toLower();
+  HmdfWriter writer;
+  writer.setFilename(outputFile);
+  if (suffix == "imeds") {
+    writer.setFileType(HmdfImeds);
+  } else if (suffix == "csv") {
+    writer.setFileType(HmdfCsv);
+  } else if (suffix == "nc") {
+    writer.setFileType(HmdfNetCdf);
+  } else {
+    return 1;
   }
-  outputFile.close();
-  return 0;
+  writer.setDatum(reader.datum());
+  writer.setUnits(reader.units());
+  writer.setThreads(options.writeThreads);
+  writer.setNetcdfProfile(options.netcdfProfile);
+  writer.setNetcdfChunking(options.netcdfChunking);
+  writer.setNetcdfPrecision(options.netcdfPrecision);
+
+  ierr = writer.open();
+  if (ierr != 0) return ierr;
+
+  HmdfStation *station;
+  while ((station = reader.next()) != nullptr) {
+    ierr = writer.write(station);
+    delete station;
+    if (ierr != 0) return ierr;
+  }
+
+  if (reader.error()) return 1;
+
+  return writer.close();
 }
 
 int Hmdf::writeNetcdf(QString filename) {
+  if (this->m_netcdfFormat == HmdfNetcdf20180123)
+    return this->writeNetcdf20180123(filename);
+  return this->writeNetcdf20181101(filename);
+}
+
+//...Original layout with a dimension and a pair of variables per station
+int Hmdf::writeNetcdf20180123(QString filename) {
+  return this->writeStations(filename, HmdfNetCdf);
+}
+
+//...Layout with all stations in a handful of variables. When every station
+//   has the same times, values are stored in a 2D [station, time] variable
+//   with a single shared time variable. Otherwise the stations are stored as
+//   a CF contiguous ragged array with per station counts in stationLength
+int Hmdf::writeNetcdf20181101(QString filename) {
   int ncid;
-  int dimid_nstations, dimid_stationNameLength;
-  int varid_stationName, varid_stationx, varid_stationy;
-  int varid_stationId;
+  int dimid_nstations, dimid_stationNameLength, dimid_obs;
+  int varid_stationName, varid_stationx, varid_stationy, varid_stationId;
+  int varid_stationLength = -1, varid_time, varid_data;
+  size_t nstations = this->nstations();
+
+  //...Check if all stations share the same times
+  bool sharedTime = nstations > 0;
+  size_t nobs = 0;
+  for (size_t i = 0; i < nstations; i++) {
+    HmdfSpan<const qint64> date = this->m_station[i]->dateSpan();
+    HmdfSpan<const qint64> date0 = this->m_station[0]->dateSpan();
+    nobs += date.size();
+    if (sharedTime &&
+        (date.size() != date0.size() ||
+         memcmp(date.data(), date0.data(), date.size() * sizeof(qint64)) != 0))
+      sharedTime = false;
+  }
+  size_t ntimes = sharedTime ? this->m_station[0]->numSnaps() : nobs;
 
-  QVector<int> dimid_stationLength;
-  QVector<int> varid_stationDate, varid_stationData;
+  //...A zero length dimension would be defined as unlimited, so there has
+  //   to be something to write
+  if (nstations == 0 || ntimes == 0) return 1;
 
-  //...Open file
   NCCHECK(nc_create(filename.toStdString().c_str(), NC_NETCDF4, &ncid));
 
   //...Dimensions
-  NCCHECK(nc_def_dim(ncid, "numStations", this->nstations(), &dimid_nstations));
+  NCCHECK(nc_def_dim(ncid, "numStations", nstations, &dimid_nstations));
   NCCHECK(nc_def_dim(ncid, "stationNameLen", 200, &dimid_stationNameLength));
-  for (int i = 0; i < this->nstations(); i++) {
-    QString dimname;
-    int d;
-    dimname.sprintf("%s%4.4i", "stationLength_", i + 1);
-    NCCHECK(nc_def_dim(ncid, dimname.toStdString().c_str(),
-                       this->station(i)->numSnaps(), &d));
-    dimid_stationLength.push_back(d);
-  }
+  NCCHECK(nc_def_dim(ncid, sharedTime ? "numTimes" : "numObservations", ntimes,
+                     &dimid_obs));
 
   //...Variables
   int stationNameDims[2] = {dimid_nstations, dimid_stationNameLength};
   int nstationDims[1] = {dimid_nstations};
+  int obsDims[1] = {dimid_obs};
+  int dataDims[2] = {dimid_nstations, dimid_obs};
   int wgs84[1] = {4326};
+  char epoch[20] = "1970-01-01 00:00:00";
+  char utc[4] = "utc";
+  QString timeUnits = "seconds since 1970-01-01 00:00:00";
+  QString obsName = sharedTime ? "numTimes" : "numObservations";
 
   NCCHECK(nc_def_var(ncid, "stationName", NC_CHAR, 2, stationNameDims,
                      &varid_stationName));
@@ -286,56 +667,49 @@ int Hmdf::writeNetcdf(QString filename) {
                      &varid_stationx));
   NCCHECK(nc_def_var(ncid, "stationYCoordinate", NC_DOUBLE, 1, nstationDims,
                      &varid_stationy));
+  NCCHECK(nc_put_att_text(ncid, varid_stationName, "cf_role", 13,
+                          "timeseries_id"));
 
   NCCHECK(nc_put_att_text(ncid, varid_stationx, "HorizontalProjectionName", 5,
                           "WGS84"));
   NCCHECK(nc_put_att_text(ncid, varid_stationy, "HorizontalProjectionName", 5,
                           "WGS84"));
-
   NCCHECK(nc_put_att_int(ncid, varid_stationx, "HorizontalProjectionEPSG",
                          NC_INT, 1, wgs84));
   NCCHECK(nc_put_att_int(ncid, varid_stationy, "HorizontalProjectionEPSG",
                          NC_INT, 1, wgs84));
 
-  for (int i = 0; i < this->nstations(); i++) {
-    QString stationName, timeVarName, dataVarName;
-    int d[1] = {dimid_stationLength[i]};
-    char epoch[20] = "1970-01-01 00:00:00";
-    char utc[4] = "utc";
-    int v;
-
-    stationName.sprintf("%s%4.4i", "station_", i + 1);
-    timeVarName = "time_" + stationName;
-    dataVarName = "data_" + stationName;
-
-    NCCHECK(nc_def_var(ncid, timeVarName.toStdString().c_str(), NC_INT64, 1, d,
-                       &v));
-    NCCHECK(nc_put_att_text(ncid, v, "referenceDate", 20, epoch));
-    NCCHECK(nc_put_att_text(ncid, v, "timezone", 3, utc));
-    NCCHECK(nc_put_att_text(ncid, v, "StationName",
-                            this->station(i)->name().length(),
-                            this->station(i)->name().toStdString().c_str()));
-
-    NCCHECK(nc_def_var_deflate(ncid, v, 1, 1, 2));
-    NCCHECK(nc_put_att_text(ncid, v, "StationName",
-                            this->station(i)->name().length(),
-                            this->station(i)->name().toStdString().c_str()));
-    NCCHECK(nc_put_att_text(ncid, v, "StationID",
-                            this->station(i)->id().length(),
-                            this->station(i)->id().toStdString().c_str()));
-    NCCHECK(nc_def_var_deflate(ncid, v, 1, 1, 2));
-    varid_stationDate.push_back(v);
-
-    NCCHECK(nc_def_var(ncid, dataVarName.toStdString().c_str(), NC_DOUBLE, 1, d,
-                       &v));
-    NCCHECK(nc_def_var_deflate(ncid, v, 1, 1, 2));
-    NCCHECK(nc_put_att_text(ncid, v, "units", this->units().length(),
-                            this->units().toStdString().c_str()));
-    NCCHECK(nc_put_att_text(ncid, v, "datum", this->datum().length(),
-                            this->datum().toStdString().c_str()));
-    varid_stationData.push_back(v);
+  if (!sharedTime) {
+    NCCHECK(nc_def_var(ncid, "stationLength", NC_INT64, 1, nstationDims,
+                       &varid_stationLength));
+    NCCHECK(nc_put_att_text(ncid, varid_stationLength, "sample_dimension",
+                            obsName.length(),
+                            obsName.toStdString().c_str()));
   }
 
+  NCCHECK(nc_def_var(ncid, "time", NC_INT64, 1, obsDims, &varid_time));
+  NCCHECK(nc_put_att_text(ncid, varid_time, "units", timeUnits.length(),
+                          timeUnits.toStdString().c_str()));
+  NCCHECK(nc_put_att_text(ncid, varid_time, "referenceDate", 20, epoch));
+  NCCHECK(nc_put_att_text(ncid, varid_time, "timezone", 3, utc));
+  NCCHECK(this->defineNetcdfStorage(ncid, varid_time, 1, &ntimes,
+                                    this->m_netcdfProfile,
+                                    this->m_netcdfChunking));
+
+  size_t dataShape[2] = {nstations, ntimes};
+  NCCHECK(nc_def_var(ncid, "data", NC_DOUBLE, sharedTime ? 2 : 1,
+                     sharedTime ? dataDims : obsDims, &varid_data));
+  NCCHECK(this->defineNetcdfStorage(
+      ncid, varid_data, sharedTime ? 2 : 1, sharedTime ? dataShape : &ntimes,
+      this->m_netcdfProfile, this->m_netcdfChunking));
+  if (this->m_netcdfPrecision > 0.0)
+    NCCHECK(nc_put_att_double(ncid, varid_data, "quantization_precision",
+                              NC_DOUBLE, 1, &this->m_netcdfPrecision));
+  NCCHECK(nc_put_att_text(ncid, varid_data, "units", this->units().length(),
+                          this->units().toStdString().c_str()));
+  NCCHECK(nc_put_att_text(ncid, varid_data, "datum", this->datum().length(),
+                          this->datum().toStdString().c_str()));
+
   //...Metadata
   QString name = qgetenv("USER");
   if (name.isEmpty()) name = qgetenv("USERNAME");
@@ -344,7 +718,8 @@ int Hmdf::writeNetcdf(QString filename) {
       QDateTime::currentDateTimeUtc().toString("yyyy-MM-dd hh:mm:ss");
   QString source = "MetOceanViewer";
   QString ncVersion = QString(nc_inq_libvers());
-  QString format = "20180123";
+  QString format = "20181101";
+  QString featureType = "timeSeries";
 
   NCCHECK(nc_put_att(ncid, NC_GLOBAL, "source", NC_CHAR, source.length(),
                      source.toStdString().c_str()));
@@ -358,99 +733,68 @@ int Hmdf::writeNetcdf(QString filename) {
                      ncVersion.length(), ncVersion.toStdString().c_str()));
   NCCHECK(nc_put_att(ncid, NC_GLOBAL, "fileformat", NC_CHAR, format.length(),
                      format.toStdString().c_str()));
+  NCCHECK(nc_put_att(ncid, NC_GLOBAL, "featureType", NC_CHAR,
+                     featureType.length(), featureType.toStdString().c_str()));
 
   NCCHECK(nc_enddef(ncid));
 
-  for (int i = 0; i < this->nstations(); i++) {
-    size_t index[2] = {i, 0};
-    size_t stindex[1] = {i};
-    size_t count[2] = {1, 200};
-    double lat[1] = {this->station(i)->latitude()};
-    double lon[1] = {this->station(i)->longitude()};
-
-    long long *time =
-        (long long *)malloc(this->station(i)->numSnaps() * sizeof(long long));
-    double *data =
-        (double *)malloc(this->station(i)->numSnaps() * sizeof(double));
-    char *name = (char *)malloc(200 * sizeof(char));
-    char *id = (char *)malloc(200 * sizeof(char));
-    memset(name, ' ', 200);
-    memset(id, ' ', 200);
-    this->station(i)->name().toStdString().copy(name, 200, 0);
-    this->station(i)->id().toStdString().copy(id, 200, 0);
-
-    for (int j = 0; j < this->station(i)->numSnaps(); j++) {
-      time[j] = this->station(i)->date(j) / 1000;
-      data[j] = this->station(i)->data(j);
-    }
-
-    int status = nc_put_var1_double(ncid, varid_stationx, stindex, lon);
-    if (status != NC_NOERR) {
-      free(time);
-      free(data);
-      free(name);
-      free(id);
-      nc_close(ncid);
-      return status;
-    }
-
-    status = nc_put_var1_double(ncid, varid_stationy, stindex, lat);
-    if (status != NC_NOERR) {
-      free(time);
-      free(data);
-      free(name);
-      free(id);
-      nc_close(ncid);
-      return status;
-    }
-
-    status = nc_put_var_longlong(ncid, varid_stationDate[i], time);
-    if (status != NC_NOERR) {
-      free(time);
-      free(data);
-      free(name);
-      free(id);
-      nc_close(ncid);
-      return status;
-    }
+  //...Station metadata in one call per variable
+  std::vector<double> x(nstations), y(nstations);
+  std::vector<long long> length(nstations);
+  std::vector<char> names(nstations * 200, ' '), ids(nstations * 200, ' ');
+  for (size_t i = 0; i < nstations; i++) {
+    x[i] = this->m_station[i]->longitude();
+    y[i] = this->m_station[i]->latitude();
+    length[i] = static_cast<long long>(this->m_station[i]->numSnaps());
+    this->m_station[i]->name().toStdString().copy(&names[i * 200], 200, 0);
+    this->m_station[i]->id().toStdString().copy(&ids[i * 200], 200, 0);
+  }
 
-    status = nc_put_var_double(ncid, varid_stationData[i], data);
-    if (status != NC_NOERR) {
-      free(time);
-      free(data);
-      free(name);
-      free(id);
-      nc_close(ncid);
-      return status;
-    }
+  if (nstations > 0) {
+    NCCHECK(nc_put_var_double(ncid, varid_stationx, x.data()));
+    NCCHECK(nc_put_var_double(ncid, varid_stationy, y.data()));
+    NCCHECK(nc_put_var_text(ncid, varid_stationName, names.data()));
+    NCCHECK(nc_put_var_text(ncid, varid_stationId, ids.data()));
+    if (!sharedTime)
+      NCCHECK(nc_put_var_longlong(ncid, varid_stationLength, length.data()));
+  }
 
-    status = nc_put_vara_text(ncid, varid_stationName, index, count, name);
-    if (status != NC_NOERR) {
-      free(time);
-      free(data);
-      free(name);
-      free(id);
-      nc_close(ncid);
-      return status;
+  //...Series are written one station at a time into their slice of the
+  //   shared variables so only one station's times are converted at once
+  std::vector<long long> time;
+  std::vector<double> data;
+  size_t offset = 0;
+  for (size_t i = 0; i < nstations; i++) {
+    HmdfSpan<const qint64> date = this->m_station[i]->dateSpan();
+    HmdfSpan<const double> values = this->m_station[i]->dataSpan();
+    if (date.empty()) continue;
+
+    data.resize(values.size());
+    Hmdf::quantize(values.data(), values.size(), this->m_netcdfPrecision,
+                   data.data());
+
+    if (!sharedTime || i == 0) {
+      time.resize(date.size());
+      for (size_t j = 0; j < date.size(); j++) time[j] = date[j] / 1000;
+      size_t start[1] = {sharedTime ? 0 : offset};
+      size_t count[1] = {date.size()};
+      NCCHECK(
+          nc_put_vara_longlong(ncid, varid_time, start, count, time.data()));
     }
 
-    status = nc_put_vara_text(ncid, varid_stationId, index, count, id);
-    if (status != NC_NOERR) {
-      free(time);
-      free(data);
-      free(name);
-      free(id);
-      nc_close(ncid);
-      return status;
+    if (sharedTime) {
+      size_t start[2] = {i, 0};
+      size_t count[2] = {1, data.size()};
+      NCCHECK(nc_put_vara_double(ncid, varid_data, start, count, data.data()));
+    } else {
+      size_t start[1] = {offset};
+      size_t count[1] = {data.size()};
+      NCCHECK(nc_put_vara_double(ncid, varid_data, start, count, data.data()));
     }
-
-    free(time);
-    free(data);
-    free(name);
-    free(id);
+    offset += date.size();
   }
 
-  nc_close(ncid);
+  NCCHECK(nc_close(ncid));
 
   return 0;
 }
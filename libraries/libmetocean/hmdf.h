@@ -22,12 +22,14 @@
 
 #include <QDateTime>
 #include <QObject>
+#include <QSharedPointer>
 #include <QString>
 #include <QStringList>
 #include <QVector>
 #include <ctime>
 #include <string>
 #include <vector>
+#include "hmdfcolumnstore.h"
 #include "hmdfstation.h"
 #include "metocean_global.h"
 #include "timezone.h"
@@ -42,14 +44,42 @@ class Hmdf : public QObject {
 
   enum HmdfFileType { HmdfImeds, HmdfCsv, HmdfNetCdf };
 
+  enum HmdfImedsParser { HmdfParserSpirit, HmdfParserFast };
+
+  enum HmdfReadMode { HmdfReadSequential, HmdfReadParallel };
+
+  enum HmdfNetcdfFormat { HmdfNetcdf20180123, HmdfNetcdf20181101 };
+
+  enum HmdfNetcdfProfile {
+    HmdfProfileNone,
+    HmdfProfileFast,
+    HmdfProfileArchival
+  };
+
+  enum HmdfNetcdfChunking { HmdfChunkStation, HmdfChunkTime };
+
+  //...Settings used by convert for reading and writing
+  struct HmdfConvertOptions {
+    HmdfImedsParser imedsParser = HmdfParserFast;
+    HmdfNetcdfProfile netcdfProfile = HmdfProfileFast;
+    HmdfNetcdfChunking netcdfChunking = HmdfChunkStation;
+    double netcdfPrecision = 0.0;
+    int writeThreads = 0;
+  };
+
   int write(QString filename, HmdfFileType fileType);
   int write(QString filename);
   int writeImeds(QString filename);
   int writeCsv(QString filename);
   int writeNetcdf(QString filename);
 
+  static int convert(QString inputFile, QString outputFile);
+  static int convert(QString inputFile, QString outputFile,
+                     const HmdfConvertOptions &options);
+
   int readImeds(QString filename);
   int readNetcdf(QString filename);
+  int readNetcdf(QString filename, const QStringList &stations);
 
   size_t nstations() const;
   // void setNstations(size_t nstations);
@@ -73,6 +103,8 @@ class Hmdf : public QObject {
   void setStation(int index, HmdfStation *station);
   void addStation(HmdfStation *station);
 
+  QSharedPointer<HmdfColumnStore> store() const;
+
   bool success() const;
   void setSuccess(bool success);
 
@@ -82,9 +114,56 @@ class Hmdf : public QObject {
   void dataBounds(qint64 &dateMin, qint64 &dateMax, double &minValue,
                   double &maxValue);
 
+  HmdfImedsParser imedsParser() const;
+  void setImedsParser(const HmdfImedsParser &imedsParser);
+
+  HmdfReadMode readMode() const;
+  void setReadMode(const HmdfReadMode &readMode);
+
+  int readThreads() const;
+  void setReadThreads(int readThreads);
+
+  int writeThreads() const;
+  void setWriteThreads(int writeThreads);
+
+  HmdfNetcdfFormat netcdfFormat() const;
+  void setNetcdfFormat(const HmdfNetcdfFormat &netcdfFormat);
+
+  HmdfNetcdfProfile netcdfProfile() const;
+  void setNetcdfProfile(const HmdfNetcdfProfile &netcdfProfile);
+
+  HmdfNetcdfChunking netcdfChunking() const;
+  void setNetcdfChunking(const HmdfNetcdfChunking &netcdfChunking);
+
+  double netcdfPrecision() const;
+  void setNetcdfPrecision(double netcdfPrecision);
+
+  static int defineNetcdfStorage(int ncid, int varid, int ndims,
+                                 const size_t *shape,
+                                 HmdfNetcdfProfile profile,
+                                 HmdfNetcdfChunking chunking);
+  static void quantize(const double *in, size_t n, double precision,
+                       double *out);
+  static bool parseImedsRecord(HmdfImedsParser parser, const char *begin,
+                               const char *end, qint64 &date, double &value);
+
  private:
+  int writeStations(QString filename, HmdfFileType fileType);
+  int writeNetcdf20180123(QString filename);
+  int writeNetcdf20181101(QString filename);
+  int readImedsSequential(QString filename);
+  int readImedsParallel(QString filename);
+
   //...Variables
   bool m_success, m_null;
+  HmdfImedsParser m_imedsParser;
+  HmdfReadMode m_readMode;
+  int m_readThreads;
+  int m_writeThreads;
+  HmdfNetcdfFormat m_netcdfFormat;
+  HmdfNetcdfProfile m_netcdfProfile;
+  HmdfNetcdfChunking m_netcdfChunking;
+  double m_netcdfPrecision;
 
   Timezone m_tz;
   QString m_header1;
@@ -92,7 +171,8 @@ class Hmdf : public QObject {
   QString m_header3;
   QString m_units;
   QString m_datum;
-  QVector<HmdfStation *> m_station;
+  QSharedPointer<HmdfColumnStore> m_store;
+  QVector<QSharedPointer<HmdfStation> > m_station;
 };
 
 #endif  // HMDF_H
@@ -18,6 +18,8 @@
 //
 //-----------------------------------------------------------------------*/
 #include "hmdfasciiparser.h"
+#include <locale>
+#include <sstream>
 #include "boost/config/warning_disable.hpp"
 #include "boost/fusion/include/adapt_struct.hpp"
 #include "boost/fusion/include/io.hpp"
@@ -130,3 +132,189 @@ bool HmdfAsciiParser::splitStringHmdfFormat(std::string &data, int &yr, int &mon
     }
   }
 }
+
+//--FAST TOKENIZER--//
+
+//...Single pass, allocation free parser for one IMEDS record held in the
+//   byte range [begin, end). The record may contain six (no seconds) or
+//   seven numeric fields
+
+static inline bool isHmdfSpace(char c) {
+  return c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == '\v' ||
+         c == '\f';
+}
+
+static inline void skipHmdfSpace(const char *&pos, const char *end) {
+  while (pos != end && isHmdfSpace(*pos)) ++pos;
+}
+
+bool HmdfAsciiParser::parseInt(const char *&pos, const char *end,
+                               int &value) {
+  const char *p = pos;
+  bool negative = false;
+  if (p != end && (*p == '-' || *p == '+')) {
+    negative = *p == '-';
+    ++p;
+  }
+  if (p == end || *p < '0' || *p > '9') return false;
+  long long v = 0;
+  while (p != end && *p >= '0' && *p <= '9') {
+    v = v * 10 + (*p - '0');
+    if (v > 2147483647LL) return false;
+    ++p;
+  }
+  value = negative ? -static_cast<int>(v) : static_cast<int>(v);
+  pos = p;
+  return true;
+}
+
+bool HmdfAsciiParser::parseDouble(const char *&pos, const char *end,
+                                  double &value) {
+  //...Powers of ten that are exactly representable as a double
+  static const double pow10[] = {1e0,  1e1,  1e2,  1e3,  1e4,  1e5,
+                                 1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+                                 1e12, 1e13, 1e14, 1e15, 1e16, 1e17,
+                                 1e18, 1e19, 1e20, 1e21, 1e22};
+
+  const char *p = pos;
+  bool negative = false;
+  if (p != end && (*p == '-' || *p == '+')) {
+    negative = *p == '-';
+    ++p;
+  }
+
+  unsigned long long mantissa = 0;
+  int nDigits = 0, exponent = 0;
+  bool anyDigits = false;
+
+  while (p != end && *p >= '0' && *p <= '9') {
+    anyDigits = true;
+    if (nDigits < 19) {
+      mantissa = mantissa * 10 + (*p - '0');
+      if (mantissa != 0) nDigits++;
+    } else {
+      exponent++;
+    }
+    ++p;
+  }
+
+  if (p != end && *p == '.') {
+    ++p;
+    while (p != end && *p >= '0' && *p <= '9') {
+      anyDigits = true;
+      if (nDigits < 19) {
+        mantissa = mantissa * 10 + (*p - '0');
+        if (mantissa != 0) nDigits++;
+        exponent--;
+      }
+      ++p;
+    }
+  }
+
+  if (!anyDigits) return false;
+
+  if (p != end && (*p == 'e' || *p == 'E' || *p == 'd' || *p == 'D')) {
+    const char *q = p + 1;
+    int e;
+    if (HmdfAsciiParser::parseInt(q, end, e)) {
+      exponent += e;
+      p = q;
+    }
+  }
+
+  //...The fast path is exact when the mantissa fits in the 53 bit
+  //   significand and the power of ten is exactly representable. Anything
+  //   else goes through the (locale independent) stream parser, which does
+  //   not know the Fortran 'd' exponent, so it is rewritten as 'e' first
+  if (mantissa < (1ULL << 53) && exponent >= -22 && exponent <= 22) {
+    double v = static_cast<double>(mantissa);
+    if (exponent < 0)
+      v /= pow10[-exponent];
+    else
+      v *= pow10[exponent];
+    value = negative ? -v : v;
+  } else {
+    std::string token(pos, p);
+    for (char &c : token) {
+      if (c == 'd' || c == 'D') c = 'e';
+    }
+    std::istringstream s(token);
+    s.imbue(std::locale::classic());
+    s >> value;
+    if (s.fail()) return false;
+  }
+
+  pos = p;
+  return true;
+}
+
+//...Milliseconds since 1970-01-01 00:00:00 UTC using the civil (proleptic
+//   Gregorian) calendar, without going through QDateTime
+long long HmdfAsciiParser::toMSecsSinceEpoch(int yr, int month, int day,
+                                             int hr, int min, int sec) {
+  long long y = month <= 2 ? yr - 1 : yr;
+  long long era = (y >= 0 ? y : y - 399) / 400;
+  long long yoe = y - era * 400;
+  long long doy = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+  long long doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+  long long days = era * 146097 + doe - 719468;
+  return ((days * 24 + hr) * 60 + min) * 60000LL + sec * 1000LL;
+}
+
+//...Inverse of toMSecsSinceEpoch. Milliseconds are truncated toward the
+//   start of the second, as QDateTime does when formatting
+void HmdfAsciiParser::fromMSecsSinceEpoch(long long msecSinceEpoch, int &yr,
+                                          int &month, int &day, int &hr,
+                                          int &min, int &sec) {
+  long long secs = msecSinceEpoch >= 0 ? msecSinceEpoch / 1000
+                                       : (msecSinceEpoch - 999) / 1000;
+  long long days = secs >= 0 ? secs / 86400 : (secs - 86399) / 86400;
+  long long sod = secs - days * 86400;
+  hr = static_cast<int>(sod / 3600);
+  min = static_cast<int>((sod % 3600) / 60);
+  sec = static_cast<int>(sod % 60);
+
+  days += 719468;
+  long long era = (days >= 0 ? days : days - 146096) / 146097;
+  long long doe = days - era * 146097;
+  long long yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+  long long doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+  long long mp = (5 * doy + 2) / 153;
+  day = static_cast<int>(doy - (153 * mp + 2) / 5 + 1);
+  month = static_cast<int>(mp < 10 ? mp + 3 : mp - 9);
+  yr = static_cast<int>(yoe + era * 400 + (month <= 2 ? 1 : 0));
+}
+
+bool HmdfAsciiParser::splitStringHmdfFormat(const char *begin, const char *end,
+                                            long long &msecSinceEpoch,
+                                            double &value) {
+  int d[6];
+  const char *pos = begin;
+
+  for (int i = 0; i < 5; i++) {
+    skipHmdfSpace(pos, end);
+    if (!HmdfAsciiParser::parseInt(pos, end, d[i])) return false;
+    if (pos != end && !isHmdfSpace(*pos)) return false;
+  }
+
+  //...The sixth field is either the seconds or, when the record has no
+  //   seconds column, the value
+  skipHmdfSpace(pos, end);
+  const char *sixth = pos;
+  double v;
+  if (!HmdfAsciiParser::parseDouble(pos, end, v)) return false;
+
+  skipHmdfSpace(pos, end);
+  const char *seventh = pos;
+  if (pos != end && HmdfAsciiParser::parseDouble(seventh, end, value)) {
+    if (!HmdfAsciiParser::parseInt(sixth, end, d[5])) return false;
+    if (sixth != end && !isHmdfSpace(*sixth)) return false;
+  } else {
+    d[5] = 0;
+    value = v;
+  }
+
+  msecSinceEpoch =
+      HmdfAsciiParser::toMSecsSinceEpoch(d[0], d[1], d[2], d[3], d[4], d[5]);
+  return true;
+}
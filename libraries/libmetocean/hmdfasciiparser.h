@@ -27,6 +27,21 @@ class HmdfAsciiParser {
   static bool splitStringHmdfFormat(std::string &data, int &yr, int &month,
                                     int &day, int &hr, int &min, int &sec,
                                     double &value);
+
+  static bool splitStringHmdfFormat(const char *begin, const char *end,
+                                    long long &msecSinceEpoch, double &value);
+
+  static long long toMSecsSinceEpoch(int yr, int month, int day, int hr,
+                                     int min, int sec);
+
+  static void fromMSecsSinceEpoch(long long msecSinceEpoch, int &yr,
+                                  int &month, int &day, int &hr, int &min,
+                                  int &sec);
+
+  //...Allocation free number parsers for [pos, end). On success pos is
+  //   moved past the number
+  static bool parseInt(const char *&pos, const char *end, int &value);
+  static bool parseDouble(const char *&pos, const char *end, double &value);
 };
 
 #endif  // HMDFASCIIPARSER_H
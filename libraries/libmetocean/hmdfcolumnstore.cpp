@@ -0,0 +1,201 @@
+/*-------------------------------GPL-------------------------------------//
+//
+// MetOcean Viewer - A simple interface for viewing hydrodynamic model data
+// Copyright (C) 2018  Zach Cobell
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------*/
+#include "hmdfcolumnstore.h"
+#include <algorithm>
+
+HmdfColumnStore::HmdfColumnStore() { this->clear(); }
+
+void HmdfColumnStore::clear() {
+  this->m_date.clear();
+  this->m_data.clear();
+  this->m_dateOffset.assign(1, 0);
+  this->m_dataOffset.assign(1, 0);
+  this->m_refCount.clear();
+  return;
+}
+
+int HmdfColumnStore::addSeries() {
+  this->m_dateOffset.push_back(this->m_date.size());
+  this->m_dataOffset.push_back(this->m_data.size());
+  this->m_refCount.push_back(1);
+  return static_cast<int>(this->nseries()) - 1;
+}
+
+size_t HmdfColumnStore::nseries() const {
+  return this->m_dataOffset.size() - 1;
+}
+
+void HmdfColumnStore::retain(int series) {
+  Q_ASSERT(series >= 0 && static_cast<size_t>(series) < this->nseries());
+  this->m_refCount[series]++;
+  return;
+}
+
+//...Drops a reference to the series. Dead series at the end of the store
+//   are removed, so a station that is deleted while it is being read (for
+//   example on an error path) does not leave its samples behind and the
+//   space is reused by the next series. Dead series further up the store
+//   are reclaimed when the store itself is released
+void HmdfColumnStore::release(int series) {
+  Q_ASSERT(series >= 0 && static_cast<size_t>(series) < this->nseries());
+  Q_ASSERT(this->m_refCount[series] > 0);
+  this->m_refCount[series]--;
+  while (!this->m_refCount.empty() && this->m_refCount.back() == 0) {
+    this->m_refCount.pop_back();
+    this->m_dateOffset.pop_back();
+    this->m_dataOffset.pop_back();
+    this->m_date.resize(this->m_dateOffset.back());
+    this->m_data.resize(this->m_dataOffset.back());
+  }
+  return;
+}
+
+int HmdfColumnStore::refCount(int series) const {
+  Q_ASSERT(series >= 0 && static_cast<size_t>(series) < this->nseries());
+  return this->m_refCount[series];
+}
+
+//...Makes room for nseries more series holding nvalues more samples in
+//   addition to what the store already contains
+void HmdfColumnStore::reserve(size_t nseries, size_t nvalues) {
+  this->m_dateOffset.reserve(this->m_dateOffset.size() + nseries);
+  this->m_dataOffset.reserve(this->m_dataOffset.size() + nseries);
+  this->m_date.reserve(this->m_date.size() + nvalues);
+  this->m_data.reserve(this->m_data.size() + nvalues);
+  return;
+}
+
+bool HmdfColumnStore::isLast(int series) const {
+  return series >= 0 && static_cast<size_t>(series) == this->nseries() - 1;
+}
+
+size_t HmdfColumnStore::dateSize(int series) const {
+  Q_ASSERT(series >= 0 && static_cast<size_t>(series) < this->nseries());
+  return this->m_dateOffset[series + 1] - this->m_dateOffset[series];
+}
+
+size_t HmdfColumnStore::dataSize(int series) const {
+  Q_ASSERT(series >= 0 && static_cast<size_t>(series) < this->nseries());
+  return this->m_dataOffset[series + 1] - this->m_dataOffset[series];
+}
+
+qint64 *HmdfColumnStore::date(int series) {
+  return this->m_date.data() + this->m_dateOffset[series];
+}
+
+const qint64 *HmdfColumnStore::date(int series) const {
+  return this->m_date.data() + this->m_dateOffset[series];
+}
+
+double *HmdfColumnStore::data(int series) {
+  return this->m_data.data() + this->m_dataOffset[series];
+}
+
+const double *HmdfColumnStore::data(int series) const {
+  return this->m_data.data() + this->m_dataOffset[series];
+}
+
+void HmdfColumnStore::appendDate(int series, const qint64 &date) {
+  Q_ASSERT(this->isLast(series));
+  this->m_date.push_back(date);
+  this->m_dateOffset.back() = this->m_date.size();
+  return;
+}
+
+void HmdfColumnStore::appendData(int series, const double &data) {
+  Q_ASSERT(this->isLast(series));
+  this->m_data.push_back(data);
+  this->m_dataOffset.back() = this->m_data.size();
+  return;
+}
+
+void HmdfColumnStore::appendDate(int series, const qint64 *date, size_t n) {
+  Q_ASSERT(this->isLast(series));
+  this->m_date.insert(this->m_date.end(), date, date + n);
+  this->m_dateOffset.back() = this->m_date.size();
+  return;
+}
+
+void HmdfColumnStore::appendData(int series, const double *data, size_t n) {
+  Q_ASSERT(this->isLast(series));
+  this->m_data.insert(this->m_data.end(), data, data + n);
+  this->m_dataOffset.back() = this->m_data.size();
+  return;
+}
+
+//...Makes room for n samples in the last series. The columns grow
+//   geometrically so that reserving station after station in a shared store
+//   does not reallocate the whole store every time
+void HmdfColumnStore::reserveSeries(int series, size_t n) {
+  Q_ASSERT(this->isLast(series));
+  size_t nDate = this->m_dateOffset[series] + n;
+  size_t nData = this->m_dataOffset[series] + n;
+  if (nDate > this->m_date.capacity())
+    this->m_date.reserve(std::max(nDate, 2 * this->m_date.capacity()));
+  if (nData > this->m_data.capacity())
+    this->m_data.reserve(std::max(nData, 2 * this->m_data.capacity()));
+  return;
+}
+
+void HmdfColumnStore::resizeDate(int series, size_t n) {
+  Q_ASSERT(this->isLast(series));
+  this->m_date.resize(this->m_dateOffset[series] + n);
+  this->m_dateOffset.back() = this->m_date.size();
+  return;
+}
+
+void HmdfColumnStore::resizeData(int series, size_t n) {
+  Q_ASSERT(this->isLast(series));
+  this->m_data.resize(this->m_dataOffset[series] + n);
+  this->m_dataOffset.back() = this->m_data.size();
+  return;
+}
+
+//...The source may point into this store, in which case it is copied out
+//   first since resizing the column can move it
+void HmdfColumnStore::assignDate(int series, const qint64 *date, size_t n) {
+  Q_ASSERT(this->isLast(series));
+  if (date >= this->m_date.data() &&
+      date < this->m_date.data() + this->m_date.size()) {
+    std::vector<qint64> temp(date, date + n);
+    this->resizeDate(series, n);
+    std::copy(temp.begin(), temp.end(), this->date(series));
+  } else {
+    this->resizeDate(series, n);
+    std::copy(date, date + n, this->date(series));
+  }
+  return;
+}
+
+void HmdfColumnStore::assignData(int series, const double *data, size_t n) {
+  Q_ASSERT(this->isLast(series));
+  if (data >= this->m_data.data() &&
+      data < this->m_data.data() + this->m_data.size()) {
+    std::vector<double> temp(data, data + n);
+    this->resizeData(series, n);
+    std::copy(temp.begin(), temp.end(), this->data(series));
+  } else {
+    this->resizeData(series, n);
+    std::copy(data, data + n, this->data(series));
+  }
+  return;
+}
+
+size_t HmdfColumnStore::totalSize() const { return this->m_data.size(); }
@@ -0,0 +1,83 @@
+/*-------------------------------GPL-------------------------------------//
+//
+// MetOcean Viewer - A simple interface for viewing hydrodynamic model data
+// Copyright (C) 2018  Zach Cobell
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------*/
+#ifndef HMDFCOLUMNSTORE_H
+#define HMDFCOLUMNSTORE_H
+
+#include <QtGlobal>
+#include <vector>
+
+//...Columnar backing store for a set of timeseries. All dates live in one
+//   contiguous array and all values in another, ordered station-major. Each
+//   series is addressed by an offset into the arrays, so series do not need
+//   to share a length. Only the last series in the store may change size in
+//   place; HmdfStation moves a series into a private store when it needs to
+//   grow a series that is not at the end. Series are reference counted by
+//   the stations that view them; a series nothing refers to is removed
+//   once it is at the end of the store.
+class HmdfColumnStore {
+ public:
+  HmdfColumnStore();
+
+  void clear();
+
+  int addSeries();
+  size_t nseries() const;
+
+  void retain(int series);
+  void release(int series);
+  int refCount(int series) const;
+
+  void reserve(size_t nseries, size_t nvalues);
+
+  bool isLast(int series) const;
+
+  size_t dateSize(int series) const;
+  size_t dataSize(int series) const;
+
+  qint64 *date(int series);
+  const qint64 *date(int series) const;
+
+  double *data(int series);
+  const double *data(int series) const;
+
+  void appendDate(int series, const qint64 &date);
+  void appendData(int series, const double &data);
+  void appendDate(int series, const qint64 *date, size_t n);
+  void appendData(int series, const double *data, size_t n);
+
+  void reserveSeries(int series, size_t n);
+
+  void resizeDate(int series, size_t n);
+  void resizeData(int series, size_t n);
+
+  void assignDate(int series, const qint64 *date, size_t n);
+  void assignData(int series, const double *data, size_t n);
+
+  size_t totalSize() const;
+
+ private:
+  std::vector<qint64> m_date;
+  std::vector<double> m_data;
+  std::vector<size_t> m_dateOffset;
+  std::vector<size_t> m_dataOffset;
+  std::vector<int> m_refCount;
+};
+
+#endif  // HMDFCOLUMNSTORE_H
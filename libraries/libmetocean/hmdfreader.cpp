@@ -0,0 +1,214 @@
+/*-------------------------------GPL-------------------------------------//
+//
+// MetOcean Viewer - A simple interface for viewing hydrodynamic model data
+// Copyright (C) 2018  Zach Cobell
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------*/
+#include "hmdfreader.h"
+#include <QFileInfo>
+#include <QStringList>
+#include "netcdftimeseries.h"
+#include "stringutil.h"
+
+HmdfReader::HmdfReader(QObject *parent) : QObject(parent) {
+  this->m_fileType = Hmdf::HmdfImeds;
+  this->m_imedsParser = Hmdf::HmdfParserFast;
+  this->m_error = false;
+  this->m_hasPending = false;
+  this->m_netcdf = nullptr;
+  this->m_nextStation = 0;
+  this->m_datum = "unknown";
+  this->m_units = "unknown";
+}
+
+HmdfReader::~HmdfReader() { this->close(); }
+
+QString HmdfReader::filename() const { return this->m_filename; }
+
+void HmdfReader::setFilename(const QString &filename) {
+  this->m_filename = filename;
+}
+
+Hmdf::HmdfFileType HmdfReader::fileType() const { return this->m_fileType; }
+
+Hmdf::HmdfImedsParser HmdfReader::imedsParser() const {
+  return this->m_imedsParser;
+}
+
+void HmdfReader::setImedsParser(const Hmdf::HmdfImedsParser &imedsParser) {
+  this->m_imedsParser = imedsParser;
+}
+
+bool HmdfReader::error() const { return this->m_error; }
+
+QString HmdfReader::header1() const { return this->m_header1; }
+
+QString HmdfReader::header2() const { return this->m_header2; }
+
+QString HmdfReader::header3() const { return this->m_header3; }
+
+QString HmdfReader::datum() const { return this->m_datum; }
+
+QString HmdfReader::units() const { return this->m_units; }
+
+int HmdfReader::open() {
+  this->close();
+  this->m_error = false;
+
+  QString suffix = QFileInfo(this->m_filename).suffix().toLower();
+  if (suffix == "imeds") {
+    this->m_fileType = Hmdf::HmdfImeds;
+    return this->openImeds();
+  } else if (suffix == "nc") {
+    this->m_fileType = Hmdf::HmdfNetCdf;
+    return this->openNetcdf();
+  }
+  return 1;
+}
+
+void HmdfReader::close() {
+  if (this->m_fid.is_open()) this->m_fid.close();
+  this->m_fid.clear();
+  this->m_pending.clear();
+  this->m_hasPending = false;
+  if (this->m_netcdf != nullptr) {
+    delete this->m_netcdf;
+    this->m_netcdf = nullptr;
+  }
+  this->m_nextStation = 0;
+  return;
+}
+
+HmdfStation *HmdfReader::next() {
+  if (this->m_fileType == Hmdf::HmdfNetCdf) return this->nextNetcdf();
+  return this->nextImeds();
+}
+
+int HmdfReader::openImeds() {
+  this->m_fid.open(this->m_filename.toStdString().c_str());
+  if (!this->m_fid.is_open()) return 1;
+
+  std::string templine;
+  std::getline(this->m_fid, templine);
+  this->m_header1 =
+      QString::fromStdString(StringUtil::sanitizeString(templine));
+  std::getline(this->m_fid, templine);
+  this->m_header2 =
+      QString::fromStdString(StringUtil::sanitizeString(templine));
+  std::getline(this->m_fid, templine);
+  this->m_header3 =
+      QString::fromStdString(StringUtil::sanitizeString(templine));
+
+  //...Files written by MetOceanViewer carry the datum and units in the
+  //   third header line
+  QStringList header = this->m_header3.split(" ", QString::SkipEmptyParts);
+  if (header.size() >= 4) {
+    this->m_datum = header.at(2);
+    this->m_units = header.at(3);
+  }
+
+  //...Position on the first station header
+  while (std::getline(this->m_fid, templine)) {
+    templine = StringUtil::sanitizeString(templine);
+    if (!templine.empty()) {
+      this->m_pending = templine;
+      this->m_hasPending = true;
+      break;
+    }
+  }
+
+  return 0;
+}
+
+HmdfStation *HmdfReader::nextImeds() {
+  if (!this->m_hasPending) return nullptr;
+  this->m_hasPending = false;
+
+  QStringList templist = QString::fromStdString(this->m_pending)
+                             .split(" ", QString::SkipEmptyParts);
+  if (templist.size() < 3) {
+    this->m_error = true;
+    return nullptr;
+  }
+
+  HmdfStation *station = new HmdfStation();
+  station->setName(templist.at(0));
+  station->setId(templist.at(0));
+  station->setLatitude(templist.at(1).toDouble());
+  station->setLongitude(templist.at(2).toDouble());
+  station->setStationIndex(static_cast<int>(this->m_nextStation));
+  this->m_nextStation++;
+
+  //...Read records until the first line that is not a record or the end of
+  //   the file. As in Hmdf::readImeds, a blank line ends the station and the
+  //   next non-blank line is taken as the following station header
+  std::string templine;
+  while (std::getline(this->m_fid, templine)) {
+    qint64 date;
+    double value;
+    if (Hmdf::parseImedsRecord(this->m_imedsParser, templine.data(),
+                               templine.data() + templine.size(), date,
+                               value)) {
+      station->setNext(date, value);
+    } else {
+      templine = StringUtil::sanitizeString(templine);
+      while (templine.empty() && std::getline(this->m_fid, templine))
+        templine = StringUtil::sanitizeString(templine);
+      if (!templine.empty()) {
+        this->m_pending = templine;
+        this->m_hasPending = true;
+      }
+      break;
+    }
+  }
+
+  station->setIsNull(false);
+
+  return station;
+}
+
+int HmdfReader::openNetcdf() {
+  this->m_netcdf = new NetcdfTimeseries(this);
+  this->m_netcdf->setFilename(this->m_filename);
+  int ierr = this->m_netcdf->open();
+  if (ierr != 0) {
+    delete this->m_netcdf;
+    this->m_netcdf = nullptr;
+    return 1;
+  }
+  this->m_header1 = "none";
+  this->m_header2 = "none";
+  this->m_header3 = "none";
+  return 0;
+}
+
+HmdfStation *HmdfReader::nextNetcdf() {
+  if (this->m_netcdf == nullptr) return nullptr;
+  if (this->m_nextStation >= this->m_netcdf->numStations()) return nullptr;
+
+  HmdfStation *station = new HmdfStation();
+  int ierr = this->m_netcdf->readStation(this->m_nextStation, station);
+  if (ierr != 0) {
+    delete station;
+    this->m_error = true;
+    delete this->m_netcdf;
+    this->m_netcdf = nullptr;
+    return nullptr;
+  }
+  this->m_nextStation++;
+
+  return station;
+}
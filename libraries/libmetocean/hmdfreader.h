@@ -0,0 +1,87 @@
+/*-------------------------------GPL-------------------------------------//
+//
+// MetOcean Viewer - A simple interface for viewing hydrodynamic model data
+// Copyright (C) 2018  Zach Cobell
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------*/
+#ifndef HMDFREADER_H
+#define HMDFREADER_H
+
+#include <QObject>
+#include <QString>
+#include <fstream>
+#include <string>
+#include "hmdf.h"
+#include "hmdfstation.h"
+#include "metocean_global.h"
+
+class NetcdfTimeseries;
+
+//...Pull style reader that returns one station at a time from an IMEDS or
+//   HMDF netCDF file so that only a single station is held in memory. Each
+//   station returned by next() is owned by the caller.
+class HmdfReader : public QObject {
+  Q_OBJECT
+ public:
+  explicit HmdfReader(QObject *parent = nullptr);
+  ~HmdfReader();
+
+  int open();
+  HmdfStation *next();
+  void close();
+
+  bool error() const;
+
+  QString filename() const;
+  void setFilename(const QString &filename);
+
+  Hmdf::HmdfFileType fileType() const;
+
+  Hmdf::HmdfImedsParser imedsParser() const;
+  void setImedsParser(const Hmdf::HmdfImedsParser &imedsParser);
+
+  QString header1() const;
+  QString header2() const;
+  QString header3() const;
+  QString datum() const;
+  QString units() const;
+
+ private:
+  int openImeds();
+  int openNetcdf();
+  HmdfStation *nextImeds();
+  HmdfStation *nextNetcdf();
+
+  QString m_filename;
+  Hmdf::HmdfFileType m_fileType;
+  Hmdf::HmdfImedsParser m_imedsParser;
+  bool m_error;
+
+  QString m_header1;
+  QString m_header2;
+  QString m_header3;
+  QString m_datum;
+  QString m_units;
+
+  std::ifstream m_fid;
+  std::string m_pending;
+  bool m_hasPending;
+
+  NetcdfTimeseries *m_netcdf;
+  size_t m_nextStation;
+};
+
+#endif  // HMDFREADER_H
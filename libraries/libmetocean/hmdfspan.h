@@ -0,0 +1,54 @@
+/*-------------------------------GPL-------------------------------------//
+//
+// MetOcean Viewer - A simple interface for viewing hydrodynamic model data
+// Copyright (C) 2018  Zach Cobell
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------*/
+#ifndef HMDFSPAN_H
+#define HMDFSPAN_H
+
+#include <cstddef>
+#include <type_traits>
+
+//...Non-owning view of a contiguous range of samples. A span remains valid
+//   only until the series it was taken from is resized.
+template <typename T>
+class HmdfSpan {
+ public:
+  HmdfSpan() : m_data(nullptr), m_size(0) {}
+  HmdfSpan(T *data, size_t size) : m_data(data), m_size(size) {}
+
+  //...Allow a mutable span to be passed where a read-only span is expected
+  template <typename U, typename = typename std::enable_if<std::is_same<
+                            const U, T>::value>::type>
+  HmdfSpan(const HmdfSpan<U> &other)
+      : m_data(other.data()), m_size(other.size()) {}
+
+  T *data() const { return this->m_data; }
+  size_t size() const { return this->m_size; }
+  bool empty() const { return this->m_size == 0; }
+
+  T *begin() const { return this->m_data; }
+  T *end() const { return this->m_data + this->m_size; }
+
+  T &operator[](size_t index) const { return this->m_data[index]; }
+
+ private:
+  T *m_data;
+  size_t m_size;
+};
+
+#endif  // HMDFSPAN_H
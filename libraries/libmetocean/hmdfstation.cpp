@@ -19,7 +19,21 @@
 //-----------------------------------------------------------------------*/
 #include "hmdfstation.h"
 
-HmdfStation::HmdfStation(QObject *parent) : QObject(parent) {
+#include <algorithm>
+
+HmdfStation::HmdfStation()
+    : m_store(QSharedPointer<HmdfColumnStore>(new HmdfColumnStore())) {
+  this->m_series = this->m_store->addSeries();
+  this->m_coordinate = QGeoCoordinate();
+  this->m_name = "noname";
+  this->m_id = "noid";
+  this->m_isNull = true;
+  this->m_stationIndex = 0;
+}
+
+HmdfStation::HmdfStation(const QSharedPointer<HmdfColumnStore> &store)
+    : m_store(store) {
+  this->m_series = this->m_store->addSeries();
   this->m_coordinate = QGeoCoordinate();
   this->m_name = "noname";
   this->m_id = "noid";
@@ -27,14 +41,62 @@ HmdfStation::HmdfStation(QObject *parent) : QObject(parent) {
   this->m_stationIndex = 0;
 }
 
+HmdfStation::~HmdfStation() { this->m_store->release(this->m_series); }
+
 void HmdfStation::clear() {
   this->m_coordinate = QGeoCoordinate();
   this->m_name = "noname";
   this->m_id = "noid";
   this->m_isNull = true;
   this->m_stationIndex = 0;
-  this->m_data.clear();
-  this->m_date.clear();
+  if (this->isResizable()) {
+    this->m_store->resizeDate(this->m_series, 0);
+    this->m_store->resizeData(this->m_series, 0);
+  } else {
+    this->m_store->release(this->m_series);
+    this->m_store = QSharedPointer<HmdfColumnStore>(new HmdfColumnStore());
+    this->m_series = this->m_store->addSeries();
+  }
+  return;
+}
+
+//...True when another station views the same series, in which case the
+//   series is copied before either station modifies it
+bool HmdfStation::isShared() const {
+  return this->m_store->refCount(this->m_series) > 1;
+}
+
+bool HmdfStation::isResizable() const {
+  return !this->isShared() && this->m_store->isLast(this->m_series);
+}
+
+//...Moves this series to the end of a private store so that it can be
+//   resized without disturbing the neighboring series in a shared store
+void HmdfStation::detach() {
+  QSharedPointer<HmdfColumnStore> store(new HmdfColumnStore());
+  int series = store->addSeries();
+
+  size_t nDate = this->m_store->dateSize(this->m_series);
+  size_t nData = this->m_store->dataSize(this->m_series);
+  store->reserve(1, std::max(nDate, nData));
+  store->assignDate(series, this->m_store->date(this->m_series), nDate);
+  store->assignData(series, this->m_store->data(this->m_series), nData);
+
+  this->m_store->release(this->m_series);
+  this->m_store = store;
+  this->m_series = series;
+  return;
+}
+
+//...Makes this station a view of another station's series without copying
+//   it. Whichever station modifies the series first copies it into a private
+//   store, so neither station sees the other's changes
+void HmdfStation::shareSeries(const HmdfStation *other) {
+  if (other == this) return;
+  other->m_store->retain(other->m_series);
+  this->m_store->release(this->m_series);
+  this->m_store = other->m_store;
+  this->m_series = other->m_series;
   return;
 }
 
@@ -46,7 +108,9 @@ QString HmdfStation::id() const { return this->m_id; }
 
 void HmdfStation::setId(const QString &id) { this->m_id = id; }
 
-size_t HmdfStation::numSnaps() const { return this->m_data.size(); }
+size_t HmdfStation::numSnaps() const {
+  return this->m_store->dataSize(this->m_series);
+}
 
 int HmdfStation::stationIndex() const { return this->m_stationIndex; }
 
@@ -55,29 +119,35 @@ void HmdfStation::setStationIndex(int stationIndex) {
 }
 
 qint64 HmdfStation::date(int index) const {
-  Q_ASSERT(index >= 0 && index < this->numSnaps());
-  if (index >= 0 || index < this->numSnaps())
-    return this->m_date[index];
+  Q_ASSERT(static_cast<size_t>(index) < this->numSnaps());
+  if (static_cast<size_t>(index) < this->numSnaps())
+    return this->m_store->date(this->m_series)[index];
   else
     return 0;
 }
 
 double HmdfStation::data(int index) const {
-  Q_ASSERT(index >= 0 && index < this->numSnaps());
-  if (index >= 0 || index < this->numSnaps())
-    return this->m_data[index];
+  Q_ASSERT(static_cast<size_t>(index) < this->numSnaps());
+  if (static_cast<size_t>(index) < this->numSnaps())
+    return this->m_store->data(this->m_series)[index];
   else
     return 0;
 }
 
 void HmdfStation::setData(const double &data, int index) {
-  Q_ASSERT(index >= 0 && index < this->numSnaps());
-  if (index >= 0 || index < this->numSnaps()) this->m_data[index] = data;
+  Q_ASSERT(static_cast<size_t>(index) < this->numSnaps());
+  if (static_cast<size_t>(index) < this->numSnaps()) {
+    if (this->isShared()) this->detach();
+    this->m_store->data(this->m_series)[index] = data;
+  }
 }
 
 void HmdfStation::setDate(const qint64 &date, int index) {
-  Q_ASSERT(index >= 0 && index < this->numSnaps());
-  if (index >= 0 || index < this->numSnaps()) this->m_date[index] = date;
+  Q_ASSERT(static_cast<size_t>(index) < this->numSnaps());
+  if (static_cast<size_t>(index) < this->numSnaps()) {
+    if (this->isShared()) this->detach();
+    this->m_store->date(this->m_series)[index] = date;
+  }
 }
 
 bool HmdfStation::isNull() const { return this->m_isNull; }
@@ -85,23 +155,108 @@ bool HmdfStation::isNull() const { return this->m_isNull; }
 void HmdfStation::setIsNull(bool isNull) { this->m_isNull = isNull; }
 
 void HmdfStation::setDate(const QVector<qint64> &date) {
-  this->m_date = date;
+  this->setDate(HmdfSpan<const qint64>(date.constData(), date.size()));
+  return;
+}
+
+//...The vector is released as soon as it has been copied into the column so
+//   that the caller does not hold a second copy of the series
+void HmdfStation::setDate(QVector<qint64> &&date) {
+  this->setDate(HmdfSpan<const qint64>(date.constData(), date.size()));
+  date = QVector<qint64>();
+  return;
+}
+
+void HmdfStation::setDate(HmdfSpan<const qint64> date) {
+  if (!this->isResizable()) this->detach();
+  this->m_store->assignDate(this->m_series, date.data(), date.size());
   return;
 }
 
 void HmdfStation::setData(const QVector<double> &data) {
-  this->m_data = data;
+  this->setData(HmdfSpan<const double>(data.constData(), data.size()));
+  return;
+}
+
+void HmdfStation::setData(QVector<double> &&data) {
+  this->setData(HmdfSpan<const double>(data.constData(), data.size()));
+  data = QVector<double>();
+  return;
+}
+
+void HmdfStation::setData(HmdfSpan<const double> data) {
+  if (!this->isResizable()) this->detach();
+  this->m_store->assignData(this->m_series, data.data(), data.size());
+  return;
+}
+
+//...Sizes both the date and data columns so that readers can fill them in
+//   place through dateSpan() and dataSpan()
+void HmdfStation::resize(size_t n) {
+  if (!this->isResizable()) this->detach();
+  this->m_store->resizeDate(this->m_series, n);
+  this->m_store->resizeData(this->m_series, n);
   return;
 }
 
 void HmdfStation::setNext(const qint64 &date, const double &data) {
-  this->m_date.push_back(date);
-  this->m_data.push_back(data);
+  if (!this->isResizable()) this->detach();
+  this->m_store->appendDate(this->m_series, date);
+  this->m_store->appendData(this->m_series, data);
+}
+
+void HmdfStation::appendBlock(const qint64 *date, const double *data,
+                              size_t n) {
+  if (!this->isResizable()) this->detach();
+  this->m_store->appendDate(this->m_series, date, n);
+  this->m_store->appendData(this->m_series, data, n);
+  return;
 }
 
-QVector<qint64> HmdfStation::allDate() const { return this->m_date; }
+//...Capacity hint for the total number of samples expected in the series
+void HmdfStation::reserve(size_t n) {
+  if (!this->isResizable()) this->detach();
+  this->m_store->reserveSeries(this->m_series, n);
+  return;
+}
+
+QVector<qint64> HmdfStation::allDate() const {
+  size_t n = this->m_store->dateSize(this->m_series);
+  const qint64 *d = this->m_store->date(this->m_series);
+  QVector<qint64> date(n);
+  std::copy(d, d + n, date.begin());
+  return date;
+}
 
-QVector<double> HmdfStation::allData() const { return this->m_data; }
+QVector<double> HmdfStation::allData() const {
+  size_t n = this->m_store->dataSize(this->m_series);
+  const double *d = this->m_store->data(this->m_series);
+  QVector<double> data(n);
+  std::copy(d, d + n, data.begin());
+  return data;
+}
+
+HmdfSpan<const qint64> HmdfStation::dateSpan() const {
+  return HmdfSpan<const qint64>(this->m_store->date(this->m_series),
+                                this->m_store->dateSize(this->m_series));
+}
+
+HmdfSpan<const double> HmdfStation::dataSpan() const {
+  return HmdfSpan<const double>(this->m_store->data(this->m_series),
+                                this->m_store->dataSize(this->m_series));
+}
+
+HmdfSpan<qint64> HmdfStation::dateSpan() {
+  if (this->isShared()) this->detach();
+  return HmdfSpan<qint64>(this->m_store->date(this->m_series),
+                          this->m_store->dateSize(this->m_series));
+}
+
+HmdfSpan<double> HmdfStation::dataSpan() {
+  if (this->isShared()) this->detach();
+  return HmdfSpan<double>(this->m_store->data(this->m_series),
+                          this->m_store->dataSize(this->m_series));
+}
 
 void HmdfStation::setLatitude(const double latitude) {
   this->m_coordinate.setLatitude(latitude);
@@ -123,9 +278,13 @@ QGeoCoordinate *HmdfStation::coordinate() { return &this->m_coordinate; }
 
 void HmdfStation::dataBounds(qint64 &minDate, qint64 &maxDate, double &minValue,
                              double &maxValue) {
-  minDate = *std::min_element(this->m_date.begin(), this->m_date.end());
-  maxDate = *std::max_element(this->m_date.begin(), this->m_date.end());
-  minValue = *std::min_element(this->m_data.begin(), this->m_data.end());
-  maxValue = *std::max_element(this->m_data.begin(), this->m_data.end());
+  const qint64 *date = this->m_store->date(this->m_series);
+  const double *data = this->m_store->data(this->m_series);
+  size_t nDate = this->m_store->dateSize(this->m_series);
+  size_t nData = this->m_store->dataSize(this->m_series);
+  minDate = *std::min_element(date, date + nDate);
+  maxDate = *std::max_element(date, date + nDate);
+  minValue = *std::min_element(data, data + nData);
+  maxValue = *std::max_element(data, data + nData);
   return;
 }
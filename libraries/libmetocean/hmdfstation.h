@@ -20,17 +20,22 @@
 #ifndef HMDFSTATION
 #define HMDFSTATION
 
+#include <QEnableSharedFromThis>
 #include <QGeoCoordinate>
-#include <QObject>
+#include <QSharedPointer>
 #include <QString>
 #include <QVector>
+#include "hmdfcolumnstore.h"
+#include "hmdfspan.h"
 #include "metocean_global.h"
 
-class HmdfStation : public QObject {
-  Q_OBJECT
-
+//...Lightweight view of a single series inside an HmdfColumnStore. A station
+//   constructed without a store owns a private one.
+class HmdfStation : public QEnableSharedFromThis<HmdfStation> {
  public:
-  explicit HmdfStation(QObject *parent = nullptr);
+  HmdfStation();
+  explicit HmdfStation(const QSharedPointer<HmdfColumnStore> &store);
+  ~HmdfStation();
 
   void clear();
 
@@ -57,8 +62,13 @@ class HmdfStation : public QObject {
   qint64 date(int index) const;
   void setDate(const qint64 &date, int index);
   void setDate(const QVector<qint64> &date);
+  void setDate(QVector<qint64> &&date);
+  void setDate(HmdfSpan<const qint64> date);
 
   void setNext(const qint64 &date, const double &data);
+  void appendBlock(const qint64 *date, const double *data, size_t n);
+
+  void reserve(size_t n);
 
   bool isNull() const;
   void setIsNull(bool isNull);
@@ -66,14 +76,31 @@ class HmdfStation : public QObject {
   double data(int index) const;
   void setData(const double &data, int index);
   void setData(const QVector<double> &data);
+  void setData(QVector<double> &&data);
+  void setData(HmdfSpan<const double> data);
+
+  void resize(size_t n);
+
+  void shareSeries(const HmdfStation *other);
 
   QVector<qint64> allDate() const;
   QVector<double> allData() const;
 
+  HmdfSpan<const qint64> dateSpan() const;
+  HmdfSpan<const double> dataSpan() const;
+  HmdfSpan<qint64> dateSpan();
+  HmdfSpan<double> dataSpan();
+
   void dataBounds(qint64 &minDate, qint64 &maxDate, double &minValue,
                   double &maxValue);
 
  private:
+  Q_DISABLE_COPY(HmdfStation)
+
+  void detach();
+  bool isShared() const;
+  bool isResizable() const;
+
   QGeoCoordinate m_coordinate;
 
   QString m_name;
@@ -81,8 +108,8 @@ class HmdfStation : public QObject {
 
   int m_stationIndex;
 
-  QVector<qint64> m_date;
-  QVector<double> m_data;
+  QSharedPointer<HmdfColumnStore> m_store;
+  int m_series;
 
   bool m_isNull;
 };
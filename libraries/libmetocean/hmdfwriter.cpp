@@ -0,0 +1,598 @@
+/*-------------------------------GPL-------------------------------------//
+//
+// MetOcean Viewer - A simple interface for viewing hydrodynamic model data
+// Copyright (C) 2018  Zach Cobell
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------*/
+#include "hmdfwriter.h"
+#include <QDateTime>
+#include <QHostInfo>
+#include <QThread>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+#include <vector>
+#include "hmdfasciiparser.h"
+#include "netcdf.h"
+
+//...Size at which buffered text is written to disk
+static const size_t c_flushSize = 4 * 1024 * 1024;
+
+//...Size of the station data held back while netCDF stations are defined.
+//   The file is taken in and out of define mode once per batch
+static const size_t c_netcdfBatchSize = 64 * 1024 * 1024;
+
+#define NCCHECK(ierr)       \
+  if (ierr != NC_NOERR) {   \
+    nc_close(this->m_ncid); \
+    this->m_ncid = -1;      \
+    return ierr;            \
+  }
+
+HmdfWriter::HmdfWriter(QObject *parent) : QObject(parent) {
+  this->m_fileType = Hmdf::HmdfImeds;
+  this->m_datum = QString();
+  this->m_units = QString();
+  this->m_ncid = -1;
+  this->m_varidStationName = -1;
+  this->m_varidStationId = -1;
+  this->m_varidStationX = -1;
+  this->m_varidStationY = -1;
+  this->m_nstations = 0;
+  this->m_netcdfDefineMode = false;
+  this->m_netcdfPendingSize = 0;
+  this->m_threads = 0;
+  this->m_netcdfProfile = Hmdf::HmdfProfileFast;
+  this->m_netcdfChunking = Hmdf::HmdfChunkStation;
+  this->m_netcdfPrecision = 0.0;
+}
+
+HmdfWriter::~HmdfWriter() { this->close(); }
+
+QString HmdfWriter::filename() const { return this->m_filename; }
+
+void HmdfWriter::setFilename(const QString &filename) {
+  this->m_filename = filename;
+}
+
+Hmdf::HmdfFileType HmdfWriter::fileType() const { return this->m_fileType; }
+
+void HmdfWriter::setFileType(const Hmdf::HmdfFileType &fileType) {
+  this->m_fileType = fileType;
+}
+
+int HmdfWriter::threads() const { return this->m_threads; }
+
+//...Number of threads used to format stations passed to write as a group.
+//   Zero uses the ideal thread count and one formats serially
+void HmdfWriter::setThreads(int threads) { this->m_threads = threads; }
+
+Hmdf::HmdfNetcdfProfile HmdfWriter::netcdfProfile() const {
+  return this->m_netcdfProfile;
+}
+
+void HmdfWriter::setNetcdfProfile(
+    const Hmdf::HmdfNetcdfProfile &netcdfProfile) {
+  this->m_netcdfProfile = netcdfProfile;
+}
+
+Hmdf::HmdfNetcdfChunking HmdfWriter::netcdfChunking() const {
+  return this->m_netcdfChunking;
+}
+
+//...Each station is stored in its own one dimensional variables, so both
+//   settings give chunks that run along the station's time axis
+void HmdfWriter::setNetcdfChunking(
+    const Hmdf::HmdfNetcdfChunking &netcdfChunking) {
+  this->m_netcdfChunking = netcdfChunking;
+}
+
+double HmdfWriter::netcdfPrecision() const { return this->m_netcdfPrecision; }
+
+void HmdfWriter::setNetcdfPrecision(double netcdfPrecision) {
+  this->m_netcdfPrecision = netcdfPrecision;
+}
+
+QString HmdfWriter::datum() const { return this->m_datum; }
+
+void HmdfWriter::setDatum(const QString &datum) { this->m_datum = datum; }
+
+QString HmdfWriter::units() const { return this->m_units; }
+
+void HmdfWriter::setUnits(const QString &units) { this->m_units = units; }
+
+int HmdfWriter::open() {
+  this->close();
+  this->m_nstations = 0;
+  this->m_netcdfDefineMode = false;
+  this->m_netcdfPendingSize = 0;
+  this->m_netcdfPending.clear();
+
+  if (this->m_fileType == Hmdf::HmdfNetCdf) return this->openNetcdf();
+
+  this->m_file.setFileName(this->m_filename);
+  if (!this->m_file.open(QIODevice::WriteOnly)) return -1;
+
+  if (this->m_fileType == Hmdf::HmdfImeds) {
+    this->m_file.write(QString("% IMEDS generic format\n").toUtf8());
+    this->m_file.write(
+        QString("% year month day hour min sec value\n").toUtf8());
+    this->m_file.write(QString("MetOceanViewer    UTC    " + this->m_datum +
+                               "   " + this->m_units + "\n")
+                           .toUtf8());
+  }
+
+  return 0;
+}
+
+int HmdfWriter::write(HmdfStation *station) {
+  int ierr = 1;
+  if (this->m_fileType == Hmdf::HmdfImeds ||
+      this->m_fileType == Hmdf::HmdfCsv) {
+    ierr = this->writeTextStation(station);
+  } else if (this->m_fileType == Hmdf::HmdfNetCdf) {
+    ierr = this->writeNetcdfStation(station);
+  }
+  if (ierr == 0) this->m_nstations++;
+  return ierr;
+}
+
+int HmdfWriter::close() {
+  if (this->m_file.isOpen()) {
+    int ierr = this->flush();
+    this->m_file.close();
+    if (ierr != 0) return ierr;
+  }
+  if (this->m_ncid >= 0) {
+    int ierr = this->flushNetcdf();
+    if (ierr != 0) return ierr;
+    ierr = nc_close(this->m_ncid);
+    this->m_ncid = -1;
+    return ierr;
+  }
+  return 0;
+}
+
+//...Writes value zero padded to width digits and returns the new end
+static char *formatDigits(char *p, int value, int width) {
+  for (int i = width - 1; i >= 0; i--) {
+    p[i] = static_cast<char>('0' + value % 10);
+    value /= 10;
+  }
+  return p + width;
+}
+
+static char *formatSpaces(char *p, int n) {
+  memset(p, ' ', n);
+  return p + n;
+}
+
+//...Same output as QString::sprintf("%10.4e"). The C library uses the
+//   process locale for the decimal point where Qt always uses '.', so the
+//   separator is put back after formatting
+static char *formatValue(char *p, double value) {
+  if (std::isnan(value)) {
+    memcpy(p, "       nan", 10);
+    return p + 10;
+  }
+  int n = snprintf(p, 32, "%10.4e", value);
+  for (int i = 0; i < n; i++) {
+    if (p[i] >= '0' && p[i] <= '9') {
+      p[i + 1] = '.';
+      break;
+    }
+  }
+  return p + n;
+}
+
+//...Formats the date with QDateTime for years that the fixed width
+//   formatter cannot represent. Dates are always written in UTC to match
+//   the header and the readers, whatever the local time zone is
+static char *formatDateFallback(char *p, qint64 msec, const QString &format) {
+  QDateTime d = QDateTime::fromMSecsSinceEpoch(msec, Qt::UTC);
+  if (!d.isValid()) return nullptr;
+  QByteArray s = d.toString(format).toUtf8();
+  memcpy(p, s.constData(), s.size());
+  return p + s.size();
+}
+
+static char *formatImedsRecord(char *p, qint64 msec, double value) {
+  int yr, month, day, hr, min, sec;
+  HmdfAsciiParser::fromMSecsSinceEpoch(msec, yr, month, day, hr, min, sec);
+  if (yr < 0 || yr > 9999) {
+    p = formatDateFallback(p, msec, "yyyy    MM    dd    hh    mm    ss");
+    if (!p) return nullptr;
+  } else {
+    p = formatDigits(p, yr, 4);
+    p = formatDigits(formatSpaces(p, 4), month, 2);
+    p = formatDigits(formatSpaces(p, 4), day, 2);
+    p = formatDigits(formatSpaces(p, 4), hr, 2);
+    p = formatDigits(formatSpaces(p, 4), min, 2);
+    p = formatDigits(formatSpaces(p, 4), sec, 2);
+  }
+  p = formatValue(formatSpaces(p, 4), value);
+  *p++ = '\n';
+  return p;
+}
+
+static char *formatCsvRecord(char *p, qint64 msec, double value) {
+  int yr, month, day, hr, min, sec;
+  HmdfAsciiParser::fromMSecsSinceEpoch(msec, yr, month, day, hr, min, sec);
+  if (yr < 0 || yr > 9999) {
+    p = formatDateFallback(p, msec, "MM/dd/yyyy,hh:mm,");
+    if (!p) return nullptr;
+  } else {
+    p = formatDigits(p, month, 2);
+    *p++ = '/';
+    p = formatDigits(p, day, 2);
+    *p++ = '/';
+    p = formatDigits(p, yr, 4);
+    *p++ = ',';
+    p = formatDigits(p, hr, 2);
+    *p++ = ':';
+    p = formatDigits(p, min, 2);
+    *p++ = ',';
+  }
+  p = formatValue(p, value);
+  *p++ = '\n';
+  return p;
+}
+
+//...Appends the text for one station to the buffer. This only reads the
+//   station and writer settings so several stations can be formatted at once
+void HmdfWriter::formatStation(const HmdfStation *station,
+                               std::string &buffer) const {
+  HmdfSpan<const qint64> date = station->dateSpan();
+  HmdfSpan<const double> data = station->dataSpan();
+
+  QByteArray header;
+  if (this->m_fileType == Hmdf::HmdfImeds) {
+    QString stationName =
+        station->name().replace(" ", "_").replace(",", "_").replace("__", "_");
+    header = QString(stationName + "   " +
+                     QString::number(station->latitude()) + "   " +
+                     QString::number(station->longitude()) + "\n")
+                 .toUtf8();
+  } else {
+    header = QString("Station: " + station->name() + "\n" +
+                     "Datum: " + this->m_datum + "\n" +
+                     "Units: " + this->m_units + "\n\n")
+                 .toUtf8();
+  }
+  buffer.append(header.constData(), header.size());
+
+  //...Records are at most 64 bytes, except when the date falls back to
+  //   QDateTime formatting for years beyond 9999
+  size_t start = buffer.size();
+  buffer.resize(start + date.size() * 96);
+  char *begin = &buffer[0];
+  char *p = begin + start;
+  for (size_t i = 0; i < date.size(); i++) {
+    char *q = this->m_fileType == Hmdf::HmdfImeds
+                  ? formatImedsRecord(p, date[i], data[i])
+                  : formatCsvRecord(p, date[i], data[i]);
+    if (q) p = q;
+  }
+  buffer.resize(static_cast<size_t>(p - begin));
+
+  if (this->m_fileType == Hmdf::HmdfCsv) buffer.append("\n\n\n");
+  return;
+}
+
+int HmdfWriter::flush() {
+  if (this->m_buffer.empty()) return 0;
+  qint64 n = static_cast<qint64>(this->m_buffer.size());
+  qint64 written = this->m_file.write(this->m_buffer.data(), n);
+  this->m_buffer.clear();
+  return written == n ? 0 : -1;
+}
+
+int HmdfWriter::writeTextStation(HmdfStation *station) {
+  if (!this->m_file.isOpen()) return -1;
+  this->formatStation(station, this->m_buffer);
+  if (this->m_buffer.size() >= c_flushSize) return this->flush();
+  return 0;
+}
+
+//...Formats batches of stations on several threads and writes the text in
+//   station order. NetCDF stations are all defined before any data is
+//   written
+int HmdfWriter::write(const QVector<HmdfStation *> &stations) {
+  if (this->m_fileType == Hmdf::HmdfNetCdf) {
+    if (this->m_ncid < 0) return -1;
+    for (int i = 0; i < stations.size(); i++) {
+      int ierr = this->defineNetcdfStation(stations[i], false);
+      if (ierr != 0) return ierr;
+      this->m_nstations++;
+    }
+    return this->flushNetcdf();
+  }
+
+  int nThreads =
+      this->m_threads > 0 ? this->m_threads : QThread::idealThreadCount();
+  nThreads = std::max(nThreads, 1);
+
+  if (nThreads == 1 || stations.size() < 2) {
+    for (int i = 0; i < stations.size(); i++) {
+      int ierr = this->write(stations[i]);
+      if (ierr != 0) return ierr;
+    }
+    return 0;
+  }
+
+  if (!this->m_file.isOpen()) return -1;
+
+  size_t batchSize = static_cast<size_t>(nThreads) * 2;
+  std::vector<std::string> text(batchSize);
+
+  for (size_t first = 0; first < static_cast<size_t>(stations.size());
+       first += batchSize) {
+    size_t n = std::min(batchSize, stations.size() - first);
+    std::atomic<size_t> next(0);
+
+    auto worker = [&]() {
+      for (size_t k = next++; k < n; k = next++) {
+        text[k].clear();
+        this->formatStation(stations[static_cast<int>(first + k)], text[k]);
+      }
+    };
+
+    std::vector<std::thread> threads;
+    size_t nWorkers = std::min(static_cast<size_t>(nThreads), n);
+    for (size_t i = 1; i < nWorkers; i++)
+      threads.push_back(std::thread(worker));
+    worker();
+    for (size_t i = 0; i < threads.size(); i++) threads[i].join();
+
+    int ierr = this->flush();
+    if (ierr != 0) return ierr;
+    for (size_t k = 0; k < n; k++) {
+      qint64 size = static_cast<qint64>(text[k].size());
+      if (this->m_file.write(text[k].data(), size) != size) return -1;
+      this->m_nstations++;
+    }
+  }
+
+  return 0;
+}
+
+//...The station dimension is unlimited so that stations can be appended
+//   without knowing how many will be written. The file is left in define
+//   mode so that the first batch of stations is defined along with the
+//   global layout
+int HmdfWriter::openNetcdf() {
+  int dimid_nstations, dimid_stationNameLength;
+
+  NCCHECK(nc_create(this->m_filename.toStdString().c_str(), NC_NETCDF4,
+                    &this->m_ncid));
+
+  NCCHECK(nc_def_dim(this->m_ncid, "numStations", NC_UNLIMITED,
+                     &dimid_nstations));
+  NCCHECK(nc_def_dim(this->m_ncid, "stationNameLen", 200,
+                     &dimid_stationNameLength));
+
+  int stationNameDims[2] = {dimid_nstations, dimid_stationNameLength};
+  int nstationDims[1] = {dimid_nstations};
+  int wgs84[1] = {4326};
+
+  NCCHECK(nc_def_var(this->m_ncid, "stationName", NC_CHAR, 2, stationNameDims,
+                     &this->m_varidStationName));
+  NCCHECK(nc_def_var(this->m_ncid, "stationId", NC_CHAR, 2, stationNameDims,
+                     &this->m_varidStationId));
+  NCCHECK(nc_def_var(this->m_ncid, "stationXCoordinate", NC_DOUBLE, 1,
+                     nstationDims, &this->m_varidStationX));
+  NCCHECK(nc_def_var(this->m_ncid, "stationYCoordinate", NC_DOUBLE, 1,
+                     nstationDims, &this->m_varidStationY));
+
+  NCCHECK(nc_put_att_text(this->m_ncid, this->m_varidStationX,
+                          "HorizontalProjectionName", 5, "WGS84"));
+  NCCHECK(nc_put_att_text(this->m_ncid, this->m_varidStationY,
+                          "HorizontalProjectionName", 5, "WGS84"));
+  NCCHECK(nc_put_att_int(this->m_ncid, this->m_varidStationX,
+                         "HorizontalProjectionEPSG", NC_INT, 1, wgs84));
+  NCCHECK(nc_put_att_int(this->m_ncid, this->m_varidStationY,
+                         "HorizontalProjectionEPSG", NC_INT, 1, wgs84));
+
+  //...Metadata
+  QString name = qgetenv("USER");
+  if (name.isEmpty()) name = qgetenv("USERNAME");
+  QString host = QHostInfo::localHostName();
+  QString createTime =
+      QDateTime::currentDateTimeUtc().toString("yyyy-MM-dd hh:mm:ss");
+  QString source = "MetOceanViewer";
+  QString ncVersion = QString(nc_inq_libvers());
+  QString format = "20180123";
+
+  NCCHECK(nc_put_att(this->m_ncid, NC_GLOBAL, "source", NC_CHAR,
+                     source.length(), source.toStdString().c_str()));
+  NCCHECK(nc_put_att(this->m_ncid, NC_GLOBAL, "creation_date", NC_CHAR,
+                     createTime.length(), createTime.toStdString().c_str()));
+  NCCHECK(nc_put_att(this->m_ncid, NC_GLOBAL, "created_by", NC_CHAR,
+                     name.length(), name.toStdString().c_str()));
+  NCCHECK(nc_put_att(this->m_ncid, NC_GLOBAL, "host", NC_CHAR, host.length(),
+                     host.toStdString().c_str()));
+  NCCHECK(nc_put_att(this->m_ncid, NC_GLOBAL, "netCDF_version", NC_CHAR,
+                     ncVersion.length(), ncVersion.toStdString().c_str()));
+  NCCHECK(nc_put_att(this->m_ncid, NC_GLOBAL, "fileformat", NC_CHAR,
+                     format.length(), format.toStdString().c_str()));
+
+  this->m_netcdfDefineMode = true;
+
+  return 0;
+}
+
+//...Stations passed one at a time are defined in batches. The file only
+//   leaves define mode when a batch is full or the file is closed, so a
+//   file that fits in one batch is defined in a single pass
+int HmdfWriter::writeNetcdfStation(HmdfStation *station) {
+  if (this->m_ncid < 0) return -1;
+
+  int ierr = this->defineNetcdfStation(station, true);
+  if (ierr != 0) return ierr;
+
+  if (this->m_netcdfPendingSize >= c_netcdfBatchSize)
+    return this->flushNetcdf();
+  return 0;
+}
+
+//...Defines the dimension and variables for the next station. When copyData
+//   is set the values are copied so the station can be released before the
+//   batch is written
+int HmdfWriter::defineNetcdfStation(const HmdfStation *station,
+                                    bool copyData) {
+  int dimid;
+  QString dimname, stationName, timeVarName, dataVarName;
+  char epoch[20] = "1970-01-01 00:00:00";
+  char utc[4] = "utc";
+  size_t stationIndex = this->m_nstations;
+  int stationNumber = static_cast<int>(stationIndex) + 1;
+
+  dimname.sprintf("%s%4.4i", "stationLength_", stationNumber);
+  stationName.sprintf("%s%4.4i", "station_", stationNumber);
+  timeVarName = "time_" + stationName;
+  dataVarName = "data_" + stationName;
+
+  if (!this->m_netcdfDefineMode) {
+    NCCHECK(nc_redef(this->m_ncid));
+    this->m_netcdfDefineMode = true;
+  }
+
+  NetcdfStation nc;
+  nc.station = copyData ? nullptr : station;
+  nc.index = stationIndex;
+
+  NCCHECK(nc_def_dim(this->m_ncid, dimname.toStdString().c_str(),
+                     station->numSnaps(), &dimid));
+  int d[1] = {dimid};
+  size_t shape[1] = {station->numSnaps()};
+
+  NCCHECK(nc_def_var(this->m_ncid, timeVarName.toStdString().c_str(),
+                     NC_INT64, 1, d, &nc.varidTime));
+  NCCHECK(nc_put_att_text(this->m_ncid, nc.varidTime, "referenceDate", 20,
+                          epoch));
+  NCCHECK(nc_put_att_text(this->m_ncid, nc.varidTime, "timezone", 3, utc));
+  NCCHECK(nc_put_att_text(this->m_ncid, nc.varidTime, "StationName",
+                          station->name().length(),
+                          station->name().toStdString().c_str()));
+  NCCHECK(nc_put_att_text(this->m_ncid, nc.varidTime, "StationID",
+                          station->id().length(),
+                          station->id().toStdString().c_str()));
+  NCCHECK(Hmdf::defineNetcdfStorage(this->m_ncid, nc.varidTime, 1, shape,
+                                    this->m_netcdfProfile,
+                                    this->m_netcdfChunking));
+
+  NCCHECK(nc_def_var(this->m_ncid, dataVarName.toStdString().c_str(),
+                     NC_DOUBLE, 1, d, &nc.varidData));
+  NCCHECK(Hmdf::defineNetcdfStorage(this->m_ncid, nc.varidData, 1, shape,
+                                    this->m_netcdfProfile,
+                                    this->m_netcdfChunking));
+  if (this->m_netcdfPrecision > 0.0)
+    NCCHECK(nc_put_att_double(this->m_ncid, nc.varidData,
+                              "quantization_precision", NC_DOUBLE, 1,
+                              &this->m_netcdfPrecision));
+  NCCHECK(nc_put_att_text(this->m_ncid, nc.varidData, "units",
+                          this->m_units.length(),
+                          this->m_units.toStdString().c_str()));
+  NCCHECK(nc_put_att_text(this->m_ncid, nc.varidData, "datum",
+                          this->m_datum.length(),
+                          this->m_datum.toStdString().c_str()));
+
+  nc.name = station->name().toStdString();
+  nc.id = station->id().toStdString();
+  nc.latitude = station->latitude();
+  nc.longitude = station->longitude();
+
+  if (copyData) {
+    HmdfSpan<const qint64> date = station->dateSpan();
+    nc.time.resize(date.size());
+    for (size_t j = 0; j < date.size(); j++) nc.time[j] = date[j] / 1000;
+    nc.data.resize(station->numSnaps());
+    Hmdf::quantize(station->dataSpan().data(), nc.data.size(),
+                   this->m_netcdfPrecision, nc.data.data());
+    this->m_netcdfPendingSize +=
+        nc.time.size() * sizeof(long long) + nc.data.size() * sizeof(double);
+  }
+
+  this->m_netcdfPending.push_back(std::move(nc));
+
+  return 0;
+}
+
+//...Leaves define mode and writes the data for every pending station
+int HmdfWriter::flushNetcdf() {
+  if (this->m_netcdfDefineMode) {
+    NCCHECK(nc_enddef(this->m_ncid));
+    this->m_netcdfDefineMode = false;
+  }
+
+  for (size_t i = 0; i < this->m_netcdfPending.size(); i++) {
+    int ierr = this->putNetcdfStation(this->m_netcdfPending[i]);
+    if (ierr != 0) {
+      this->m_netcdfPending.clear();
+      return ierr;
+    }
+  }
+
+  this->m_netcdfPending.clear();
+  this->m_netcdfPendingSize = 0;
+
+  return 0;
+}
+
+int HmdfWriter::putNetcdfStation(const NetcdfStation &nc) {
+  std::vector<long long> stationTime;
+  std::vector<double> stationData;
+  const long long *time = nc.time.data();
+  const double *data = nc.data.data();
+
+  if (nc.station != nullptr) {
+    HmdfSpan<const qint64> date = nc.station->dateSpan();
+    stationTime.resize(date.size());
+    for (size_t j = 0; j < date.size(); j++) stationTime[j] = date[j] / 1000;
+    stationData.resize(nc.station->numSnaps());
+    Hmdf::quantize(nc.station->dataSpan().data(), stationData.size(),
+                   this->m_netcdfPrecision, stationData.data());
+    time = stationTime.data();
+    data = stationData.data();
+  }
+
+  size_t index[2] = {nc.index, 0};
+  size_t stindex[1] = {nc.index};
+  size_t count[2] = {1, 200};
+  double lat[1] = {nc.latitude};
+  double lon[1] = {nc.longitude};
+  char name[200], id[200];
+  memset(name, ' ', 200);
+  memset(id, ' ', 200);
+  nc.name.copy(name, 200, 0);
+  nc.id.copy(id, 200, 0);
+
+  NCCHECK(nc_put_var1_double(this->m_ncid, this->m_varidStationX, stindex,
+                             lon));
+  NCCHECK(nc_put_var1_double(this->m_ncid, this->m_varidStationY, stindex,
+                             lat));
+  NCCHECK(nc_put_var_longlong(this->m_ncid, nc.varidTime, time));
+  NCCHECK(nc_put_var_double(this->m_ncid, nc.varidData, data));
+  NCCHECK(nc_put_vara_text(this->m_ncid, this->m_varidStationName, index,
+                           count, name));
+  NCCHECK(nc_put_vara_text(this->m_ncid, this->m_varidStationId, index, count,
+                           id));
+
+  return 0;
+}
@@ -0,0 +1,120 @@
+/*-------------------------------GPL-------------------------------------//
+//
+// MetOcean Viewer - A simple interface for viewing hydrodynamic model data
+// Copyright (C) 2018  Zach Cobell
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------*/
+#ifndef HMDFWRITER_H
+#define HMDFWRITER_H
+
+#include <QFile>
+#include <QObject>
+#include <QString>
+#include <QVector>
+#include <string>
+#include <vector>
+#include "hmdf.h"
+#include "hmdfstation.h"
+#include "metocean_global.h"
+
+//...Incremental writer for IMEDS, CSV and HMDF netCDF files. Stations are
+//   written as they are passed to write() so the full dataset never needs
+//   to be held in memory
+class HmdfWriter : public QObject {
+  Q_OBJECT
+ public:
+  explicit HmdfWriter(QObject *parent = nullptr);
+  ~HmdfWriter();
+
+  int open();
+  int write(HmdfStation *station);
+  int write(const QVector<HmdfStation *> &stations);
+  int close();
+
+  QString filename() const;
+  void setFilename(const QString &filename);
+
+  Hmdf::HmdfFileType fileType() const;
+  void setFileType(const Hmdf::HmdfFileType &fileType);
+
+  int threads() const;
+  void setThreads(int threads);
+
+  Hmdf::HmdfNetcdfProfile netcdfProfile() const;
+  void setNetcdfProfile(const Hmdf::HmdfNetcdfProfile &netcdfProfile);
+
+  Hmdf::HmdfNetcdfChunking netcdfChunking() const;
+  void setNetcdfChunking(const Hmdf::HmdfNetcdfChunking &netcdfChunking);
+
+  double netcdfPrecision() const;
+  void setNetcdfPrecision(double netcdfPrecision);
+
+  QString datum() const;
+  void setDatum(const QString &datum);
+
+  QString units() const;
+  void setUnits(const QString &units);
+
+ private:
+  //...Station whose variables have been defined but whose data has not
+  //   been written yet. When station is null the values are held in time
+  //   and data because the caller's station may be gone by the time the
+  //   batch is written
+  struct NetcdfStation {
+    const HmdfStation *station;
+    size_t index;
+    int varidTime;
+    int varidData;
+    std::string name;
+    std::string id;
+    double latitude;
+    double longitude;
+    std::vector<long long> time;
+    std::vector<double> data;
+  };
+
+  int openNetcdf();
+  int writeTextStation(HmdfStation *station);
+  void formatStation(const HmdfStation *station, std::string &buffer) const;
+  int flush();
+  int writeNetcdfStation(HmdfStation *station);
+  int defineNetcdfStation(const HmdfStation *station, bool copyData);
+  int flushNetcdf();
+  int putNetcdfStation(const NetcdfStation &nc);
+
+  QString m_filename;
+  Hmdf::HmdfFileType m_fileType;
+  QString m_datum;
+  QString m_units;
+  int m_threads;
+  Hmdf::HmdfNetcdfProfile m_netcdfProfile;
+  Hmdf::HmdfNetcdfChunking m_netcdfChunking;
+  double m_netcdfPrecision;
+
+  QFile m_file;
+  std::string m_buffer;
+  int m_ncid;
+  int m_varidStationName;
+  int m_varidStationId;
+  int m_varidStationX;
+  int m_varidStationY;
+  size_t m_nstations;
+  bool m_netcdfDefineMode;
+  size_t m_netcdfPendingSize;
+  std::vector<NetcdfStation> m_netcdfPending;
+};
+
+#endif  // HMDFWRITER_H
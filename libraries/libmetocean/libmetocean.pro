@@ -44,7 +44,10 @@ INCLUDEPATH += $$PWD/../../thirdparty/boost_1_67_0
 
 SOURCES += hmdfasciiparser.cpp  \
            hmdf.cpp  \
+           hmdfcolumnstore.cpp  \
+           hmdfreader.cpp  \
            hmdfstation.cpp  \
+           hmdfwriter.cpp  \
            netcdftimeseries.cpp  \
            noaacoops.cpp  \
            stringutil.cpp  \
@@ -57,6 +60,9 @@ SOURCES += hmdfasciiparser.cpp  \
            tideprediction.cpp \
            ndbcdata.cpp \
            stationlocations.cpp \
+           stationcatalog.cpp \
+           stationcsv.cpp \
+           stationindex.cpp \
            generic.cpp \
     constants.cpp \
     highwatermarks.cpp \
@@ -64,7 +70,11 @@ SOURCES += hmdfasciiparser.cpp  \
 
 HEADERS += hmdfasciiparser.h  \
            hmdf.h  \
+           hmdfcolumnstore.h  \
+           hmdfreader.h  \
+           hmdfspan.h  \
            hmdfstation.h  \
+           hmdfwriter.h  \
            netcdftimeseries.h  \
            noaacoops.h  \
            stringutil.h  \
@@ -78,6 +88,9 @@ HEADERS += hmdfasciiparser.h  \
            tideprediction.h \
            ndbcdata.h \
            stationlocations.h \
+           stationcatalog.h \
+           stationcsv.h \
+           stationindex.h \
            metocean_global.h \
            generic.h \
     constants.h \
@@ -104,3 +117,22 @@ else:unix: PRE_TARGETDEPS += $$OUT_PWD/../libtide/libtide.a
 
 RESOURCES += \
     resource_files.qrc
+
+#...Binary station catalog, generated from the CSV files in data/ by
+#   mkstationcatalog and compiled into the library
+win32:CONFIG(release, debug|release): MKSTATIONCATALOG = $$OUT_PWD/../mkstationcatalog/release/mkstationcatalog.exe
+else:win32:CONFIG(debug, debug|release): MKSTATIONCATALOG = $$OUT_PWD/../mkstationcatalog/debug/mkstationcatalog.exe
+else:unix: MKSTATIONCATALOG = $$OUT_PWD/../mkstationcatalog/mkstationcatalog
+
+STATION_CSV = $$PWD/data/noaa_stations.csv \
+              $$PWD/data/usgs_stations.csv \
+              $$PWD/data/xtide_stations.csv \
+              $$PWD/data/ndbc_stations.csv
+
+stationcatalog.input = STATION_CSV
+stationcatalog.output = $$OUT_PWD/stationcatalogdata.cpp
+stationcatalog.commands = $$shell_path($$MKSTATIONCATALOG) ${QMAKE_FILE_OUT} ${QMAKE_FILE_IN}
+stationcatalog.depends = $$MKSTATIONCATALOG
+stationcatalog.variable_out = SOURCES
+stationcatalog.CONFIG += combine
+QMAKE_EXTRA_COMPILERS += stationcatalog
@@ -140,7 +140,7 @@ int NdbcData::formatNdbcResponse(QVector<QStringList> &serverResponse,
   n = d.length() - r;
 
   for (int i = 0; i < n; i++) {
-    HmdfStation *s = new HmdfStation(data);
+    HmdfStation *s = new HmdfStation();
 
     s->setCoordinate(this->station().coordinate());
     if (this->m_dataNameMap.contains(d[i + r])) {
@@ -153,6 +153,11 @@ int NdbcData::formatNdbcResponse(QVector<QStringList> &serverResponse,
     st.push_back(s);
   }
 
+  int nLines = 0;
+  for (int i = 0; i < serverResponse.length(); i++)
+    nLines += serverResponse[i].length() - p;
+  for (int i = 0; i < st.length(); i++) st[i]->reserve(nLines);
+
   qint64 start = this->startDate().toMSecsSinceEpoch();
   qint64 end = this->endDate().toMSecsSinceEpoch();
 
@@ -18,6 +18,12 @@
 //
 //-----------------------------------------------------------------------*/
 #include "netcdftimeseries.h"
+#include <QHash>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "hmdfasciiparser.h"
 #include "netcdf.h"
 
 #define NCCHECK(ierr)     \
@@ -26,6 +32,34 @@
     return ierr;          \
   }
 
+#define NCCHECK_STATION(ierr) \
+  if (ierr != NC_NOERR) {     \
+    this->close();            \
+    return ierr;              \
+  }
+
+//...Milliseconds since the epoch for a "yyyy-MM-dd hh:mm:ss" reference date
+static qint64 referenceMSecsSinceEpoch(const char *referenceDate) {
+  int yr, month, day, hr, min, sec;
+  if (sscanf(referenceDate, "%d-%d-%d %d:%d:%d", &yr, &month, &day, &hr,
+             &min, &sec) != 6)
+    return 0;
+  return HmdfAsciiParser::toMSecsSinceEpoch(yr, month, day, hr, min, sec);
+}
+
+//...Reads a text attribute into value if it exists
+static void readTextAttribute(int ncid, int varid, const char *name,
+                              QString &value) {
+  size_t length;
+  if (nc_inq_attlen(ncid, varid, name, &length) != NC_NOERR) return;
+  std::string text(length, ' ');
+  if (length > 0 &&
+      nc_get_att_text(ncid, varid, name, &text[0]) != NC_NOERR)
+    return;
+  value = QString::fromStdString(text).simplified();
+  return;
+}
+
 NetcdfTimeseries::NetcdfTimeseries(QObject *parent) : QObject(parent) {
   this->m_filename = QString();
   this->m_epsg = 4326;
@@ -33,8 +67,16 @@ NetcdfTimeseries::NetcdfTimeseries(QObject *parent) : QObject(parent) {
   this->m_verticalDatum = "unknown";
   this->m_horizontalProjection = "WGS84";
   this->m_numStations = 0;
+  this->m_ncid = -1;
+  this->m_layout = LayoutPerStation;
+  this->m_varidTime = -1;
+  this->m_varidData = -1;
+  this->m_numTimes = 0;
+  this->m_refMsec = 0;
 }
 
+NetcdfTimeseries::~NetcdfTimeseries() { this->close(); }
+
 QString NetcdfTimeseries::filename() const { return this->m_filename; }
 
 void NetcdfTimeseries::setFilename(const QString &filename) {
@@ -45,21 +87,113 @@ int NetcdfTimeseries::epsg() const { return this->m_epsg; }
 
 void NetcdfTimeseries::setEpsg(int epsg) { this->m_epsg = epsg; }
 
-int NetcdfTimeseries::read() {
+QVector<size_t> NetcdfTimeseries::stationIndices() const {
+  return this->m_stationIndices;
+}
+
+//...Limits read() to the stations at these indices in the file
+void NetcdfTimeseries::setStationIndices(const QVector<size_t> &indices) {
+  this->m_stationIndices = indices;
+}
+
+QStringList NetcdfTimeseries::stationNames() const {
+  return this->m_stationNames;
+}
+
+//...Limits read() to the stations with these names. Takes precedence over
+//   setStationIndices
+void NetcdfTimeseries::setStationNames(const QStringList &names) {
+  this->m_stationNames = names;
+}
+
+//...Indices of the stations that read() returns, in the requested order.
+//   Unknown names and indices past the end of the file are skipped
+QVector<size_t> NetcdfTimeseries::selectedStations() const {
+  QVector<size_t> selection;
+  if (!this->m_stationNames.isEmpty()) {
+    QHash<QString, size_t> index;
+    for (size_t i = 0; i < this->m_numStations; i++)
+      if (!index.contains(this->m_stationName[i]))
+        index[this->m_stationName[i]] = i;
+    for (int i = 0; i < this->m_stationNames.size(); i++) {
+      QHash<QString, size_t>::const_iterator it =
+          index.find(this->m_stationNames[i]);
+      if (it != index.end()) selection.push_back(it.value());
+    }
+  } else if (!this->m_stationIndices.isEmpty()) {
+    for (int i = 0; i < this->m_stationIndices.size(); i++)
+      if (this->m_stationIndices[i] < this->m_numStations)
+        selection.push_back(this->m_stationIndices[i]);
+  } else {
+    selection.resize(this->m_numStations);
+    for (size_t i = 0; i < this->m_numStations; i++) selection[i] = i;
+  }
+  return selection;
+}
+
+//...Reads the selected stations into the Hmdf object. Values are read
+//   directly into the Hmdf column store without intermediate copies
+int NetcdfTimeseries::read(Hmdf *hmdf) {
+  int ierr = this->open();
+  if (ierr != 0) return ierr;
+
+  hmdf->setDatum(this->m_verticalDatum);
+  hmdf->setUnits(this->m_units);
+  hmdf->setHeader1("none");
+  hmdf->setHeader2("none");
+  hmdf->setHeader3("none");
+  hmdf->setSuccess(false);
+
+  QVector<size_t> selection = this->selectedStations();
+
+  bool contiguous = this->m_layout != LayoutPerStation;
+  size_t nValues = 0;
+  for (int k = 0; k < selection.size(); k++) {
+    if (this->m_layout != LayoutPerStation)
+      nValues += this->m_stationLength[selection[k]];
+    if (selection[k] != selection[0] + k) contiguous = false;
+  }
+  hmdf->store()->reserve(selection.size(), nValues);
+
+  QVector<HmdfStation *> stations;
+  if (contiguous && !selection.isEmpty()) {
+    ierr = this->readStationRange(selection[0], selection.size(),
+                                  hmdf->store(), stations);
+  } else {
+    for (int k = 0; k < selection.size(); k++) {
+      HmdfStation *station = new HmdfStation(hmdf->store());
+      stations.push_back(station);
+      ierr = this->readStation(selection[k], station);
+      if (ierr != 0) break;
+    }
+  }
+
+  if (ierr != 0) {
+    for (int k = 0; k < stations.size(); k++) delete stations[k];
+    this->close();
+    return ierr;
+  }
+
+  for (int k = 0; k < stations.size(); k++) hmdf->addStation(stations[k]);
+  this->close();
+
+  hmdf->setSuccess(true);
+
+  return 0;
+}
+
+size_t NetcdfTimeseries::numStations() const { return this->m_numStations; }
+
+//...Opens the file for reading one station at a time with readStation. Only
+//   the station locations and names are read here
+int NetcdfTimeseries::open() {
   if (this->m_filename == QString()) return 1;
+  this->close();
 
-  QDateTime refTime;
-  refTime.setTimeSpec(Qt::UTC);
-  QString station_dim_string, station_time_var_string, station_data_var_string,
-      stationNameString;
-  size_t stationNameLength, length;
-  int ierr, ncid;
-  int dimid_nstations, dimidStationLength, dimid_stationNameLen;
-  int varid_time, varid_data, varid_xcoor, varid_ycoor, varid_stationName;
-  int epsg;
-  char timeChar[80];
-  char *stationName;
-  double *varData, *xcoor, *ycoor;
+  int ncid, ierr, epsg;
+  int dimid_nstations, dimid_stationNameLen;
+  int varid_xcoor, varid_ycoor, varid_stationName;
+  size_t stationNameLength;
 
   NCCHECK(nc_open(this->m_filename.toStdString().c_str(), NC_NOWRITE, &ncid));
   NCCHECK(nc_inq_dimid(ncid, "numStations", &dimid_nstations));
@@ -73,129 +207,287 @@ int NetcdfTimeseries::read() {
 
   this->setEpsg(epsg);
 
-  xcoor = (double *)malloc(sizeof(double) * this->m_numStations);
-  ycoor = (double *)malloc(sizeof(double) * this->m_numStations);
-
-  ierr = nc_get_var_double(ncid, varid_xcoor, xcoor);
-  if (ierr != NC_NOERR) {
-    free(xcoor);
-    free(ycoor);
-    nc_close(ncid);
-    return ierr;
-  }
+  this->m_xcoor.resize(this->m_numStations);
+  this->m_ycoor.resize(this->m_numStations);
+  NCCHECK(nc_get_var_double(ncid, varid_xcoor, this->m_xcoor.data()));
+  NCCHECK(nc_get_var_double(ncid, varid_ycoor, this->m_ycoor.data()));
 
-  ierr = nc_get_var_double(ncid, varid_ycoor, ycoor);
-  if (ierr != NC_NOERR) {
-    free(xcoor);
-    free(ycoor);
-    nc_close(ncid);
-    return ierr;
-  }
+  QByteArray names(stationNameLength * this->m_numStations, ' ');
+  ierr = nc_get_var_text(ncid, varid_stationName, names.data());
+  NCCHECK(ierr);
 
+  this->m_stationName.resize(this->m_numStations);
   for (size_t i = 0; i < this->m_numStations; i++) {
-    this->m_xcoor.push_back(xcoor[i]);
-    this->m_ycoor.push_back(ycoor[i]);
+    this->m_stationName[i] =
+        QString::fromLatin1(names.constData() + i * stationNameLength,
+                            stationNameLength)
+            .simplified();
   }
 
-  free(xcoor);
-  free(ycoor);
+  ierr = this->readLayout(ncid);
+  if (ierr != NC_NOERR) return ierr;
 
-  stationName =
-      (char *)malloc(sizeof(char) * stationNameLength * this->m_numStations);
+  this->m_ncid = ncid;
 
-  NCCHECK(nc_get_var_text(ncid, varid_stationName, stationName));
-  stationNameString = QString(stationName);
+  return 0;
+}
 
-  free(stationName);
+int NetcdfTimeseries::readStation(size_t index, HmdfStation *station) {
+  if (this->m_ncid < 0 || index >= this->m_numStations) return 1;
 
-  for (size_t i = 0; i < this->m_numStations; i++) {
-    this->m_stationName.push_back(
-        stationNameString.mid(200 * i, 200).simplified());
-  }
+  int ierr = this->m_layout == LayoutPerStation
+                 ? this->readStationSeries(index, station)
+                 : this->readStationSlice(index, station);
+  if (ierr != 0) return ierr;
 
-  this->m_time.resize(this->m_numStations);
-  this->m_data.resize(this->m_numStations);
+  this->setStationMetadata(index, station);
 
-  for (size_t i = 0; i < this->m_numStations; i++) {
-    station_dim_string.sprintf("stationLength_%4.4d", i + 1);
-    station_time_var_string.sprintf("time_station_%4.4d", i + 1);
-    station_data_var_string.sprintf("data_station_%4.4d", i + 1);
-
-    NCCHECK(nc_inq_dimid(ncid, station_dim_string.toStdString().c_str(),
-                         &dimidStationLength));
+  return 0;
+}
 
-    NCCHECK(nc_inq_dimlen(ncid, dimidStationLength, &length));
-    this->m_stationLength.push_back(length);
+void NetcdfTimeseries::setStationMetadata(size_t index,
+                                          HmdfStation *station) const {
+  station->setLatitude(this->m_ycoor[index]);
+  station->setLongitude(this->m_xcoor[index]);
+  station->setName(this->m_stationName[index]);
+  station->setId(this->m_stationName[index]);
+  station->setStationIndex(index);
+  station->setIsNull(false);
+  return;
+}
 
-    NCCHECK(nc_inq_varid(ncid, station_time_var_string.toStdString().c_str(),
-                         &varid_time));
+//...Reads stations [first, first + n) of the 20181101 layout. Those
+//   stations are stored back to back in the file, and the stations created
+//   here are added one after another to the store so they are back to back
+//   there too. Each variable is then read with a single hyperslab
+int NetcdfTimeseries::readStationRange(
+    size_t first, size_t n, const QSharedPointer<HmdfColumnStore> &store,
+    QVector<HmdfStation *> &stations) {
+  bool shared = this->m_layout == LayoutSharedTime;
+  size_t total = 0;
+  for (size_t k = 0; k < n; k++) {
+    HmdfStation *station = new HmdfStation(store);
+    stations.push_back(station);
+    station->resize(this->m_stationLength[first + k]);
+    this->setStationMetadata(first + k, station);
+    total += this->m_stationLength[first + k];
+  }
+  if (total == 0) return 0;
+
+  qint64 *date = stations.first()->dateSpan().data();
+  double *data = stations.first()->dataSpan().data();
+  HmdfSpan<qint64> lastDate = stations.last()->dateSpan();
+  HmdfSpan<double> lastData = stations.last()->dataSpan();
+
+  //...Fall back to a read per station if the series are not contiguous
+  if (lastDate.data() + lastDate.size() != date + total ||
+      lastData.data() + lastData.size() != data + total) {
+    for (size_t k = 0; k < n; k++) {
+      int ierr = this->readStation(first + k, stations[k]);
+      if (ierr != 0) return ierr;
+    }
+    return 0;
+  }
 
-    NCCHECK(nc_inq_varid(ncid, station_data_var_string.toStdString().c_str(),
-                         &varid_data));
+  int ncid = this->m_ncid;
+  size_t dataStart[2] = {shared ? first : this->m_stationStart[first], 0};
+  size_t dataCount[2] = {shared ? n : total, this->m_numTimes};
+  NCCHECK_STATION(nc_get_vara_double(ncid, this->m_varidData, dataStart,
+                                     dataCount, data));
+
+  if (shared) {
+    int ierr = this->readSharedTime();
+    if (ierr != 0) return ierr;
+    for (size_t k = 0; k < n; k++)
+      memcpy(date + k * this->m_numTimes, this->m_sharedTime.data(),
+             this->m_numTimes * sizeof(qint64));
+  } else {
+    size_t timeStart[1] = {this->m_stationStart[first]};
+    size_t timeCount[1] = {total};
+    NCCHECK_STATION(nc_get_vara_longlong(ncid, this->m_varidTime, timeStart,
+                                         timeCount, date));
+    for (size_t j = 0; j < total; j++)
+      date[j] = this->m_refMsec + date[j] * 1000;
+  }
 
-    NCCHECK(nc_get_att_text(ncid, varid_time, "referenceDate", timeChar));
-    QString timeString = QString(timeChar).mid(0, 19);
-    refTime = QDateTime::fromString(timeString, "yyyy-MM-dd hh:mm:ss");
-    refTime.setTimeSpec(Qt::UTC);
+  return 0;
+}
 
-    qint64 *timeData = (qint64 *)malloc(sizeof(qint64) * length);
-    varData = (double *)malloc(sizeof(double) * length);
+//...Reads and converts the time variable of the shared time layout once
+int NetcdfTimeseries::readSharedTime() {
+  if (this->m_sharedTime.size() == this->m_numTimes) return 0;
 
-    ierr = nc_get_var_double(ncid, varid_data, varData);
-    if (ierr != NC_NOERR) {
-      free(timeData);
-      free(varData);
-      nc_close(ncid);
-      return ierr;
-    }
+  int ncid = this->m_ncid;
+  this->m_sharedTime.resize(this->m_numTimes);
+  NCCHECK_STATION(nc_get_var_longlong(ncid, this->m_varidTime,
+                                      this->m_sharedTime.data()));
+  for (size_t j = 0; j < this->m_numTimes; j++)
+    this->m_sharedTime[j] = this->m_refMsec + this->m_sharedTime[j] * 1000;
 
-    ierr = nc_get_var_longlong(ncid, varid_time, timeData);
-    if (ierr != NC_NOERR) {
-      free(timeData);
-      free(varData);
-      nc_close(ncid);
-      return ierr;
-    }
+  return 0;
+}
 
-    this->m_data[i].resize(length);
-    this->m_time[i].resize(length);
+//...Reads a station from the 20180123 layout, where each station has its
+//   own dimension and variables
+int NetcdfTimeseries::readStationSeries(size_t index, HmdfStation *station) {
+  int ncid = this->m_ncid;
+  int dimidStationLength, varid_time, varid_data;
+  size_t length;
+  char timeChar[80] = {0};
+  QString station_dim_string, station_time_var_string,
+      station_data_var_string;
+
+  int stationNumber = static_cast<int>(index) + 1;
+  station_dim_string.sprintf("stationLength_%4.4d", stationNumber);
+  station_time_var_string.sprintf("time_station_%4.4d", stationNumber);
+  station_data_var_string.sprintf("data_station_%4.4d", stationNumber);
+
+  NCCHECK_STATION(nc_inq_dimid(
+      ncid, station_dim_string.toStdString().c_str(), &dimidStationLength));
+  NCCHECK_STATION(nc_inq_dimlen(ncid, dimidStationLength, &length));
+  NCCHECK_STATION(nc_inq_varid(
+      ncid, station_time_var_string.toStdString().c_str(), &varid_time));
+  NCCHECK_STATION(nc_inq_varid(
+      ncid, station_data_var_string.toStdString().c_str(), &varid_data));
+  NCCHECK_STATION(
+      nc_get_att_text(ncid, varid_time, "referenceDate", timeChar));
+
+  qint64 refMsec = referenceMSecsSinceEpoch(timeChar);
+
+  station->resize(length);
+  HmdfSpan<qint64> date = station->dateSpan();
+  HmdfSpan<double> data = station->dataSpan();
+
+  NCCHECK_STATION(nc_get_var_double(ncid, varid_data, data.data()));
+  NCCHECK_STATION(nc_get_var_longlong(ncid, varid_time, date.data()));
+
+  for (size_t j = 0; j < length; j++) date[j] = refMsec + date[j] * 1000;
 
-    for (size_t j = 0; j < length; j++) {
-      this->m_data[i][j] = varData[j];
-      this->m_time[i][j] = refTime.addSecs(timeData[j]).toMSecsSinceEpoch();
-    }
+  return 0;
+}
 
-    free(timeData);
-    free(varData);
+//...Reads a station from the 20181101 layout as a hyperslab of the shared
+//   time and data variables
+int NetcdfTimeseries::readStationSlice(size_t index, HmdfStation *station) {
+  int ncid = this->m_ncid;
+  size_t length = this->m_stationLength[index];
+  bool shared = this->m_layout == LayoutSharedTime;
+
+  station->resize(length);
+  if (length == 0) return 0;
+
+  HmdfSpan<qint64> date = station->dateSpan();
+  HmdfSpan<double> data = station->dataSpan();
+
+  size_t dataStart[2] = {shared ? index : this->m_stationStart[index], 0};
+  size_t dataCount[2] = {shared ? 1 : length, length};
+  NCCHECK_STATION(nc_get_vara_double(ncid, this->m_varidData, dataStart,
+                                     dataCount, data.data()));
+
+  if (shared) {
+    int ierr = this->readSharedTime();
+    if (ierr != 0) return ierr;
+    memcpy(date.data(), this->m_sharedTime.data(), length * sizeof(qint64));
+    return 0;
   }
 
-  NCCHECK(nc_close(ncid));
+  size_t timeStart[1] = {this->m_stationStart[index]};
+  size_t timeCount[1] = {length};
+  NCCHECK_STATION(nc_get_vara_longlong(ncid, this->m_varidTime, timeStart,
+                                       timeCount, date.data()));
+
+  for (size_t j = 0; j < length; j++)
+    date[j] = this->m_refMsec + date[j] * 1000;
 
   return 0;
 }
 
-int NetcdfTimeseries::toHmdf(Hmdf *hmdf) {
-  hmdf->setDatum("unknown");
-  hmdf->setHeader1("none");
-  hmdf->setHeader2("none");
-  hmdf->setHeader3("none");
-  hmdf->setSuccess(false);
+//...Determines the file layout from the fileformat attribute. For the
+//   20181101 layout the station lengths and offsets into the shared
+//   variables are read here
+int NetcdfTimeseries::readLayout(int ncid) {
+  size_t formatLength;
+  int varid;
+  this->m_layout = LayoutPerStation;
+  this->m_stationStart.clear();
+  this->m_sharedTime.clear();
+  this->m_units = "unknown";
+  this->m_verticalDatum = "unknown";
 
-  for (size_t i = 0; i < this->m_numStations; i++) {
-    HmdfStation *station = new HmdfStation(hmdf);
-    station->setDate(this->m_time[i]);
-    station->setData(this->m_data[i]);
-    station->setLatitude(this->m_ycoor[i]);
-    station->setLongitude(this->m_xcoor[i]);
-    station->setName(this->m_stationName[i]);
-    station->setId(this->m_stationName[i]);
-    station->setStationIndex(i);
-    hmdf->addStation(station);
+  if (nc_inq_varid(ncid, "data_station_0001", &varid) == NC_NOERR ||
+      nc_inq_varid(ncid, "data", &varid) == NC_NOERR) {
+    readTextAttribute(ncid, varid, "units", this->m_units);
+    readTextAttribute(ncid, varid, "datum", this->m_verticalDatum);
   }
 
-  hmdf->setSuccess(true);
+  if (nc_inq_attlen(ncid, NC_GLOBAL, "fileformat", &formatLength) !=
+      NC_NOERR)
+    return NC_NOERR;
+
+  std::string format(formatLength, ' ');
+  NCCHECK(nc_get_att_text(ncid, NC_GLOBAL, "fileformat", &format[0]));
+  if (format != "20181101") return NC_NOERR;
+
+  int ndims, dimids[2];
+  char timeChar[80] = {0};
+  NCCHECK(nc_inq_varid(ncid, "time", &this->m_varidTime));
+  NCCHECK(nc_inq_varid(ncid, "data", &this->m_varidData));
+  NCCHECK(nc_inq_varndims(ncid, this->m_varidData, &ndims));
+  NCCHECK(nc_inq_vardimid(ncid, this->m_varidData, dimids));
+  NCCHECK(nc_inq_dimlen(ncid, dimids[ndims - 1], &this->m_numTimes));
+  NCCHECK(nc_get_att_text(ncid, this->m_varidTime, "referenceDate", timeChar));
+  this->m_refMsec = referenceMSecsSinceEpoch(timeChar);
+
+  this->m_stationLength.resize(this->m_numStations);
+  this->m_stationStart.resize(this->m_numStations);
+
+  if (ndims == 2) {
+    this->m_layout = LayoutSharedTime;
+    for (size_t i = 0; i < this->m_numStations; i++) {
+      this->m_stationLength[i] = this->m_numTimes;
+      this->m_stationStart[i] = 0;
+    }
+  } else {
+    this->m_layout = LayoutRagged;
+    int varid_length;
+    std::vector<long long> length(this->m_numStations);
+    NCCHECK(nc_inq_varid(ncid, "stationLength", &varid_length));
+    if (this->m_numStations > 0)
+      NCCHECK(nc_get_var_longlong(ncid, varid_length, length.data()));
+    size_t start = 0;
+    for (size_t i = 0; i < this->m_numStations; i++) {
+      this->m_stationLength[i] = static_cast<size_t>(length[i]);
+      this->m_stationStart[i] = start;
+      start += this->m_stationLength[i];
+    }
+  }
 
-  return 0;
+  return NC_NOERR;
+}
+
+void NetcdfTimeseries::close() {
+  if (this->m_ncid >= 0) nc_close(this->m_ncid);
+  this->m_ncid = -1;
+  this->m_sharedTime.clear();
+  return;
+}
+
+//...True when the open file is an HMDF netCDF file in either the 20180123
+//   or 20181101 layout
+bool NetcdfTimeseries::isHmdfNetcdf(int ncid) {
+  int varid;
+  size_t formatLength;
+  bool found = nc_inq_varid(ncid, "time_station_0001", &varid) == NC_NOERR;
+  if (!found &&
+      nc_inq_attlen(ncid, NC_GLOBAL, "fileformat", &formatLength) ==
+          NC_NOERR) {
+    std::string format(formatLength, ' ');
+    if (nc_get_att_text(ncid, NC_GLOBAL, "fileformat", &format[0]) ==
+        NC_NOERR)
+      found = format == "20181101" &&
+              nc_inq_varid(ncid, "data", &varid) == NC_NOERR;
+  }
+  return found;
 }
 
 int NetcdfTimeseries::getEpsg(QString file) {
@@ -22,7 +22,10 @@
 
 #include <QDateTime>
 #include <QObject>
+#include <QSharedPointer>
+#include <QStringList>
 #include <QVector>
+#include <vector>
 #include "hmdf.h"
 #include "metocean_global.h"
 
@@ -30,10 +33,15 @@ class NetcdfTimeseries : public QObject {
   Q_OBJECT
  public:
   explicit NetcdfTimeseries(QObject *parent = nullptr);
+  ~NetcdfTimeseries();
 
-  int read();
+  int read(Hmdf *hmdf);
 
-  int toHmdf(Hmdf *hmdf);
+  int open();
+  int readStation(size_t index, HmdfStation *station);
+  void close();
+
+  size_t numStations() const;
 
   QString filename() const;
   void setFilename(const QString &filename);
@@ -41,22 +49,50 @@ class NetcdfTimeseries : public QObject {
   int epsg() const;
   void setEpsg(int epsg);
 
+  QVector<size_t> stationIndices() const;
+  void setStationIndices(const QVector<size_t> &indices);
+
+  QStringList stationNames() const;
+  void setStationNames(const QStringList &names);
+
   static int getEpsg(QString file);
 
+  static bool isHmdfNetcdf(int ncid);
+
  private:
+  enum NetcdfLayout { LayoutPerStation, LayoutRagged, LayoutSharedTime };
+
+  int readLayout(int ncid);
+  int readStationSeries(size_t index, HmdfStation *station);
+  int readStationSlice(size_t index, HmdfStation *station);
+  int readStationRange(size_t first, size_t n,
+                       const QSharedPointer<HmdfColumnStore> &store,
+                       QVector<HmdfStation *> &stations);
+  int readSharedTime();
+  void setStationMetadata(size_t index, HmdfStation *station) const;
+  QVector<size_t> selectedStations() const;
+
   QString m_filename;
   QString m_units;
   QString m_verticalDatum;
   QString m_horizontalProjection;
   int m_epsg;
+  int m_ncid;
+  NetcdfLayout m_layout;
+  int m_varidTime;
+  int m_varidData;
+  size_t m_numTimes;
+  qint64 m_refMsec;
   size_t m_numStations;
 
   QVector<double> m_xcoor;
   QVector<double> m_ycoor;
   QVector<size_t> m_stationLength;
+  QVector<size_t> m_stationStart;
   QVector<QString> m_stationName;
-  QVector<QVector<qint64> > m_time;
-  QVector<QVector<double> > m_data;
+  QVector<size_t> m_stationIndices;
+  QStringList m_stationNames;
+  std::vector<qint64> m_sharedTime;
 };
 
 #endif  // NETCDFTIMESERIES_H
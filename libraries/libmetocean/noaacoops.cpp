@@ -26,6 +26,45 @@
 #include <QNetworkAccessManager>
 #include <QNetworkReply>
 #include <QNetworkRequest>
+#include <QQueue>
+#include <QSet>
+#include <QTimer>
+#include <algorithm>
+#include <functional>
+#include <limits>
+
+static const QString c_defaultBaseUrl =
+    QStringLiteral("http://tidesandcurrents.noaa.gov/api/datagetter");
+static const int c_defaultMaxConcurrentDownloads = 4;
+static const int c_defaultMaxRetries = 3;
+static const int c_maxRedirects = 5;
+static const int c_defaultRequestTimeout = 60000;
+
+//...Delay before a retry, multiplied by the attempt number (milliseconds)
+static const int c_retryDelay = 500;
+
+//...Failures that are worth another attempt: dropped connections, time
+//   outs, rate limiting and server side errors
+static bool isTransientError(QNetworkReply *reply) {
+  int status =
+      reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+  if (status == 429 || status >= 500) return true;
+
+  switch (reply->error()) {
+    case QNetworkReply::RemoteHostClosedError:
+    case QNetworkReply::TimeoutError:
+    case QNetworkReply::TemporaryNetworkFailureError:
+    case QNetworkReply::NetworkSessionFailedError:
+    case QNetworkReply::ProxyTimeoutError:
+    case QNetworkReply::UnknownNetworkError:
+    case QNetworkReply::InternalServerError:
+    case QNetworkReply::ServiceUnavailableError:
+    case QNetworkReply::UnknownServerError:
+      return true;
+    default:
+      return false;
+  }
+}
 
 NoaaCoOps::NoaaCoOps(Station &station, QDateTime startDate, QDateTime endDate,
                      QString product, QString datum, QString units,
@@ -35,9 +74,39 @@ NoaaCoOps::NoaaCoOps(Station &station, QDateTime startDate, QDateTime endDate,
   this->m_units = units;
   this->m_datum = datum;
   this->m_useJson = true;
+  this->m_baseUrl = c_defaultBaseUrl;
+  this->m_maxConcurrentDownloads = c_defaultMaxConcurrentDownloads;
+  this->m_maxRetries = c_defaultMaxRetries;
+  this->m_requestTimeout = c_defaultRequestTimeout;
   this->parseProduct();
 }
 
+QString NoaaCoOps::baseUrl() const { return this->m_baseUrl; }
+
+void NoaaCoOps::setBaseUrl(const QString &baseUrl) {
+  this->m_baseUrl = baseUrl;
+}
+
+int NoaaCoOps::maxConcurrentDownloads() const {
+  return this->m_maxConcurrentDownloads;
+}
+
+void NoaaCoOps::setMaxConcurrentDownloads(int maxConcurrentDownloads) {
+  this->m_maxConcurrentDownloads = std::max(1, maxConcurrentDownloads);
+}
+
+int NoaaCoOps::maxRetries() const { return this->m_maxRetries; }
+
+void NoaaCoOps::setMaxRetries(int maxRetries) {
+  this->m_maxRetries = std::max(0, maxRetries);
+}
+
+int NoaaCoOps::requestTimeout() const { return this->m_requestTimeout; }
+
+void NoaaCoOps::setRequestTimeout(int requestTimeout) {
+  this->m_requestTimeout = std::max(1, requestTimeout);
+}
+
 int NoaaCoOps::parseProduct() {
   this->m_productParsed = this->m_product.split(":");
   return 0;
@@ -81,69 +150,138 @@ int NoaaCoOps::generateDateRanges(QVector<QDateTime> &startDateList,
   return 0;
 }
 
+QUrl NoaaCoOps::requestUrl(const QDateTime &startDate,
+                           const QDateTime &endDate) const {
+  // Make the date string
+  QString startString = startDate.toString(QStringLiteral("yyyyMMdd hh:mm"));
+  QString endString = endDate.toString(QStringLiteral("yyyyMMdd hh:mm"));
+
+  //...Select parser type
+  QString format;
+  if (this->m_useJson) {
+    format = "json";
+  } else {
+    format = "csv";
+  }
+
+  // Build the URL to request data from the NOAA CO-OPS API
+  QString requestURL =
+      this->m_baseUrl + QStringLiteral("?") + QStringLiteral("product=") +
+      this->m_productParsed[0] + QStringLiteral("&application=metoceanviewer") +
+      QStringLiteral("&begin_date=") + startString +
+      QStringLiteral("&end_date=") + endString + QStringLiteral("&station=") +
+      this->station().id() + QStringLiteral("&time_zone=GMT&units=") +
+      this->m_units + QStringLiteral("&interval=&format=") + format;
+
+  // Allow a different datum where allowed
+  if (this->m_datum != QStringLiteral("Stnd"))
+    requestURL = requestURL + QStringLiteral("&datum=") + this->m_datum;
+
+  return QUrl(requestURL);
+}
+
 int NoaaCoOps::downloadDataFromNoaaServer(QVector<QDateTime> startDateList,
                                           QVector<QDateTime> endDateList,
                                           QVector<QString> &downloadedData) {
-  QNetworkAccessManager *manager = new QNetworkAccessManager(this);
-
-  for (int i = 0; i < startDateList.length(); i++) {
-    // Make the date string
-    QString startString =
-        startDateList[i].toString(QStringLiteral("yyyyMMdd hh:mm"));
-    QString endString =
-        endDateList[i].toString(QStringLiteral("yyyyMMdd hh:mm"));
-
-    //...Select parser type
-    QString format;
-    if (this->m_useJson) {
-      format = "json";
-    } else {
-      format = "csv";
+  QNetworkAccessManager manager;
+  QEventLoop loop;
+
+  //...Each chunk is written to its own slot, so the list stays in date
+  //   order regardless of the order the downloads finish in
+  int nChunks = startDateList.length();
+  downloadedData.clear();
+  downloadedData.resize(nChunks);
+  if (nChunks == 0) return 0;
+
+  QQueue<int> pending;
+  for (int i = 0; i < nChunks; i++) pending.enqueue(i);
+  QVector<int> attempts(nChunks, 0);
+  QVector<int> redirects(nChunks, 0);
+  int inFlight = 0;
+  bool failed = false;
+  QSet<QNetworkReply *> timedOut;
+
+  //...A chunk counts as in flight from its first request until it either
+  //   succeeds or runs out of retries, including any redirect or back off
+  std::function<void(int, const QUrl &)> send;
+  std::function<void()> launch = [&]() {
+    while (!failed && !pending.isEmpty() &&
+           inFlight < this->m_maxConcurrentDownloads) {
+      int i = pending.dequeue();
+      inFlight++;
+      attempts[i]++;
+      send(i, this->requestUrl(startDateList[i], endDateList[i]));
     }
+    if (inFlight == 0) loop.quit();
+  };
+
+  send = [&](int i, const QUrl &url) {
+    QNetworkReply *reply = manager.get(QNetworkRequest(url));
+
+    //...Abort a reply that stops receiving data. The timer restarts on
+    //   every bit of progress, so it only fires for a stalled request
+    QTimer *timer = new QTimer(reply);
+    timer->setSingleShot(true);
+    connect(timer, &QTimer::timeout, reply, [&, reply]() {
+      timedOut.insert(reply);
+      reply->abort();
+    });
+    connect(reply, &QNetworkReply::downloadProgress, timer,
+            [timer]() { timer->start(); });
+    timer->start(this->m_requestTimeout);
+
+    connect(reply, &QNetworkReply::finished, &loop, [&, i, reply, timer]() {
+      bool replyTimedOut = timedOut.remove(reply);
+      timer->stop();
+
+      //...Check for a redirect from NOAA. This fixes bug #26
+      QVariant redirectionTargetURL =
+          reply->attribute(QNetworkRequest::RedirectionTargetAttribute);
+      if (!failed && !redirectionTargetURL.isNull() &&
+          redirects[i] < c_maxRedirects) {
+        redirects[i]++;
+        reply->deleteLater();
+        send(i, reply->url().resolved(redirectionTargetURL.toUrl()));
+        return;
+      }
 
-    // Build the URL to request data from the NOAA CO-OPS API
-    QString requestURL =
-        QStringLiteral("http://tidesandcurrents.noaa.gov/api/datagetter?") +
-        QStringLiteral("product=") + this->m_productParsed[0] +
-        QStringLiteral("&application=metoceanviewer") +
-        QStringLiteral("&begin_date=") + startString +
-        QStringLiteral("&end_date=") + endString + QStringLiteral("&station=") +
-        this->station().id() + QStringLiteral("&time_zone=GMT&units=") +
-        this->m_units + QStringLiteral("&interval=&format=") + format;
-
-    // Allow a different datum where allowed
-    if (this->m_datum != QStringLiteral("Stnd"))
-      requestURL = requestURL + QStringLiteral("&datum=") + this->m_datum;
-
-    // Send the request
-    QEventLoop loop;
-    QNetworkReply *reply = manager->get(QNetworkRequest(QUrl(requestURL)));
-    connect(reply, SIGNAL(finished()), &loop, SLOT(quit()));
-    connect(reply, SIGNAL(error(QNetworkReply::NetworkError)), &loop,
-            SLOT(quit()));
-    loop.exec();
-
-    //...Check for a redirect from NOAA. This fixes bug #26
-    QVariant redirectionTargetURL =
-        reply->attribute(QNetworkRequest::RedirectionTargetAttribute);
-    if (!redirectionTargetURL.isNull()) {
-      QNetworkReply *reply2 =
-          manager->get(QNetworkRequest(redirectionTargetURL.toUrl()));
-      connect(reply2, SIGNAL(finished()), &loop, SLOT(quit()));
-      connect(reply2, SIGNAL(error(QNetworkReply::NetworkError)), &loop,
-              SLOT(quit()));
-      loop.exec();
-      reply->deleteLater();
-      this->readNoaaResponse(reply2, downloadedData);
-    } else
-      this->readNoaaResponse(reply, downloadedData);
-  }
+      if (reply->error() != QNetworkReply::NoError && !failed &&
+          attempts[i] <= this->m_maxRetries &&
+          (replyTimedOut || isTransientError(reply))) {
+        reply->deleteLater();
+        QTimer::singleShot(c_retryDelay * attempts[i], &loop, [&, i]() {
+          //...Another chunk failed while this one was waiting
+          if (failed) {
+            inFlight--;
+            launch();
+            return;
+          }
+          attempts[i]++;
+          send(i, this->requestUrl(startDateList[i], endDateList[i]));
+        });
+        return;
+      }
 
-  return 0;
+      if (replyTimedOut) {
+        this->setErrorString(QStringLiteral("ERROR: The request timed out"));
+        reply->deleteLater();
+        failed = true;
+      } else if (this->readNoaaResponse(reply, downloadedData[i]) != 0) {
+        failed = true;
+      }
+      inFlight--;
+      launch();
+    });
+  };
+
+  launch();
+  if (inFlight > 0) loop.exec();
+
+  return failed ? 1 : 0;
 }
 
 int NoaaCoOps::readNoaaResponse(QNetworkReply *reply,
-                                QVector<QString> &downloadedData) {
+                                QString &downloadedData) {
   // Catch some errors during the download
   if (reply->error() != 0) {
     this->setErrorString(QStringLiteral("ERROR: ") + reply->errorString());
@@ -151,8 +289,8 @@ int NoaaCoOps::readNoaaResponse(QNetworkReply *reply,
     return 1;
   }
 
-  // Store the data at the back of the vector
-  downloadedData.push_back((QString)reply->readAll());
+  // Store the data for this chunk
+  downloadedData = QString(reply->readAll());
 
   // Delete this response
   reply->deleteLater();
@@ -182,7 +320,7 @@ int NoaaCoOps::formatNoaaResponseCsv(QVector<QString> &downloadedData,
     error = QString(downloadedData[i]) + QStringLiteral("\n");
   }
 
-  HmdfStation *station = new HmdfStation(outputData);
+  HmdfStation *station = new HmdfStation(outputData->store());
   station->setCoordinate(this->station().coordinate());
   station->setName(this->station().name());
   station->setId(this->station().id());
@@ -191,6 +329,10 @@ int NoaaCoOps::formatNoaaResponseCsv(QVector<QString> &downloadedData,
   QDateTime tempDate = QDateTime();
   tempDate.setTimeSpec(Qt::UTC);
 
+  int nLines = 0;
+  for (int i = 0; i < data.size(); i++) nLines += data[i].size();
+  station->reserve(nLines);
+
   for (int i = 0; i < data.size(); i++) {
     if (data[i].size() > 3) {
       for (int j = 1; j < data[i].size(); j++) {
@@ -241,12 +383,16 @@ int NoaaCoOps::formatNoaaResponseCsv(QVector<QString> &downloadedData,
 
 int NoaaCoOps::formatNoaaResponseJson(QVector<QString> &downloadedData,
                                       Hmdf *outputData) {
-  HmdfStation *station = new HmdfStation(outputData);
+  HmdfStation *station = new HmdfStation(outputData->store());
   station->setCoordinate(this->station().coordinate());
   station->setName(this->station().name());
   station->setId(this->station().id());
   station->setStationIndex(0);
 
+  //...Chunks arrive in date order and neighbouring chunks share their
+  //   boundary time, so keep only times past the last one stored
+  qint64 lastTime = std::numeric_limits<qint64>::min();
+
   for (int i = 0; i < downloadedData.length(); i++) {
     QString data = downloadedData[i];
     QJsonDocument jsonData = QJsonDocument::fromJson(data.toUtf8());
@@ -264,22 +410,18 @@ int NoaaCoOps::formatNoaaResponseJson(QVector<QString> &downloadedData,
       this->setErrorString(val2.toString());
     }
 
-    //...Ditch duplicate data
-    int start;
-    if (i == 0)
-      start = 0;
-    else
-      start = 1;
+    station->reserve(station->numSnaps() + jsonArr.size());
 
-    for (int j = start; j < jsonArr.size(); j++) {
+    for (int j = 0; j < jsonArr.size(); j++) {
       QJsonObject obj = jsonArr[j].toObject();
       QDateTime t =
           QDateTime::fromString(obj["t"].toString(), "yyyy-MM-dd hh:mm");
       t.setTimeSpec(Qt::UTC);
       bool ok;
       double v = obj["v"].toString().toDouble(&ok);
-      if (t.isValid() && ok) {
-        station->setNext(t.toMSecsSinceEpoch(), v);
+      if (t.isValid() && ok && t.toMSecsSinceEpoch() > lastTime) {
+        lastTime = t.toMSecsSinceEpoch();
+        station->setNext(lastTime, v);
       }
     }
   }
@@ -288,6 +430,7 @@ int NoaaCoOps::formatNoaaResponseJson(QVector<QString> &downloadedData,
     outputData->addStation(station);
     return 0;
   } else {
+    delete station;
     return 1;
   }
 }
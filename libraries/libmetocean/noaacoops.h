@@ -32,6 +32,23 @@ class NoaaCoOps : public WaterData {
             QString product, QString datum, QString units,
             QObject *parent = nullptr);
 
+  //...Server to request data from. Defaults to the NOAA CO-OPS data API
+  QString baseUrl() const;
+  void setBaseUrl(const QString &baseUrl);
+
+  //...Number of 30 day chunks downloaded at the same time
+  int maxConcurrentDownloads() const;
+  void setMaxConcurrentDownloads(int maxConcurrentDownloads);
+
+  //...Number of times a chunk is retried after a transient failure
+  int maxRetries() const;
+  void setMaxRetries(int maxRetries);
+
+  //...Time a request may go without receiving data before it is aborted
+  //   and retried (milliseconds)
+  int requestTimeout() const;
+  void setRequestTimeout(int requestTimeout);
+
  private:
   int retrieveData(Hmdf *data);
 
@@ -44,7 +61,9 @@ class NoaaCoOps : public WaterData {
                                  QVector<QDateTime> endDateList,
                                  QVector<QString> &downloadedData);
 
-  int readNoaaResponse(QNetworkReply *reply, QVector<QString> &retrieveData);
+  QUrl requestUrl(const QDateTime &startDate, const QDateTime &endDate) const;
+
+  int readNoaaResponse(QNetworkReply *reply, QString &retrieveData);
 
   int formatNoaaResponse(QVector<QString> &downloadedData, Hmdf *outputData);
   int formatNoaaResponseCsv(QVector<QString> &downloadedData, Hmdf *outputData);
@@ -56,6 +75,10 @@ class NoaaCoOps : public WaterData {
   QString m_datum;
   QString m_units;
   bool m_useJson;
+  QString m_baseUrl;
+  int m_maxConcurrentDownloads;
+  int m_maxRetries;
+  int m_requestTimeout;
 };
 
 #endif  // NOAACOOPS_H
@@ -0,0 +1,161 @@
+/*-------------------------------GPL-------------------------------------//
+//
+// MetOcean Viewer - A simple interface for viewing hydrodynamic model data
+// Copyright (C) 2018  Zach Cobell
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------*/
+#include "stationcatalog.h"
+#include <QtEndian>
+#include <cstring>
+
+static void appendU32(QByteArray &out, quint32 value) {
+  uchar buffer[4];
+  qToLittleEndian<quint32>(value, buffer);
+  out.append(reinterpret_cast<const char *>(buffer), 4);
+}
+
+static void appendI32(QByteArray &out, qint32 value) {
+  appendU32(out, static_cast<quint32>(value));
+}
+
+static void appendDouble(QByteArray &out, double value) {
+  quint64 bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  uchar buffer[8];
+  qToLittleEndian<quint64>(bits, buffer);
+  out.append(reinterpret_cast<const char *>(buffer), 8);
+}
+
+static quint32 readU32(const unsigned char *p) {
+  return qFromLittleEndian<quint32>(p);
+}
+
+static double readDouble(const unsigned char *p) {
+  quint64 bits = qFromLittleEndian<quint64>(p);
+  double value;
+  std::memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+
+static QDateTime readDate(const unsigned char *p, bool valid, bool utc) {
+  if (!valid) return QDateTime();
+  return QDateTime(
+      QDate::fromJulianDay(static_cast<qint32>(readU32(p))),
+      QTime::fromMSecsSinceStartOfDay(static_cast<qint32>(readU32(p + 4))),
+      utc ? Qt::UTC : Qt::LocalTime);
+}
+
+QByteArray StationCatalog::write(const QVector<QVector<Station>> &tables) {
+  QByteArray header, records, strings;
+
+  appendU32(header, c_magic);
+  appendU32(header, c_version);
+  appendU32(header, c_numTables);
+  appendU32(header, c_recordSize);
+
+  quint32 nRecords = 0;
+  for (int t = 0; t < c_numTables; t++) {
+    quint32 count = t < tables.size() ? tables[t].size() : 0;
+    appendU32(header, nRecords);
+    appendU32(header, count);
+    nRecords += count;
+  }
+
+  for (int t = 0; t < tables.size() && t < c_numTables; t++) {
+    for (const Station &s : tables[t]) {
+      QDateTime start = s.startValidDate();
+      QDateTime end = s.endValidDate();
+
+      appendDouble(records, s.coordinate().latitude());
+      appendDouble(records, s.coordinate().longitude());
+      appendI32(records, start.isValid() ? start.date().toJulianDay() : 0);
+      appendI32(records,
+                start.isValid() ? start.time().msecsSinceStartOfDay() : 0);
+      appendI32(records, end.isValid() ? end.date().toJulianDay() : 0);
+      appendI32(records, end.isValid() ? end.time().msecsSinceStartOfDay() : 0);
+
+      appendU32(records, strings.size());
+      strings.append(s.id().toUtf8());
+      strings.append('\0');
+      appendU32(records, strings.size());
+      strings.append(s.name().toUtf8());
+      strings.append('\0');
+
+      quint8 flags = 0;
+      if (s.active()) flags |= Active;
+      if (start.isValid()) flags |= StartValid;
+      if (start.timeSpec() == Qt::UTC) flags |= StartUtc;
+      if (end.isValid()) flags |= EndValid;
+      if (end.timeSpec() == Qt::UTC) flags |= EndUtc;
+      records.append(static_cast<char>(flags));
+      records.append(c_recordSize - 41, '\0');
+    }
+  }
+
+  appendU32(header, c_headerSize + records.size());
+  appendU32(header, strings.size());
+
+  return header + records + strings;
+}
+
+bool StationCatalog::read(const unsigned char *data, size_t size, int table,
+                          QVector<Station> &stations) {
+  stations.clear();
+
+  if (data == nullptr || size < static_cast<size_t>(c_headerSize))
+    return false;
+  if (readU32(data) != c_magic || readU32(data + 4) != c_version ||
+      readU32(data + 8) != static_cast<quint32>(c_numTables) ||
+      readU32(data + 12) != static_cast<quint32>(c_recordSize))
+    return false;
+  if (table < 0 || table >= c_numTables) return false;
+
+  quint32 first = readU32(data + 16 + 8 * table);
+  quint32 count = readU32(data + 20 + 8 * table);
+  quint32 stringOffset = readU32(data + 16 + 8 * c_numTables);
+  quint32 stringSize = readU32(data + 20 + 8 * c_numTables);
+
+  if (static_cast<size_t>(stringOffset) + stringSize > size) return false;
+  if (c_headerSize + (static_cast<size_t>(first) + count) * c_recordSize >
+      stringOffset)
+    return false;
+
+  const char *stringTable = reinterpret_cast<const char *>(data) + stringOffset;
+  if (count > 0 && (stringSize == 0 || stringTable[stringSize - 1] != '\0'))
+    return false;
+
+  stations.reserve(count);
+  for (quint32 i = 0; i < count; i++) {
+    const unsigned char *r = data + c_headerSize + (first + i) * c_recordSize;
+    quint32 id = readU32(r + 32);
+    quint32 name = readU32(r + 36);
+    if (id >= stringSize || name >= stringSize) {
+      stations.clear();
+      return false;
+    }
+    quint8 flags = r[40];
+
+    stations.push_back(
+        Station(QGeoCoordinate(readDouble(r), readDouble(r + 8)),
+                QString::fromUtf8(stringTable + id),
+                QString::fromUtf8(stringTable + name), 0, 0, 0,
+                flags & Active,
+                readDate(r + 16, flags & StartValid, flags & StartUtc),
+                readDate(r + 24, flags & EndValid, flags & EndUtc)));
+  }
+
+  return true;
+}
@@ -0,0 +1,64 @@
+/*-------------------------------GPL-------------------------------------//
+//
+// MetOcean Viewer - A simple interface for viewing hydrodynamic model data
+// Copyright (C) 2018  Zach Cobell
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------*/
+#ifndef STATIONCATALOG_H
+#define STATIONCATALOG_H
+
+#include <QByteArray>
+#include <QVector>
+#include "station.h"
+
+//...Compact binary form of the station CSV files. The catalog is built
+//   once at compile time (see libraries/mkstationcatalog) and read in place
+//   from the library image, so no text parsing happens at run time.
+//
+//   Layout, all values little endian:
+//     header   magic, version, table count, record size
+//     tables   first record and record count for each table
+//     strings  offset and size of the string table
+//     records  fixed width, one per station
+//     string table of NUL terminated UTF-8 ids and names
+//
+//   Dates are stored as a Julian day and milliseconds into the day along
+//   with their time spec so they round trip exactly
+class StationCatalog {
+ public:
+  static const quint32 c_magic = 0x4e54534d;
+  static const quint32 c_version = 1;
+  static const int c_numTables = 4;
+
+  static QByteArray write(const QVector<QVector<Station>> &tables);
+
+  static bool read(const unsigned char *data, size_t size, int table,
+                   QVector<Station> &stations);
+
+ private:
+  enum RecordFlags {
+    Active = 0x01,
+    StartValid = 0x02,
+    StartUtc = 0x04,
+    EndValid = 0x08,
+    EndUtc = 0x10
+  };
+
+  static const int c_headerSize = 16 + 8 * c_numTables + 8;
+  static const int c_recordSize = 48;
+};
+
+#endif  // STATIONCATALOG_H
@@ -0,0 +1,37 @@
+/*-------------------------------GPL-------------------------------------//
+//
+// MetOcean Viewer - A simple interface for viewing hydrodynamic model data
+// Copyright (C) 2018  Zach Cobell
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------*/
+#ifndef STATIONCSV_H
+#define STATIONCSV_H
+
+#include <QString>
+#include <QVector>
+#include "station.h"
+
+//...Readers for the station catalog CSV files in data/. These are the
+//   source of truth for the binary catalog generated at build time
+class StationCsv {
+ public:
+  static QVector<Station> readNoaa(const QString &filename);
+  static QVector<Station> readUsgs(const QString &filename);
+  static QVector<Station> readXtide(const QString &filename);
+  static QVector<Station> readNdbc(const QString &filename);
+};
+
+#endif  // STATIONCSV_H
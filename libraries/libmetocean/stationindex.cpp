@@ -0,0 +1,241 @@
+/*-------------------------------GPL-------------------------------------//
+//
+// MetOcean Viewer - A simple interface for viewing hydrodynamic model data
+// Copyright (C) 2018  Zach Cobell
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------*/
+#include "stationindex.h"
+#include <algorithm>
+#include <cmath>
+#include "constants.h"
+
+static void toCartesian(double longitude, double latitude, double p[3]) {
+  double lon = Constants::toRadians(longitude);
+  double lat = Constants::toRadians(latitude);
+  p[0] = std::cos(lat) * std::cos(lon);
+  p[1] = std::cos(lat) * std::sin(lon);
+  p[2] = std::sin(lat);
+}
+
+//...Wrap a longitude difference into [0, 360)
+static double wrap360(double x) {
+  x = std::fmod(x, 360.0);
+  if (x < 0.0) x += 360.0;
+  return x >= 360.0 ? 0.0 : x;
+}
+
+static double distance2(const double a[3], const double b[3]) {
+  double dx = a[0] - b[0];
+  double dy = a[1] - b[1];
+  double dz = a[2] - b[2];
+  return dx * dx + dy * dy + dz * dz;
+}
+
+StationIndex::StationIndex() {}
+
+StationIndex::StationIndex(const QVector<Station> &stations) {
+  this->build(stations);
+}
+
+void StationIndex::build(const QVector<Station> &stations) {
+  this->m_nodes.resize(stations.size());
+  for (int i = 0; i < stations.size(); i++) {
+    Node &n = this->m_nodes[i];
+    n.longitude = stations[i].coordinate().longitude();
+    n.latitude = stations[i].coordinate().latitude();
+    n.index = i;
+    toCartesian(n.longitude, n.latitude, n.p);
+  }
+  this->buildNode(0, this->m_nodes.size(), 0);
+  return;
+}
+
+int StationIndex::size() const { return this->m_nodes.size(); }
+
+void StationIndex::buildNode(int begin, int end, int depth) {
+  if (end - begin < 2) return;
+  int mid = begin + (end - begin) / 2;
+  int axis = depth % 3;
+  std::nth_element(this->m_nodes.begin() + begin, this->m_nodes.begin() + mid,
+                   this->m_nodes.begin() + end,
+                   [axis](const Node &a, const Node &b) {
+                     return a.p[axis] < b.p[axis];
+                   });
+  this->buildNode(begin, mid, depth + 1);
+  this->buildNode(mid + 1, end, depth + 1);
+  return;
+}
+
+QVector<int> StationIndex::box(double west, double south, double east,
+                               double north) const {
+  QVector<int> result;
+  if (this->m_nodes.isEmpty()) return result;
+
+  Box b;
+  b.west = west;
+  b.span = wrap360(east - west);
+  b.allLongitudes = east - west >= 360.0;
+  b.south = std::max(std::min(south, north), -90.0);
+  b.north = std::min(std::max(south, north), 90.0);
+
+  //...Cartesian bounds of the lon/lat box, used to prune the tree. The
+  //   extremes of cos/sin over the longitude range are at the ends or at
+  //   any multiple of 90 degrees inside it
+  double cmin = std::cos(Constants::toRadians(
+      std::max(std::abs(b.south), std::abs(b.north))));
+  double cmax = b.south <= 0.0 && b.north >= 0.0
+                    ? 1.0
+                    : std::cos(Constants::toRadians(std::min(
+                          std::abs(b.south), std::abs(b.north))));
+  double cosLo = -1.0, cosHi = 1.0, sinLo = -1.0, sinHi = 1.0;
+  if (!b.allLongitudes) {
+    double w = Constants::toRadians(west);
+    double e = Constants::toRadians(west + b.span);
+    cosLo = std::min(std::cos(w), std::cos(e));
+    cosHi = std::max(std::cos(w), std::cos(e));
+    sinLo = std::min(std::sin(w), std::sin(e));
+    sinHi = std::max(std::sin(w), std::sin(e));
+    for (double a = std::ceil(west / 90.0) * 90.0; a < west + b.span;
+         a += 90.0) {
+      double r = Constants::toRadians(a);
+      cosLo = std::min(cosLo, std::cos(r));
+      cosHi = std::max(cosHi, std::cos(r));
+      sinLo = std::min(sinLo, std::sin(r));
+      sinHi = std::max(sinHi, std::sin(r));
+    }
+  }
+  const double eps = 1e-9;
+  b.lo[0] = (cosLo < 0.0 ? cmax * cosLo : cmin * cosLo) - eps;
+  b.hi[0] = (cosHi > 0.0 ? cmax * cosHi : cmin * cosHi) + eps;
+  b.lo[1] = (sinLo < 0.0 ? cmax * sinLo : cmin * sinLo) - eps;
+  b.hi[1] = (sinHi > 0.0 ? cmax * sinHi : cmin * sinHi) + eps;
+  b.lo[2] = std::sin(Constants::toRadians(b.south)) - eps;
+  b.hi[2] = std::sin(Constants::toRadians(b.north)) + eps;
+
+  this->boxNode(0, this->m_nodes.size(), 0, b, result);
+  std::sort(result.begin(), result.end());
+  return result;
+}
+
+void StationIndex::boxNode(int begin, int end, int depth, const Box &b,
+                           QVector<int> &result) const {
+  if (begin >= end) return;
+  int mid = begin + (end - begin) / 2;
+  int axis = depth % 3;
+  const Node &n = this->m_nodes[mid];
+
+  if (n.latitude >= b.south && n.latitude <= b.north &&
+      (b.allLongitudes || wrap360(n.longitude - b.west) <= b.span))
+    result.push_back(n.index);
+
+  if (b.lo[axis] <= n.p[axis]) this->boxNode(begin, mid, depth + 1, b, result);
+  if (b.hi[axis] >= n.p[axis])
+    this->boxNode(mid + 1, end, depth + 1, b, result);
+  return;
+}
+
+QVector<int> StationIndex::radius(double longitude, double latitude,
+                                  double distance) const {
+  QVector<int> result;
+  if (this->m_nodes.isEmpty() || distance < 0.0) return result;
+
+  //...Search by chord length on the unit sphere using the smallest earth
+  //   radius so no candidate is missed, then check each candidate with
+  //   the same distance used elsewhere in the library
+  double angle = distance / Constants::polarRadius();
+  double chord2 =
+      angle >= Constants::pi() ? 4.0 : std::pow(2.0 * std::sin(angle / 2.0), 2);
+
+  double q[3];
+  toCartesian(longitude, latitude, q);
+  this->radiusNode(0, this->m_nodes.size(), 0, q, longitude, latitude, chord2,
+                   distance, result);
+  std::sort(result.begin(), result.end());
+  return result;
+}
+
+void StationIndex::radiusNode(int begin, int end, int depth, const double q[3],
+                              double longitude, double latitude, double chord2,
+                              double distance, QVector<int> &result) const {
+  if (begin >= end) return;
+  int mid = begin + (end - begin) / 2;
+  int axis = depth % 3;
+  const Node &n = this->m_nodes[mid];
+
+  if (distance2(q, n.p) <= chord2 &&
+      Constants::distance(longitude, latitude, n.longitude, n.latitude,
+                          true) <= distance)
+    result.push_back(n.index);
+
+  double diff = q[axis] - n.p[axis];
+  if (diff <= 0.0 || diff * diff <= chord2)
+    this->radiusNode(begin, mid, depth + 1, q, longitude, latitude, chord2,
+                     distance, result);
+  if (diff >= 0.0 || diff * diff <= chord2)
+    this->radiusNode(mid + 1, end, depth + 1, q, longitude, latitude, chord2,
+                     distance, result);
+  return;
+}
+
+QVector<int> StationIndex::nearest(double longitude, double latitude,
+                                   int k) const {
+  QVector<int> result;
+  if (this->m_nodes.isEmpty() || k < 1) return result;
+
+  double q[3];
+  toCartesian(longitude, latitude, q);
+
+  std::vector<std::pair<double, int>> heap;
+  heap.reserve(k + 1);
+  this->nearestNode(0, this->m_nodes.size(), 0, q, static_cast<size_t>(k),
+                    heap);
+
+  std::sort_heap(heap.begin(), heap.end());
+  result.reserve(heap.size());
+  for (const auto &h : heap) result.push_back(h.second);
+  return result;
+}
+
+void StationIndex::nearestNode(
+    int begin, int end, int depth, const double q[3], size_t k,
+    std::vector<std::pair<double, int>> &heap) const {
+  if (begin >= end) return;
+  int mid = begin + (end - begin) / 2;
+  int axis = depth % 3;
+  const Node &n = this->m_nodes[mid];
+
+  //...Max heap on distance, ties broken toward the lower station index
+  std::pair<double, int> candidate(distance2(q, n.p), n.index);
+  if (heap.size() < k) {
+    heap.push_back(candidate);
+    std::push_heap(heap.begin(), heap.end());
+  } else if (candidate < heap.front()) {
+    std::pop_heap(heap.begin(), heap.end());
+    heap.back() = candidate;
+    std::push_heap(heap.begin(), heap.end());
+  }
+
+  double diff = q[axis] - n.p[axis];
+  int nearBegin = diff <= 0.0 ? begin : mid + 1;
+  int nearEnd = diff <= 0.0 ? mid : end;
+  int farBegin = diff <= 0.0 ? mid + 1 : begin;
+  int farEnd = diff <= 0.0 ? end : mid;
+
+  this->nearestNode(nearBegin, nearEnd, depth + 1, q, k, heap);
+  if (heap.size() < k || diff * diff <= heap.front().first)
+    this->nearestNode(farBegin, farEnd, depth + 1, q, k, heap);
+  return;
+}
@@ -0,0 +1,81 @@
+/*-------------------------------GPL-------------------------------------//
+//
+// MetOcean Viewer - A simple interface for viewing hydrodynamic model data
+// Copyright (C) 2018  Zach Cobell
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------*/
+#ifndef STATIONINDEX_H
+#define STATIONINDEX_H
+
+#include <QVector>
+#include <utility>
+#include <vector>
+#include "station.h"
+
+//...Static k-d tree over a list of stations. Stations are placed on the
+//   unit sphere so nearest and radius searches are exact great circle
+//   searches and nothing special happens at the antimeridian or poles.
+//   All queries return indices into the vector the index was built from.
+class StationIndex {
+ public:
+  StationIndex();
+  explicit StationIndex(const QVector<Station> &stations);
+
+  void build(const QVector<Station> &stations);
+
+  int size() const;
+
+  //...Stations inside the box running east from west to east. A box
+  //   with west > east crosses the antimeridian. Longitudes may be given
+  //   as -180 to 180 or 0 to 360
+  QVector<int> box(double west, double south, double east,
+                   double north) const;
+
+  //...Stations within distance (meters) of the point
+  QVector<int> radius(double longitude, double latitude,
+                      double distance) const;
+
+  //...The k stations closest to the point, nearest first
+  QVector<int> nearest(double longitude, double latitude, int k = 1) const;
+
+ private:
+  struct Node {
+    double p[3];
+    double longitude;
+    double latitude;
+    int index;
+  };
+
+  struct Box {
+    double west, span, south, north;
+    bool allLongitudes;
+    double lo[3], hi[3];
+  };
+
+  QVector<Node> m_nodes;
+
+  void buildNode(int begin, int end, int depth);
+  void boxNode(int begin, int end, int depth, const Box &b,
+               QVector<int> &result) const;
+  void radiusNode(int begin, int end, int depth, const double q[3],
+                  double longitude, double latitude, double chord2,
+                  double distance, QVector<int> &result) const;
+  void nearestNode(int begin, int end, int depth, const double q[3],
+                   size_t k,
+                   std::vector<std::pair<double, int>> &heap) const;
+};
+
+#endif  // STATIONINDEX_H
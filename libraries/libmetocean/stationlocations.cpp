@@ -18,160 +18,80 @@
 //
 //-----------------------------------------------------------------------*/
 #include "stationlocations.h"
-#include <QFile>
+#include <QHash>
+#include <QMutex>
+#include "stationcatalog.h"
+#include "stationcsv.h"
 
 StationLocations::StationLocations(QObject *parent) : QObject(parent) {}
 
-QVector<Station> StationLocations::readMarkers(
-    StationLocations::MarkerType markerType) {
-  if (markerType == NOAA) {
-    return StationLocations::readNoaaMarkers();
-  } else if (markerType == USGS) {
-    return StationLocations::readUsgsMarkers();
-  } else if (markerType == XTIDE) {
-    return StationLocations::readXtideMarkers();
-  } else if (markerType == NDBC) {
-    return StationLocations::readNdbcMarkers();
-  } else {
-    QVector<Station> output;
-    return output;
-  }
-}
-
-QVector<Station> StationLocations::readNoaaMarkers() {
-  QVector<Station> output;
-
-  QFile stationFile(":/stations/data/noaa_stations.csv");
+//...Generated at build time from data/*.csv by mkstationcatalog
+extern const unsigned char metocean_station_catalog[];
+extern const size_t metocean_station_catalog_size;
 
-  if (!stationFile.open(QIODevice::ReadOnly)) return output;
+//...Process wide cache. QVector is implicitly shared so handing out
+//   copies of the cached vectors does not copy the stations
+struct StationCache {
+  QVector<Station> stations;
+  QHash<QString, int> index;
+  StationIndex spatialIndex;
+};
 
-  while (!stationFile.atEnd()) {
-    QString line = stationFile.readLine().simplified();
-    QStringList list = line.split(";");
-    QString id = list.value(0);
-    QString name = list.value(1);
-    name = name.simplified();
-    QString temp = list.value(3);
-    double lat = temp.toDouble();
-    temp = list.value(2);
-    double lon = temp.toDouble();
+static QMutex s_stationCacheMutex;
+static QHash<int, StationCache> s_stationCache;
 
-    QString startDateString = list.value(4).simplified();
-    QString endDateString = list.value(5).simplified();
-    QDateTime startDate =
-        QDateTime::fromString(startDateString, "MMM dd, yyyy");
-    startDate.setTimeSpec(Qt::UTC);
-    QDateTime endDate;
-    if (endDateString == "present")
-      endDate = QDateTime(QDate(2050, 1, 1), QTime(0, 0, 0));
-    else
-      endDate = QDateTime::fromString(endDateString, "MMM dd, yyyy");
-    endDate.setTimeSpec(Qt::UTC);
-
-    if (startDate.isValid() || endDate.isValid()) {
-      if (endDateString == "present") {
-        Station s = Station(QGeoCoordinate(lat, lon), id, name, 0, 0, 0, true,
-                            startDate, endDate);
-        output.push_back(s);
-      } else {
-        Station s = Station(QGeoCoordinate(lat, lon), id, name, 0, 0, 0, false,
-                            startDate, endDate);
-        output.push_back(s);
-      }
+QVector<Station> StationLocations::readMarkers(
+    StationLocations::MarkerType markerType) {
+  QMutexLocker locker(&s_stationCacheMutex);
+  if (!s_stationCache.contains(markerType)) {
+    StationCache &cache = s_stationCache[markerType];
+    cache.stations = StationLocations::loadMarkers(markerType);
+    cache.index.reserve(cache.stations.size());
+    for (int i = 0; i < cache.stations.size(); i++) {
+      QString id = cache.stations[i].id().simplified();
+      if (!cache.index.contains(id)) cache.index.insert(id, i);
     }
+    cache.spatialIndex.build(cache.stations);
   }
-
-  stationFile.close();
-
-  return output;
+  return s_stationCache[markerType].stations;
 }
 
-QVector<Station> StationLocations::readUsgsMarkers() {
-  QVector<Station> output;
-
-  QFile stationFile(":/stations/data/usgs_stations.csv");
-
-  if (!stationFile.open(QIODevice::ReadOnly)) return output;
-
-  int index = 0;
-
-  while (!stationFile.atEnd()) {
-    QString line = stationFile.readLine().simplified();
-    index++;
-    if (index > 1) {
-      QStringList list = line.split(";");
-      QString id = list.value(0);
-      QString name = list.value(1);
-      name = name.simplified();
-      QString temp = list.value(2);
-      double lat = temp.toDouble();
-      temp = list.value(3);
-      double lon = temp.toDouble();
-      Station s = Station(QGeoCoordinate(lat, lon), id, name);
-      output.push_back(s);
-    }
-  }
-
-  stationFile.close();
-
-  return output;
+bool StationLocations::findStation(StationLocations::MarkerType markerType,
+                                   const QString &id, Station &station) {
+  StationLocations::readMarkers(markerType);
+  QMutexLocker locker(&s_stationCacheMutex);
+  const StationCache &cache = s_stationCache[markerType];
+  int i = cache.index.value(id.simplified(), -1);
+  if (i < 0) return false;
+  station = cache.stations[i];
+  return true;
 }
 
-QVector<Station> StationLocations::readXtideMarkers() {
-  QVector<Station> output;
-  QFile stationFile(":/stations/data/xtide_stations.csv");
-
-  if (!stationFile.open(QIODevice::ReadOnly)) return output;
-
-  int index = 0;
-
-  while (!stationFile.atEnd()) {
-    QString line = stationFile.readLine().simplified();
-    index++;
-    if (index > 1) {
-      QStringList list = line.split(";");
-      QString id = list.value(3);
-      QString name = list.value(4);
-      name = name.simplified();
-      QString temp = list.value(0);
-      double lat = temp.toDouble();
-      temp = list.value(1);
-      double lon = temp.toDouble();
-      Station s = Station(QGeoCoordinate(lat, lon), id, name);
-      output.push_back(s);
-    }
-  }
-
-  stationFile.close();
-
-  return output;
+StationIndex StationLocations::markerIndex(
+    StationLocations::MarkerType markerType) {
+  StationLocations::readMarkers(markerType);
+  QMutexLocker locker(&s_stationCacheMutex);
+  return s_stationCache[markerType].spatialIndex;
 }
 
-QVector<Station> StationLocations::readNdbcMarkers() {
+QVector<Station> StationLocations::loadMarkers(
+    StationLocations::MarkerType markerType) {
   QVector<Station> output;
-  QFile stationFile(":/stations/data/ndbc_stations.csv");
-
-  if (!stationFile.open(QIODevice::ReadOnly)) return output;
-
-  int index = 0;
+  if (StationCatalog::read(metocean_station_catalog,
+                           metocean_station_catalog_size, markerType, output))
+    return output;
 
-  while (!stationFile.atEnd()) {
-    QString line = stationFile.readLine().simplified();
-    index++;
-    if (index > 1) {
-      QStringList list = line.split(",");
-      QString id = list.value(0).simplified();
-      QString name = "NDBC_" + id;
-      QString temp = list.value(1);
-      double lon = temp.toDouble();
-      temp = list.value(2);
-      double lat = temp.toDouble();
-      Station s = Station(QGeoCoordinate(lat, lon), id, name);
-      output.push_back(s);
-    }
+  //...The catalog should always be present, but fall back to the CSV
+  //   copies in the resources rather than showing no stations
+  if (markerType == NOAA) {
+    return StationCsv::readNoaa(":/stations/data/noaa_stations.csv");
+  } else if (markerType == USGS) {
+    return StationCsv::readUsgs(":/stations/data/usgs_stations.csv");
+  } else if (markerType == XTIDE) {
+    return StationCsv::readXtide(":/stations/data/xtide_stations.csv");
+  } else if (markerType == NDBC) {
+    return StationCsv::readNdbc(":/stations/data/ndbc_stations.csv");
+  } else {
+    return output;
   }
-
-  stationFile.close();
-
-  return output;
 }
@@ -24,6 +24,7 @@
 #include <QVector>
 #include "metocean_global.h"
 #include "station.h"
+#include "stationindex.h"
 
 class StationLocations : public QObject {
   Q_OBJECT
@@ -34,11 +35,13 @@ class StationLocations : public QObject {
 
   static QVector<Station> readMarkers(MarkerType markerType);
 
+  static bool findStation(MarkerType markerType, const QString &id,
+                          Station &station);
+
+  static StationIndex markerIndex(MarkerType markerType);
+
  private:
-  static QVector<Station> readNoaaMarkers();
-  static QVector<Station> readUsgsMarkers();
-  static QVector<Station> readXtideMarkers();
-  static QVector<Station> readNdbcMarkers();
+  static QVector<Station> loadMarkers(MarkerType markerType);
 };
 
 #endif  // STATIONLOCATIONS_H
@@ -53,7 +53,7 @@ void TidePrediction::deleteHarmonicsOnExit(bool b) {
 
 int TidePrediction::get(Station &s, QDateTime startDate, QDateTime endDate,
                         int interval, Hmdf *data) {
-  HmdfStation *st = new HmdfStation(data);
+  HmdfStation *st = new HmdfStation(data->store());
 
   st->setName(s.name());
   st->setId(s.id());
@@ -87,6 +87,7 @@ int TidePrediction::get(Station &s, QDateTime startDate, QDateTime endDate,
                    libxtide::Format::text);
 
     QStringList tide = QString(text_out.aschar()).split("\n");
+    st->reserve(tide.length());
 
     for (int i = 0; i < tide.length(); i++) {
       QString datestr = tide[i].mid(0, 20).simplified();
@@ -103,6 +104,7 @@ int TidePrediction::get(Station &s, QDateTime startDate, QDateTime endDate,
 
     return 0;
   } else {
+    delete st;
     return 1;
   }
 }
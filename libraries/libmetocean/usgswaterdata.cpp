@@ -198,13 +198,16 @@ int UsgsWaterdata::readUsgsData(QByteArray &data, Hmdf *output) {
   QVector<HmdfStation *> stations;
   stations.resize(params.length());
   for (int i = 0; i < stations.length(); i++) {
-    stations[i] = new HmdfStation(output);
+    stations[i] = new HmdfStation();
     stations[i]->setName(params[i].description);
   }
 
   //...Sanity check
   if (stations.length() == 0) return 1;
 
+  for (int i = 0; i < stations.length(); i++)
+    stations[i]->reserve(SplitByLine.length() - HeaderEnd);
+
   //...Read the data into the array
   for (int i = HeaderEnd; i < SplitByLine.length(); i++) {
     tempLine = SplitByLine.value(i);
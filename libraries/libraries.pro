@@ -23,6 +23,7 @@ TEMPLATE = subdirs
 SUBDIRS  = libproj4 \
            libnetcdfcxx \
            libtide \
+           mkstationcatalog \
            libmetocean
 
 CONFIG += ordered
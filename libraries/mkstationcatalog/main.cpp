@@ -0,0 +1,104 @@
+/*-------------------------------GPL-------------------------------------//
+//
+// MetOcean Viewer - A simple interface for viewing hydrodynamic model data
+// Copyright (C) 2018  Zach Cobell
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------*/
+//...Build time tool that turns the station CSV files into the binary
+//   station catalog and writes it out as a C++ source file that is
+//   compiled into libmetocean
+//
+//   Usage: mkstationcatalog output.cpp station.csv [station.csv ...]
+//
+//   The table for each CSV is chosen from its file name
+#include <QCoreApplication>
+#include <QFile>
+#include <QFileInfo>
+#include <QTextStream>
+#include "stationcatalog.h"
+#include "stationcsv.h"
+#include "stationlocations.h"
+
+static int tableFromFilename(const QString &filename) {
+  QString base = QFileInfo(filename).fileName();
+  if (base == "noaa_stations.csv") return StationLocations::NOAA;
+  if (base == "usgs_stations.csv") return StationLocations::USGS;
+  if (base == "xtide_stations.csv") return StationLocations::XTIDE;
+  if (base == "ndbc_stations.csv") return StationLocations::NDBC;
+  return -1;
+}
+
+static bool writeSource(const QString &filename, const QByteArray &catalog) {
+  QFile output(filename);
+  if (!output.open(QIODevice::WriteOnly | QIODevice::Truncate)) return false;
+
+  QTextStream out(&output);
+  out << "//...Generated by mkstationcatalog. Do not edit.\n";
+  out << "#include <cstddef>\n\n";
+  out << "extern const unsigned char metocean_station_catalog[] = {\n";
+  for (int i = 0; i < catalog.size(); i++) {
+    if (i % 16 == 0) out << "   ";
+    out << " " << static_cast<unsigned int>(static_cast<uchar>(catalog[i]))
+        << ",";
+    if (i % 16 == 15 || i == catalog.size() - 1) out << "\n";
+  }
+  out << "};\n\n";
+  out << "extern const size_t metocean_station_catalog_size = "
+      << catalog.size() << ";\n";
+
+  output.close();
+  return output.error() == QFile::NoError;
+}
+
+int main(int argc, char *argv[]) {
+  QCoreApplication a(argc, argv);
+  QStringList args = a.arguments();
+  QTextStream err(stderr);
+
+  if (args.size() < 3) {
+    err << "Usage: mkstationcatalog output.cpp station.csv [station.csv ...]\n";
+    return 1;
+  }
+
+  QVector<QVector<Station>> tables(StationCatalog::c_numTables);
+
+  for (int i = 2; i < args.size(); i++) {
+    int table = tableFromFilename(args[i]);
+    if (table < 0) {
+      err << "Unknown station file: " << args[i] << "\n";
+      return 1;
+    }
+    if (!QFile::exists(args[i])) {
+      err << "Station file not found: " << args[i] << "\n";
+      return 1;
+    }
+    if (table == StationLocations::NOAA)
+      tables[table] = StationCsv::readNoaa(args[i]);
+    else if (table == StationLocations::USGS)
+      tables[table] = StationCsv::readUsgs(args[i]);
+    else if (table == StationLocations::XTIDE)
+      tables[table] = StationCsv::readXtide(args[i]);
+    else if (table == StationLocations::NDBC)
+      tables[table] = StationCsv::readNdbc(args[i]);
+  }
+
+  if (!writeSource(args[1], StationCatalog::write(tables))) {
+    err << "Could not write " << args[1] << "\n";
+    return 1;
+  }
+
+  return 0;
+}
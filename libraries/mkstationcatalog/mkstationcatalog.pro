@@ -0,0 +1,44 @@
+#-------------------------------GPL-------------------------------------#
+#
+# MetOcean Viewer - A simple interface for viewing hydrodynamic model data
+# Copyright (C) 2015-2017  Zach Cobell
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+#-----------------------------------------------------------------------#
+
+
+QT += positioning
+QT -= gui
+
+TARGET = mkstationcatalog
+TEMPLATE = app
+CONFIG += c++11 console
+CONFIG -= app_bundle
+
+#...Host tool used while building libmetocean to generate the binary
+#   station catalog. It compiles the catalog sources directly so that it
+#   does not depend on the library it is generating data for.
+DEFINES += QT_DEPRECATED_WARNINGS
+
+INCLUDEPATH += $$PWD/../libmetocean
+
+SOURCES += main.cpp \
+           $$PWD/../libmetocean/station.cpp \
+           $$PWD/../libmetocean/stationcatalog.cpp \
+           $$PWD/../libmetocean/stationcsv.cpp
+
+HEADERS += $$PWD/../libmetocean/station.h \
+           $$PWD/../libmetocean/stationcatalog.h \
+           $$PWD/../libmetocean/stationcsv.h
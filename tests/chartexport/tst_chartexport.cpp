@@ -0,0 +1,113 @@
+/*-------------------------------GPL-------------------------------------//
+//
+// MetOcean Viewer - A simple interface for viewing hydrodynamic model data
+// Copyright (C) 2018  Zach Cobell
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------*/
+#include <QApplication>
+#include <QImage>
+#include <QPainter>
+#include <QScatterSeries>
+#include <QtTest>
+#include "chartview.h"
+
+//...Exports a chart the way the save image action does and checks that
+//   the series made it into the image. Run headless on the offscreen
+//   platform with Mesa's llvmpipe rasterizer so that the OpenGL series
+//   path is exercised without a display or a GPU
+class TestChartExport : public QObject {
+  Q_OBJECT
+
+ private slots:
+  void exportIncludesSeries_data();
+  void exportIncludesSeries();
+};
+
+static int countSeriesPixels(const QImage &image) {
+  int n = 0;
+  for (int y = 0; y < image.height(); y++) {
+    for (int x = 0; x < image.width(); x++) {
+      QColor c = image.pixelColor(x, y);
+      if (c.red() > 200 && c.green() < 80 && c.blue() < 80) n++;
+    }
+  }
+  return n;
+}
+
+void TestChartExport::exportIncludesSeries_data() {
+  QTest::addColumn<bool>("useOpenGL");
+  QTest::addColumn<bool>("scatter");
+
+  QTest::newRow("raster line") << false << false;
+  QTest::newRow("opengl line") << true << false;
+  QTest::newRow("opengl scatter") << true << true;
+}
+
+void TestChartExport::exportIncludesSeries() {
+  QFETCH(bool, useOpenGL);
+  QFETCH(bool, scatter);
+
+  ChartView view;
+  view.resize(800, 600);
+  view.initializeAxis(2);
+  view.setAxisLimits(0.0, 100.0, 0.0, 100.0);
+
+  QVector<QPointF> points;
+  for (int i = 0; i <= 100; i++) points.push_back(QPointF(i, i));
+
+  if (scatter) {
+    //...Added straight to the chart like the high water mark plots
+    QScatterSeries *series = new QScatterSeries(view.chart());
+    series->setColor(Qt::red);
+    series->setBorderColor(Qt::red);
+    series->setMarkerSize(8.0);
+    series->replace(points);
+    view.chart()->addSeries(series);
+    series->attachAxis(view.xAxis());
+    series->attachAxis(view.yAxis());
+  } else {
+    QLineSeries *series = new QLineSeries(view.chart());
+    series->setPen(QPen(Qt::red, 6));
+    view.addSeries(series, points, "series");
+  }
+  view.setUseOpenGL(useOpenGL);
+
+  view.show();
+  QVERIFY(QTest::qWaitForWindowExposed(&view));
+
+  QImage image(view.size(), QImage::Format_ARGB32);
+  image.fill(Qt::white);
+  QPainter painter(&image);
+  view.renderChart(&painter, QRectF(image.rect()));
+  painter.end();
+
+  QVERIFY2(countSeriesPixels(image) > 200, "series missing from export");
+  foreach (QAbstractSeries *series, view.chart()->series()) {
+    QCOMPARE(series->useOpenGL(), useOpenGL);
+  }
+}
+
+int main(int argc, char *argv[]) {
+  if (!qEnvironmentVariableIsSet("QT_QPA_PLATFORM"))
+    qputenv("QT_QPA_PLATFORM", "offscreen");
+  if (!qEnvironmentVariableIsSet("LIBGL_ALWAYS_SOFTWARE"))
+    qputenv("LIBGL_ALWAYS_SOFTWARE", "1");
+  QApplication app(argc, argv);
+  TestChartExport test;
+  return QTest::qExec(&test, argc, argv);
+}
+
+#include "tst_chartexport.moc"
@@ -0,0 +1,158 @@
+/*-------------------------------GPL-------------------------------------//
+//
+// MetOcean Viewer - A simple interface for viewing hydrodynamic model data
+// Copyright (C) 2018  Zach Cobell
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------*/
+#include <QtTest>
+#include <clocale>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include "hmdfasciiparser.h"
+
+class TestHmdfAsciiParser : public QObject {
+  Q_OBJECT
+
+ private slots:
+  void initTestCase();
+  void parseDoubleMatchesStrtod_data();
+  void parseDoubleMatchesStrtod();
+  void parseDoubleRandom();
+  void parseRecord();
+};
+
+//...Reference value: strtod in the C locale, with the Fortran 'd' exponent
+//   spelled as 'e'
+static double referenceValue(const std::string &token) {
+  std::string s(token);
+  for (char &c : s) {
+    if (c == 'd' || c == 'D') c = 'e';
+  }
+  return std::strtod(s.c_str(), nullptr);
+}
+
+static bool sameDouble(double a, double b) {
+  return std::memcmp(&a, &b, sizeof(double)) == 0;
+}
+
+void TestHmdfAsciiParser::initTestCase() { std::setlocale(LC_ALL, "C"); }
+
+void TestHmdfAsciiParser::parseDoubleMatchesStrtod_data() {
+  QTest::addColumn<QString>("token");
+
+  const char *tokens[] = {"0",
+                          "-0.0",
+                          "1",
+                          "+1.5",
+                          "-99999.0",
+                          "0.1",
+                          "3.14159",
+                          "1.0e5",
+                          "1.0E-5",
+                          "1.0d5",
+                          "1.0D-5",
+                          "1.0D-30",
+                          "1.0d30",
+                          "-2.5D+40",
+                          "6.02214076E23",
+                          "1e22",
+                          "1e23",
+                          "1e-22",
+                          "1e-23",
+                          "9007199254740993",
+                          "9007199254740993.5",
+                          "123456789012345678901234567890",
+                          "0.000000000000000000000000001234",
+                          "1.7976931348623157e308",
+                          "2.2250738585072014D-308",
+                          ".5",
+                          "5.",
+                          "12.34567890123456789"};
+  for (const char *t : tokens) QTest::newRow(t) << QString(t);
+}
+
+void TestHmdfAsciiParser::parseDoubleMatchesStrtod() {
+  QFETCH(QString, token);
+  std::string s = token.toStdString();
+
+  const char *pos = s.data();
+  double value = 0.0;
+  QVERIFY(HmdfAsciiParser::parseDouble(pos, s.data() + s.size(), value));
+  QCOMPARE(pos, s.data() + s.size());
+  QVERIFY2(sameDouble(value, referenceValue(s)),
+           qPrintable(QString("%1 parsed as %2, strtod gives %3")
+                          .arg(token)
+                          .arg(value, 0, 'g', 17)
+                          .arg(referenceValue(s), 0, 'g', 17)));
+}
+
+//...Random tokens across the fast path and the fallback: long mantissas,
+//   exponents on both sides of +-22 and all four exponent letters
+void TestHmdfAsciiParser::parseDoubleRandom() {
+  std::mt19937_64 rng(20181101);
+  std::uniform_int_distribution<int> nDigits(1, 25);
+  std::uniform_int_distribution<int> digit(0, 9);
+  std::uniform_int_distribution<int> exponent(-60, 60);
+  std::uniform_int_distribution<int> choice(0, 5);
+  const char letters[] = {'e', 'E', 'd', 'D'};
+
+  for (int i = 0; i < 100000; i++) {
+    std::string s;
+    if (choice(rng) == 0) s += '-';
+    int n = nDigits(rng);
+    int point = std::uniform_int_distribution<int>(0, n)(rng);
+    for (int j = 0; j < n; j++) {
+      if (j == point) s += '.';
+      s += static_cast<char>('0' + digit(rng));
+    }
+    int c = choice(rng);
+    if (c < 4) {
+      s += letters[c];
+      s += std::to_string(exponent(rng));
+    }
+
+    const char *pos = s.data();
+    double value = 0.0;
+    QVERIFY2(HmdfAsciiParser::parseDouble(pos, s.data() + s.size(), value),
+             s.c_str());
+    QVERIFY2(sameDouble(value, referenceValue(s)), s.c_str());
+  }
+}
+
+void TestHmdfAsciiParser::parseRecord() {
+  std::string withSeconds = "2018 11 01 12 30 15 -1.25D-01";
+  std::string noSeconds = "  2018  11  01  12  30   4.5e2\r";
+
+  long long date;
+  double value;
+  QVERIFY(HmdfAsciiParser::splitStringHmdfFormat(
+      withSeconds.data(), withSeconds.data() + withSeconds.size(), date,
+      value));
+  QCOMPARE(date, 1541075415000LL);
+  QCOMPARE(value, -0.125);
+
+  QVERIFY(HmdfAsciiParser::splitStringHmdfFormat(
+      noSeconds.data(), noSeconds.data() + noSeconds.size(), date, value));
+  QCOMPARE(date, 1541075400000LL);
+  QCOMPARE(value, 450.0);
+}
+
+QTEST_APPLESS_MAIN(TestHmdfAsciiParser)
+
+#include "tst_hmdfasciiparser.moc"
@@ -0,0 +1,185 @@
+/*-------------------------------GPL-------------------------------------//
+//
+// MetOcean Viewer - A simple interface for viewing hydrodynamic model data
+// Copyright (C) 2018  Zach Cobell
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------*/
+#include <QtTest>
+#include "hmdf.h"
+#include "hmdfreader.h"
+
+class TestHmdfImeds : public QObject {
+  Q_OBJECT
+
+ private slots:
+  void sequentialMatchesParallel_data();
+  void sequentialMatchesParallel();
+  void fastMatchesSpirit_data();
+  void fastMatchesSpirit();
+  void streamMatchesBulk_data();
+  void streamMatchesBulk();
+};
+
+static int readFixture(const QString &filename, Hmdf::HmdfReadMode mode,
+                       Hmdf::HmdfImedsParser parser, int threads,
+                       Hmdf *data) {
+  data->setReadMode(mode);
+  data->setImedsParser(parser);
+  data->setReadThreads(threads);
+  return data->readImeds(filename);
+}
+
+void TestHmdfImeds::sequentialMatchesParallel_data() {
+  QTest::addColumn<int>("parser");
+  QTest::addColumn<int>("threads");
+
+  QTest::newRow("fast, 1 thread") << int(Hmdf::HmdfParserFast) << 1;
+  QTest::newRow("fast, 4 threads") << int(Hmdf::HmdfParserFast) << 4;
+}
+
+//...The fixture has blank and whitespace only lines between stations, a
+//   station without a seconds column and a file that ends in a blank line
+void TestHmdfImeds::sequentialMatchesParallel() {
+  QFETCH(int, parser);
+  QFETCH(int, threads);
+
+  QString filename = QFINDTESTDATA("data/blanklines.imeds");
+  QVERIFY(!filename.isEmpty());
+
+  Hmdf sequential, parallel;
+  QCOMPARE(readFixture(filename, Hmdf::HmdfReadSequential,
+                       Hmdf::HmdfImedsParser(parser), threads, &sequential),
+           0);
+  QCOMPARE(readFixture(filename, Hmdf::HmdfReadParallel,
+                       Hmdf::HmdfImedsParser(parser), threads, &parallel),
+           0);
+
+  QCOMPARE(sequential.nstations(), size_t(4));
+  QCOMPARE(parallel.nstations(), sequential.nstations());
+  QCOMPARE(parallel.header1(), sequential.header1());
+  QCOMPARE(parallel.header2(), sequential.header2());
+  QCOMPARE(parallel.header3(), sequential.header3());
+
+  const size_t expectedSnaps[] = {3, 2, 3, 1};
+  for (int i = 0; i < static_cast<int>(sequential.nstations()); i++) {
+    HmdfStation *s = sequential.station(i);
+    HmdfStation *p = parallel.station(i);
+    QCOMPARE(s->numSnaps(), expectedSnaps[i]);
+    QCOMPARE(p->name(), s->name());
+    QCOMPARE(p->latitude(), s->latitude());
+    QCOMPARE(p->longitude(), s->longitude());
+    QCOMPARE(p->allDate(), s->allDate());
+    QCOMPARE(p->allData(), s->allData());
+  }
+
+  QCOMPARE(sequential.station(0)->name(), QString("8761724"));
+  QCOMPARE(sequential.station(0)->latitude(), 29.2633);
+  QCOMPARE(sequential.station(0)->longitude(), -89.9567);
+  QCOMPARE(sequential.station(0)->data(2), -0.15);
+  QCOMPARE(sequential.station(2)->data(0), 1.0e-30);
+  QCOMPARE(sequential.station(3)->name(), QString("8766072"));
+}
+
+void TestHmdfImeds::fastMatchesSpirit_data() {
+  QTest::addColumn<int>("mode");
+  QTest::addColumn<int>("threads");
+
+  QTest::newRow("sequential") << int(Hmdf::HmdfReadSequential) << 1;
+  QTest::newRow("parallel, 4 threads") << int(Hmdf::HmdfReadParallel) << 4;
+}
+
+//...Checks the fast tokenizer against the original Spirit parser. The Spirit
+//   grammar stops at a Fortran 'D' exponent, so this fixture only uses 'e'
+//   and 'E' exponents
+void TestHmdfImeds::fastMatchesSpirit() {
+  QFETCH(int, mode);
+  QFETCH(int, threads);
+
+  QString filename = QFINDTESTDATA("data/records.imeds");
+  QVERIFY(!filename.isEmpty());
+
+  Hmdf spirit, fast;
+  QCOMPARE(readFixture(filename, Hmdf::HmdfReadSequential,
+                       Hmdf::HmdfParserSpirit, 1, &spirit),
+           0);
+  QCOMPARE(readFixture(filename, Hmdf::HmdfReadMode(mode),
+                       Hmdf::HmdfParserFast, threads, &fast),
+           0);
+
+  QCOMPARE(spirit.nstations(), size_t(3));
+  QCOMPARE(fast.nstations(), spirit.nstations());
+  for (int i = 0; i < static_cast<int>(spirit.nstations()); i++) {
+    HmdfStation *s = spirit.station(i);
+    HmdfStation *f = fast.station(i);
+    QCOMPARE(s->numSnaps(), size_t(24));
+    QCOMPARE(f->name(), s->name());
+    QCOMPARE(f->latitude(), s->latitude());
+    QCOMPARE(f->longitude(), s->longitude());
+    QCOMPARE(f->allDate(), s->allDate());
+    QCOMPARE(f->allData(), s->allData());
+  }
+}
+
+void TestHmdfImeds::streamMatchesBulk_data() {
+  QTest::addColumn<QString>("fixture");
+  QTest::addColumn<int>("nstations");
+
+  QTest::newRow("blank lines between stations") << "data/blanklines.imeds"
+                                                << 4;
+  QTest::newRow("blank line inside a station") << "data/splitstation.imeds"
+                                               << 3;
+}
+
+//...The streaming reader must split the file into the same stations as
+//   Hmdf::readImeds. In the second fixture the blank line ends the first
+//   station and the record after it is read as a station header
+void TestHmdfImeds::streamMatchesBulk() {
+  QFETCH(QString, fixture);
+  QFETCH(int, nstations);
+
+  QString filename = QFINDTESTDATA(fixture);
+  QVERIFY(!filename.isEmpty());
+
+  Hmdf bulk;
+  QCOMPARE(readFixture(filename, Hmdf::HmdfReadSequential,
+                       Hmdf::HmdfParserFast, 1, &bulk),
+           0);
+  QCOMPARE(bulk.nstations(), size_t(nstations));
+
+  HmdfReader reader;
+  reader.setFilename(filename);
+  reader.setImedsParser(Hmdf::HmdfParserFast);
+  QCOMPARE(reader.open(), 0);
+  QCOMPARE(reader.header1(), bulk.header1());
+
+  int n = 0;
+  for (HmdfStation *s = reader.next(); s != nullptr; s = reader.next(), n++) {
+    QScopedPointer<HmdfStation> station(s);
+    QVERIFY(n < nstations);
+    HmdfStation *b = bulk.station(n);
+    QCOMPARE(station->name(), b->name());
+    QCOMPARE(station->latitude(), b->latitude());
+    QCOMPARE(station->longitude(), b->longitude());
+    QCOMPARE(station->allDate(), b->allDate());
+    QCOMPARE(station->allData(), b->allData());
+  }
+  QVERIFY(!reader.error());
+  QCOMPARE(n, nstations);
+}
+
+QTEST_GUILESS_MAIN(TestHmdfImeds)
+
+#include "tst_hmdfimeds.moc"
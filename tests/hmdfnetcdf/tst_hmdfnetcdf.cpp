@@ -0,0 +1,198 @@
+/*-------------------------------GPL-------------------------------------//
+//
+// MetOcean Viewer - A simple interface for viewing hydrodynamic model data
+// Copyright (C) 2018  Zach Cobell
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------*/
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QTemporaryDir>
+#include <QtTest>
+#include <cmath>
+#include "hmdf.h"
+#include "netcdf.h"
+
+//...Benchmarks the netCDF write profiles. Each row writes the same
+//   synthetic hourly record and reports the file size along with the time
+//   to read every station and to read a single station
+class TestHmdfNetcdf : public QObject {
+  Q_OBJECT
+
+ private slots:
+  void initTestCase();
+  void profiles_data();
+  void profiles();
+  void convertOptions();
+  void emptyLayout();
+
+ private:
+  QTemporaryDir m_dir;
+};
+
+static const int c_numStations = 100;
+static const int c_numSnaps = 8760;
+
+//...Two tidal constituents plus a little deterministic noise so that the
+//   values do not compress unrealistically well
+static void fillData(Hmdf *data) {
+  data->setUnits("m");
+  data->setDatum("MSL");
+  quint32 seed = 1;
+  for (int s = 0; s < c_numStations; s++) {
+    HmdfStation *station = new HmdfStation(data->store());
+    station->setName(QString("station_%1").arg(s + 1));
+    station->setId(station->name());
+    station->setLatitude(29.0 + 0.01 * s);
+    station->setLongitude(-90.0 + 0.01 * s);
+    for (int t = 0; t < c_numSnaps; t++) {
+      seed = seed * 1664525u + 1013904223u;
+      double noise = (static_cast<double>(seed >> 8) / 16777216.0 - 0.5) * 0.02;
+      double value = 0.8 * std::sin(2.0 * M_PI * t / 12.42 + s) +
+                     0.3 * std::sin(2.0 * M_PI * t / 12.0) + noise;
+      station->setNext(1514764800000LL + 3600000LL * t, value);
+    }
+    data->addStation(station);
+  }
+}
+
+void TestHmdfNetcdf::initTestCase() { QVERIFY(this->m_dir.isValid()); }
+
+void TestHmdfNetcdf::profiles_data() {
+  QTest::addColumn<int>("format");
+  QTest::addColumn<int>("profile");
+  QTest::addColumn<int>("chunking");
+  QTest::addColumn<double>("precision");
+
+  const int f0 = Hmdf::HmdfNetcdf20180123;
+  const int f1 = Hmdf::HmdfNetcdf20181101;
+  const int none = Hmdf::HmdfProfileNone;
+  const int fast = Hmdf::HmdfProfileFast;
+  const int archival = Hmdf::HmdfProfileArchival;
+  const int station = Hmdf::HmdfChunkStation;
+  const int time = Hmdf::HmdfChunkTime;
+
+  QTest::newRow("20181101 none station") << f1 << none << station << 0.0;
+  QTest::newRow("20181101 fast station") << f1 << fast << station << 0.0;
+  QTest::newRow("20181101 fast time") << f1 << fast << time << 0.0;
+  QTest::newRow("20181101 archival station")
+      << f1 << archival << station << 0.0;
+  QTest::newRow("20181101 fast station 1mm")
+      << f1 << fast << station << 0.001;
+  QTest::newRow("20181101 archival station 1mm")
+      << f1 << archival << station << 0.001;
+  QTest::newRow("20180123 fast") << f0 << fast << station << 0.0;
+  QTest::newRow("20180123 archival 1mm") << f0 << archival << station << 0.001;
+}
+
+void TestHmdfNetcdf::profiles() {
+  QFETCH(int, format);
+  QFETCH(int, profile);
+  QFETCH(int, chunking);
+  QFETCH(double, precision);
+
+  Hmdf data;
+  fillData(&data);
+  data.setNetcdfFormat(Hmdf::HmdfNetcdfFormat(format));
+  data.setNetcdfProfile(Hmdf::HmdfNetcdfProfile(profile));
+  data.setNetcdfChunking(Hmdf::HmdfNetcdfChunking(chunking));
+  data.setNetcdfPrecision(precision);
+
+  QString filename =
+      this->m_dir.filePath(QString(QTest::currentDataTag()) + ".nc");
+
+  QBENCHMARK_ONCE { QCOMPARE(data.writeNetcdf(filename), 0); }
+
+  QElapsedTimer timer;
+  Hmdf all;
+  timer.start();
+  QCOMPARE(all.readNetcdf(filename), 0);
+  qint64 readAll = timer.elapsed();
+
+  Hmdf one;
+  timer.restart();
+  QCOMPARE(one.readNetcdf(filename, QStringList() << "station_50"), 0);
+  qint64 readOne = timer.elapsed();
+
+  qInfo("%-32s %8.2f MB  read all %5lld ms  read one %5lld ms",
+        QTest::currentDataTag(),
+        QFileInfo(filename).size() / (1024.0 * 1024.0), readAll, readOne);
+
+  QCOMPARE(all.nstations(), data.nstations());
+  QCOMPARE(one.nstations(), size_t(1));
+  double tolerance = precision > 0.0 ? precision / 2.0 : 0.0;
+  for (int s = 0; s < c_numStations; s += 7) {
+    QCOMPARE(all.station(s)->numSnaps(), data.station(s)->numSnaps());
+    QCOMPARE(all.station(s)->date(c_numSnaps - 1),
+             data.station(s)->date(c_numSnaps - 1));
+    for (int t = 0; t < c_numSnaps; t += 97) {
+      double error =
+          std::abs(all.station(s)->data(t) - data.station(s)->data(t));
+      QVERIFY(error <= tolerance);
+    }
+  }
+}
+
+//...The conversion path has to honour the same write settings
+void TestHmdfNetcdf::convertOptions() {
+  Hmdf data;
+  fillData(&data);
+  QString imeds = this->m_dir.filePath("convert.imeds");
+  QString netcdf = this->m_dir.filePath("convert.nc");
+  QCOMPARE(data.write(imeds), 0);
+
+  Hmdf::HmdfConvertOptions options;
+  options.netcdfProfile = Hmdf::HmdfProfileArchival;
+  options.netcdfPrecision = 0.001;
+  QCOMPARE(Hmdf::convert(imeds, netcdf, options), 0);
+
+  int ncid, varid, shuffle, deflate, level;
+  double precision = 0.0;
+  QCOMPARE(nc_open(netcdf.toStdString().c_str(), NC_NOWRITE, &ncid),
+           NC_NOERR);
+  QCOMPARE(nc_inq_varid(ncid, "data_station_0001", &varid), NC_NOERR);
+  QCOMPARE(nc_inq_var_deflate(ncid, varid, &shuffle, &deflate, &level),
+           NC_NOERR);
+  QCOMPARE(nc_get_att_double(ncid, varid, "quantization_precision",
+                             &precision),
+           NC_NOERR);
+  nc_close(ncid);
+
+  QCOMPARE(deflate, 1);
+  QCOMPARE(level, 9);
+  QCOMPARE(precision, 0.001);
+}
+
+//...The 20181101 layout refuses to write without stations or times rather
+//   than defining a zero length, and therefore unlimited, dimension
+void TestHmdfNetcdf::emptyLayout() {
+  QString path = this->m_dir.filePath("empty.nc");
+
+  Hmdf noStations;
+  noStations.setNetcdfFormat(Hmdf::HmdfNetcdf20181101);
+  QVERIFY(noStations.write(path) != 0);
+
+  Hmdf noTimes;
+  noTimes.setNetcdfFormat(Hmdf::HmdfNetcdf20181101);
+  HmdfStation *station = new HmdfStation(noTimes.store());
+  station->setName("station");
+  noTimes.addStation(station);
+  QVERIFY(noTimes.write(path) != 0);
+  QVERIFY(!QFileInfo::exists(path));
+}
+
+QTEST_GUILESS_MAIN(TestHmdfNetcdf)
+
+#include "tst_hmdfnetcdf.moc"
@@ -0,0 +1,98 @@
+/*-------------------------------GPL-------------------------------------//
+//
+// MetOcean Viewer - A simple interface for viewing hydrodynamic model data
+// Copyright (C) 2018  Zach Cobell
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------*/
+#include <QTemporaryDir>
+#include <QtTest>
+#include "hmdf.h"
+
+class TestHmdfWriter : public QObject {
+  Q_OBJECT
+
+ private slots:
+  void initTestCase();
+  void cleanupTestCase();
+  void writesUtc_data();
+  void writesUtc();
+
+ private:
+  QByteArray m_tz;
+};
+
+//...2018-07-01 12:00:00 UTC
+static const qint64 c_date = 1530446400000LL;
+
+//...Runs the tests in a zone away from UTC so that any local time
+//   conversion shows up in the output
+void TestHmdfWriter::initTestCase() {
+  this->m_tz = qgetenv("TZ");
+  qputenv("TZ", "America/Chicago");
+  QVERIFY(QDateTime::fromMSecsSinceEpoch(c_date).offsetFromUtc() != 0);
+}
+
+void TestHmdfWriter::cleanupTestCase() {
+  if (this->m_tz.isEmpty()) {
+    qunsetenv("TZ");
+  } else {
+    qputenv("TZ", this->m_tz);
+  }
+}
+
+void TestHmdfWriter::writesUtc_data() {
+  QTest::addColumn<QString>("filename");
+  QTest::addColumn<QString>("record");
+
+  QTest::newRow("imeds") << "out.imeds"
+                         << "2018    07    01    12    00    00    1.5000e+00";
+  QTest::newRow("csv") << "out.csv" << "07/01/2018,12:00,1.5000e+00";
+}
+
+void TestHmdfWriter::writesUtc() {
+  QFETCH(QString, filename);
+  QFETCH(QString, record);
+
+  QTemporaryDir dir;
+  QVERIFY(dir.isValid());
+  QString path = dir.filePath(filename);
+
+  Hmdf data;
+  HmdfStation *station = new HmdfStation(data.store());
+  station->setName("station");
+  station->setLatitude(29.0);
+  station->setLongitude(-90.0);
+  station->setNext(c_date, 1.5);
+  data.addStation(station);
+  QCOMPARE(data.write(path), 0);
+
+  QFile file(path);
+  QVERIFY(file.open(QIODevice::ReadOnly));
+  QStringList lines = QString(file.readAll()).split("\n");
+  QVERIFY(lines.contains(record));
+
+  //...IMEDS output reads back to the same time
+  if (filename.endsWith(".imeds")) {
+    Hmdf readBack;
+    QCOMPARE(readBack.readImeds(path), 0);
+    QCOMPARE(readBack.nstations(), size_t(1));
+    QCOMPARE(readBack.station(0)->date(0), c_date);
+  }
+}
+
+QTEST_GUILESS_MAIN(TestHmdfWriter)
+
+#include "tst_hmdfwriter.moc"
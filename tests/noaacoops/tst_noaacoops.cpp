@@ -0,0 +1,237 @@
+/*-------------------------------GPL-------------------------------------//
+//
+// MetOcean Viewer - A simple interface for viewing hydrodynamic model data
+// Copyright (C) 2018  Zach Cobell
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------*/
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QUrlQuery>
+#include <QtTest>
+#include <functional>
+#include "hmdf.h"
+#include "noaacoops.h"
+
+//...Minimal HTTP server that stands in for the NOAA CO-OPS API. Each
+//   request is passed to the handler along with its number (starting at
+//   one). An empty response leaves the connection open without replying
+class StubServer : public QTcpServer {
+ public:
+  typedef std::function<QByteArray(const QUrl &url, int count)> Handler;
+
+  explicit StubServer(Handler handler) : m_handler(handler), m_count(0) {
+    connect(this, &QTcpServer::newConnection, this,
+            &StubServer::acceptConnections);
+    this->listen(QHostAddress::LocalHost);
+  }
+
+  QString url() const {
+    return QStringLiteral("http://127.0.0.1:%1/api/datagetter")
+        .arg(this->serverPort());
+  }
+
+  int count() const { return this->m_count; }
+
+ private:
+  void acceptConnections() {
+    while (this->hasPendingConnections()) {
+      QTcpSocket *socket = this->nextPendingConnection();
+      connect(socket, &QTcpSocket::disconnected, socket,
+              &QTcpSocket::deleteLater);
+      connect(socket, &QTcpSocket::readyRead, this,
+              [this, socket]() { this->readRequest(socket); });
+    }
+  }
+
+  void readRequest(QTcpSocket *socket) {
+    QByteArray buffer =
+        socket->property("buffer").toByteArray() + socket->readAll();
+    int end = buffer.indexOf("\r\n\r\n");
+    if (end < 0) {
+      socket->setProperty("buffer", buffer);
+      return;
+    }
+    socket->setProperty("buffer", buffer.mid(end + 4));
+
+    QList<QByteArray> requestLine =
+        buffer.left(buffer.indexOf("\r\n")).split(' ');
+    QUrl url = QUrl::fromEncoded(requestLine.value(1));
+    QByteArray response = this->m_handler(url, ++this->m_count);
+    if (response.isEmpty()) return;
+    socket->write(response);
+    socket->disconnectFromHost();
+  }
+
+  Handler m_handler;
+  int m_count;
+};
+
+static QByteArray httpResponse(const QByteArray &status,
+                               const QByteArray &body,
+                               const QByteArray &headers = QByteArray()) {
+  return "HTTP/1.1 " + status + "\r\nContent-Type: application/json\r\n" +
+         headers + "Content-Length: " + QByteArray::number(body.size()) +
+         "\r\nConnection: close\r\n\r\n" + body;
+}
+
+//...Hourly water levels covering the dates asked for, boundaries included
+static QByteArray waterLevels(const QUrl &url) {
+  QUrlQuery query(url);
+  QDateTime begin = QDateTime::fromString(
+      query.queryItemValue("begin_date", QUrl::FullyDecoded),
+      "yyyyMMdd hh:mm");
+  QDateTime end = QDateTime::fromString(
+      query.queryItemValue("end_date", QUrl::FullyDecoded), "yyyyMMdd hh:mm");
+  begin.setTimeSpec(Qt::UTC);
+  end.setTimeSpec(Qt::UTC);
+
+  QStringList values;
+  for (QDateTime t = begin; t <= end; t = t.addSecs(3600)) {
+    values.push_back(QStringLiteral("{\"t\":\"%1\",\"v\":\"1.000\"}")
+                         .arg(t.toString("yyyy-MM-dd hh:mm")));
+  }
+  return httpResponse("200 OK",
+                      "{\"data\":[" + values.join(",").toUtf8() + "]}");
+}
+
+class TestNoaaCoOps : public QObject {
+  Q_OBJECT
+
+ private slots:
+  void retriesTransientErrors();
+  void followsRedirects();
+  void abortsStalledRequests();
+  void removesChunkOverlap();
+  void stopsAfterRetries();
+  void stopsBackoffAfterFailure();
+
+ private:
+  int download(StubServer &server, const QDateTime &start,
+               const QDateTime &end, Hmdf &data, int timeout = 60000);
+};
+
+static const QDateTime c_start(QDate(2018, 7, 1), QTime(0, 0), Qt::UTC);
+
+int TestNoaaCoOps::download(StubServer &server, const QDateTime &start,
+                            const QDateTime &end, Hmdf &data, int timeout) {
+  Station station(QGeoCoordinate(29.0, -90.0), "8761724", "Grand Isle");
+  NoaaCoOps coops(station, start, end, "water_level", "MSL", "metric");
+  coops.setBaseUrl(server.url());
+  coops.setRequestTimeout(timeout);
+  return coops.get(&data);
+}
+
+void TestNoaaCoOps::retriesTransientErrors() {
+  StubServer server([](const QUrl &url, int count) {
+    if (count == 1) return httpResponse("503 Service Unavailable", "{}");
+    return waterLevels(url);
+  });
+  QVERIFY(server.isListening());
+
+  Hmdf data;
+  QCOMPARE(this->download(server, c_start, c_start.addDays(1), data), 0);
+  QCOMPARE(server.count(), 2);
+  QCOMPARE(data.station(0)->numSnaps(), size_t(25));
+}
+
+void TestNoaaCoOps::followsRedirects() {
+  StubServer server([](const QUrl &url, int count) {
+    if (count == 1) {
+      QByteArray location =
+          "/moved?" + url.query(QUrl::FullyEncoded).toUtf8();
+      return httpResponse("302 Found", QByteArray(),
+                          "Location: " + location + "\r\n");
+    }
+    if (url.path() != "/moved") return httpResponse("404 Not Found", "{}");
+    return waterLevels(url);
+  });
+  QVERIFY(server.isListening());
+
+  Hmdf data;
+  QCOMPARE(this->download(server, c_start, c_start.addDays(1), data), 0);
+  QCOMPARE(server.count(), 2);
+  QCOMPARE(data.station(0)->numSnaps(), size_t(25));
+}
+
+void TestNoaaCoOps::abortsStalledRequests() {
+  StubServer server([](const QUrl &url, int count) {
+    if (count == 1) return QByteArray();
+    return waterLevels(url);
+  });
+  QVERIFY(server.isListening());
+
+  Hmdf data;
+  QCOMPARE(this->download(server, c_start, c_start.addDays(1), data, 200), 0);
+  QCOMPARE(server.count(), 2);
+  QCOMPARE(data.station(0)->numSnaps(), size_t(25));
+}
+
+//...Neighbouring 30 day chunks both contain the time they meet at. The
+//   output should hold each hour once, in order
+void TestNoaaCoOps::removesChunkOverlap() {
+  StubServer server([](const QUrl &url, int) { return waterLevels(url); });
+  QVERIFY(server.isListening());
+
+  Hmdf data;
+  QDateTime end = c_start.addDays(65);
+  QCOMPARE(this->download(server, c_start, end, data), 0);
+  QCOMPARE(server.count(), 3);
+
+  HmdfStation *station = data.station(0);
+  QCOMPARE(station->numSnaps(), size_t(65 * 24 + 1));
+  QCOMPARE(station->date(0), c_start.toMSecsSinceEpoch());
+  for (int i = 1; i < static_cast<int>(station->numSnaps()); ++i) {
+    QCOMPARE(station->date(i) - station->date(i - 1), qint64(3600000));
+  }
+}
+
+void TestNoaaCoOps::stopsAfterRetries() {
+  StubServer server([](const QUrl &, int) {
+    return httpResponse("503 Service Unavailable", "{}");
+  });
+  QVERIFY(server.isListening());
+
+  Station station(QGeoCoordinate(29.0, -90.0), "8761724", "Grand Isle");
+  NoaaCoOps coops(station, c_start, c_start.addDays(1), "water_level", "MSL",
+                  "metric");
+  coops.setBaseUrl(server.url());
+  coops.setMaxRetries(1);
+
+  Hmdf data;
+  QVERIFY(coops.get(&data) != 0);
+  QCOMPARE(server.count(), 2);
+}
+
+//...The first chunk fails for good while the second waits to retry. The
+//   second chunk should not be requested again
+void TestNoaaCoOps::stopsBackoffAfterFailure() {
+  StubServer server([](const QUrl &url, int) {
+    QString begin =
+        QUrlQuery(url).queryItemValue("begin_date", QUrl::FullyDecoded);
+    if (begin.startsWith("20180701"))
+      return httpResponse("404 Not Found", "{}");
+    return httpResponse("503 Service Unavailable", "{}");
+  });
+  QVERIFY(server.isListening());
+
+  Hmdf data;
+  QVERIFY(this->download(server, c_start, c_start.addDays(35), data) != 0);
+  QCOMPARE(server.count(), 2);
+}
+
+QTEST_GUILESS_MAIN(TestNoaaCoOps)
+
+#include "tst_noaacoops.moc"
@@ -0,0 +1,110 @@
+/*-------------------------------GPL-------------------------------------//
+//
+// MetOcean Viewer - A simple interface for viewing hydrodynamic model data
+// Copyright (C) 2018  Zach Cobell
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------*/
+#include <QtTest>
+#include <algorithm>
+#include <random>
+#include "constants.h"
+#include "stationindex.h"
+
+class TestStationIndex : public QObject {
+  Q_OBJECT
+
+ private slots:
+  void initTestCase();
+  void radiusMatchesScan_data();
+  void radiusMatchesScan();
+  void radiusRandom();
+
+ private:
+  QVector<int> scan(double longitude, double latitude, double distance) const;
+
+  QVector<Station> m_stations;
+  StationIndex m_index;
+};
+
+//...Stations scattered over the whole globe, including both poles and
+//   either side of the antimeridian
+void TestStationIndex::initTestCase() {
+  std::mt19937 generator(26);
+  std::uniform_real_distribution<double> lon(-180.0, 180.0);
+  std::uniform_real_distribution<double> lat(-90.0, 90.0);
+  for (int i = 0; i < 20000; ++i) {
+    double x = lon(generator);
+    double y = lat(generator);
+    this->m_stations.push_back(
+        Station(QGeoCoordinate(y, x), QString::number(i), QString()));
+  }
+  this->m_index.build(this->m_stations);
+  QCOMPARE(this->m_index.size(), this->m_stations.size());
+}
+
+//...Reference answer: every station checked with the geodesic distance
+QVector<int> TestStationIndex::scan(double longitude, double latitude,
+                                    double distance) const {
+  QVector<int> result;
+  for (int i = 0; i < this->m_stations.size(); ++i) {
+    QGeoCoordinate c = this->m_stations[i].coordinate();
+    if (Constants::distance(longitude, latitude, c.longitude(), c.latitude(),
+                            true) <= distance)
+      result.push_back(i);
+  }
+  return result;
+}
+
+void TestStationIndex::radiusMatchesScan_data() {
+  QTest::addColumn<double>("longitude");
+  QTest::addColumn<double>("latitude");
+  QTest::addColumn<double>("distance");
+
+  QTest::newRow("gulf") << -90.0 << 29.0 << 500000.0;
+  QTest::newRow("antimeridian") << 179.9 << -15.0 << 800000.0;
+  QTest::newRow("antimeridian 0-360") << 180.1 << -15.0 << 800000.0;
+  QTest::newRow("north pole") << 0.0 << 89.5 << 1000000.0;
+  QTest::newRow("south pole") << 45.0 << -90.0 << 1500000.0;
+  QTest::newRow("zero") << -90.0 << 29.0 << 0.0;
+  QTest::newRow("half globe") << 10.0 << 10.0 << 10000000.0;
+}
+
+void TestStationIndex::radiusMatchesScan() {
+  QFETCH(double, longitude);
+  QFETCH(double, latitude);
+  QFETCH(double, distance);
+
+  double x = longitude > 180.0 ? longitude - 360.0 : longitude;
+  QCOMPARE(this->m_index.radius(longitude, latitude, distance),
+           this->scan(x, latitude, distance));
+}
+
+void TestStationIndex::radiusRandom() {
+  std::mt19937 generator(27);
+  std::uniform_real_distribution<double> lon(-180.0, 180.0);
+  std::uniform_real_distribution<double> lat(-90.0, 90.0);
+  std::uniform_real_distribution<double> distance(0.0, 2000000.0);
+  for (int i = 0; i < 200; ++i) {
+    double x = lon(generator);
+    double y = lat(generator);
+    double d = distance(generator);
+    QCOMPARE(this->m_index.radius(x, y, d), this->scan(x, y, d));
+  }
+}
+
+QTEST_GUILESS_MAIN(TestStationIndex)
+
+#include "tst_stationindex.moc"
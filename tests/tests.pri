@@ -0,0 +1,53 @@
+#-------------------------------GPL-------------------------------------#
+#
+# MetOcean Viewer - A simple interface for viewing hydrodynamic model data
+# Copyright (C) 2015-2017  Zach Cobell
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+#-----------------------------------------------------------------------#
+
+#...Common settings for the unit tests. Each test is a Qt Test executable
+#   linked against libmetocean; run them all with "make check"
+QT += testlib network positioning
+QT -= gui
+
+include($$PWD/../global.pri)
+
+CONFIG += c++11 console testcase
+CONFIG -= app_bundle
+
+DEFINES += QT_DEPRECATED_WARNINGS
+
+INCLUDEPATH += $$PWD/../libraries/libmetocean
+DEPENDPATH += $$PWD/../libraries/libmetocean
+INCLUDEPATH += $$PWD/../thirdparty/boost_1_67_0
+
+win32:CONFIG(release, debug|release): LIBS += -L$$OUT_PWD/../../libraries/libmetocean/release/ -lmetocean
+else:win32:CONFIG(debug, debug|release): LIBS += -L$$OUT_PWD/../../libraries/libmetocean/debug/ -lmetocean
+else:unix: LIBS += -L$$OUT_PWD/../../libraries/libmetocean/ -lmetocean
+
+win32-g++:CONFIG(release, debug|release): PRE_TARGETDEPS += $$OUT_PWD/../../libraries/libmetocean/release/libmetocean.a
+else:win32-g++:CONFIG(debug, debug|release): PRE_TARGETDEPS += $$OUT_PWD/../../libraries/libmetocean/debug/libmetocean.a
+else:win32:!win32-g++:CONFIG(release, debug|release): PRE_TARGETDEPS += $$OUT_PWD/../../libraries/libmetocean/release/metocean.lib
+else:win32:!win32-g++:CONFIG(debug, debug|release): PRE_TARGETDEPS += $$OUT_PWD/../../libraries/libmetocean/debug/metocean.lib
+else:unix: PRE_TARGETDEPS += $$OUT_PWD/../../libraries/libmetocean/libmetocean.a
+
+win32:CONFIG(release, debug|release): LIBS += -L$$OUT_PWD/../../libraries/libnetcdfcxx/release/ -lnetcdfcxx -lnetcdf
+else:win32:CONFIG(debug, debug|release): LIBS += -L$$OUT_PWD/../../libraries/libnetcdfcxx/debug/ -lnetcdfcxx -lnetcdf
+else:unix: LIBS += -L$$OUT_PWD/../../libraries/libnetcdfcxx/ -lnetcdfcxx -lnetcdf
+
+win32:CONFIG(release, debug|release): LIBS += -L$$OUT_PWD/../../libraries/libtide/release/ -ltide
+else:win32:CONFIG(debug, debug|release): LIBS += -L$$OUT_PWD/../../libraries/libtide/debug/ -ltide
+else:unix: LIBS += -L$$OUT_PWD/../../libraries/libtide/ -ltide